@@ -0,0 +1,222 @@
+# Replay a packet trace against candidate DRAM address mappings, and
+# compare their row hit rate and bank conflicts.
+#
+# Every candidate has its own traffic generator replaying the trace,
+# and its own crossbar and memory channels, placed in its own window
+# of the address space, so that all of them are simulated side by
+# side, e.g.
+#
+#   build/X86/gem5.opt configs/dram/addr_map_sweep.py \
+#       --trace=mem.trc.gz --mem-type=DDR4_2400_8x8 --mem-channels=2
+#
+# A trace of pathological strides is easily made from a text file with
+# util/encode_packet_trace.py. The candidates are given in a JSON file
+# as a list of objects with a name, and any of addr_mapping,
+# addr_permutation, bank_xor_masks and rank_xor_masks, which are set
+# on the DRAM interfaces, and channel_masks, which select the channel
+# of an address. Without it, the address maps are compared with and
+# without the bank bits hashed with the low row bits.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import json
+import math
+import optparse
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import ObjectList
+
+parser = optparse.OptionParser()
+
+parser.add_option("--mem-type", type="choice", default="DDR4_2400_8x8",
+                  choices=ObjectList.mem_list.get_names(),
+                  help = "type of memory to use")
+parser.add_option("--mem-channels", type="int", default=1,
+                  help = "number of memory channels")
+parser.add_option("--mem-channels-intlv", type="int", default=256,
+                  help = "channel interleaving granularity in bytes")
+parser.add_option("--mem-size", type="string", default="1GB",
+                  help = "size of the memory, which must cover the trace")
+parser.add_option("--trace", type="string", default="",
+                  help = "packet trace to replay")
+parser.add_option("--candidates", type="string", default="",
+                  help = "JSON file with the address mappings to compare")
+parser.add_option("--elastic", action="store_true",
+                  help = "delay the trace when the memory pushes back")
+parser.add_option("--max-outstanding", type="int", default=64,
+                  help = "maximum number of outstanding requests")
+
+(options, args) = parser.parse_args()
+
+if args:
+    fatal("This script doesn't take any positional arguments")
+
+if not options.trace:
+    fatal("A trace is needed, see --trace")
+
+intf = ObjectList.mem_list.get(options.mem_type)
+if not issubclass(intf, m5.objects.DRAMInterface):
+    fatal("This script assumes the memory is a DRAMInterface subclass")
+
+intlv_bits = int(math.log(options.mem_channels, 2))
+if 2 ** intlv_bits != options.mem_channels:
+    fatal("Number of memory channels must be a power of 2")
+
+# the windows of the candidates are aligned on their size, so that the
+# channel masks only see the address within the window
+mem_size = AddrRange(options.mem_size).size()
+if mem_size & (mem_size - 1):
+    fatal("The memory size must be a power of 2")
+
+# get the geometry of a channel to place the default hashes
+probe = intf()
+rowbuffer_size = probe.devices_per_rank.value * \
+    probe.device_rowbuffer_size.value
+col_bits = int(math.log(rowbuffer_size, 2))
+bank_bits = int(math.log(probe.banks_per_rank.value, 2))
+rank_bits = int(math.log(probe.ranks_per_channel.value, 2))
+
+def channel_masks(addr_mapping):
+    # as in MemConfig, the channel bits come after the row with
+    # RoRaBaChCo, and after a stripe otherwise
+    if addr_mapping == 'RoRaBaChCo':
+        low_bit = col_bits
+    else:
+        low_bit = int(math.log(options.mem_channels_intlv, 2))
+    return [1 << (low_bit + i) for i in range(intlv_bits)]
+
+def default_candidates():
+    candidates = []
+    for addr_mapping in ObjectList.dram_addr_map_list.get_names():
+        candidates.append({ "name" : addr_mapping,
+                            "addr_mapping" : addr_mapping })
+
+    # with the RoRa maps, the row bits of the address within a channel
+    # start above the column, bank and rank bits, and XORing the lowest
+    # of them into the bank bits spreads the strides that are a
+    # multiple of the row size over the banks
+    row_low_bit = col_bits + bank_bits + rank_bits
+    bank_xor_masks = [1 << (row_low_bit + i) for i in range(bank_bits)]
+    for addr_mapping in ['RoRaBaChCo', 'RoRaBaCoCh']:
+        candidates.append({ "name" : addr_mapping + "_xor",
+                            "addr_mapping" : addr_mapping,
+                            "bank_xor_masks" : bank_xor_masks })
+    return candidates
+
+if options.candidates:
+    with open(options.candidates) as candidates_file:
+        candidates = json.load(candidates_file)
+else:
+    candidates = default_candidates()
+
+intf_params = ["addr_mapping", "addr_permutation", "bank_xor_masks",
+               "rank_xor_masks"]
+
+system = System(mem_mode = 'timing')
+system.clk_domain = SrcClockDomain(clock = '2.0GHz',
+                                   voltage_domain =
+                                   VoltageDomain(voltage = '1V'))
+
+# do not worry about reserving space for the backing store
+system.mmap_using_noreserve = True
+
+system.mem_ranges = []
+subsystems = []
+for c, candidate in enumerate(candidates):
+    if "name" not in candidate:
+        fatal("Candidate %d has no name" % c)
+    for key in candidate:
+        if key not in intf_params + ["name", "channel_masks"]:
+            fatal("Unknown key %s in candidate %s" % (key, candidate["name"]))
+
+    mem_range = AddrRange(c * mem_size, size = mem_size)
+    system.mem_ranges.append(mem_range)
+
+    addr_mapping = candidate.get("addr_mapping", probe.addr_mapping.value)
+    masks = candidate.get("channel_masks", channel_masks(addr_mapping))
+    if len(masks) != intlv_bits:
+        fatal("Candidate %s needs %d channel masks" %
+              (candidate["name"], intlv_bits))
+    if any(mask >= mem_size for mask in masks):
+        fatal("The channel masks of candidate %s select bits above the "
+              "memory size" % candidate["name"])
+
+    subsystem = SubSystem()
+    subsystem.xbar = IOXBar(width = 32)
+
+    mem_ctrls = []
+    for i in range(options.mem_channels):
+        dram = intf()
+        if masks:
+            dram.range = AddrRange(mem_range.start, size = mem_size,
+                                   masks = masks, intlvMatch = i)
+        else:
+            dram.range = mem_range
+        for key in intf_params:
+            if key in candidate:
+                setattr(dram, key, candidate[key])
+
+        # there is no point slowing things down by saving any data
+        dram.null = True
+
+        mem_ctrl = MemCtrl(dram = dram)
+        mem_ctrl.port = subsystem.xbar.mem_side_ports
+        mem_ctrls.append(mem_ctrl)
+    subsystem.mem_ctrls = mem_ctrls
+
+    subsystem.tgen = PyTrafficGen(elastic_req = options.elastic,
+                                  max_outstanding_reqs =
+                                  options.max_outstanding)
+    subsystem.tgen.port = subsystem.xbar.cpu_side_ports
+
+    subsystems.append(subsystem)
+system.candidates = subsystems
+
+# connect the system port even if it is not used
+system.system_port = system.candidates[0].xbar.cpu_side_ports
+
+root = Root(full_system = False, system = system)
+
+m5.instantiate()
+
+for c, subsystem in enumerate(system.candidates):
+    subsystem.tgen.start([subsystem.tgen.createTrace(m5.MaxTick,
+                                                     options.trace,
+                                                     c * mem_size),
+                          subsystem.tgen.createExit(0)])
+
+# every traffic generator exits the simulation once it has replayed
+# the trace, remember when
+done_at = {}
+while len(done_at) < len(candidates):
+    event = m5.simulate()
+    cause = event.getCause()
+    for c, subsystem in enumerate(system.candidates):
+        if cause.startswith(subsystem.tgen.path() + " "):
+            done_at[c] = m5.curTick()
+            break
+    else:
+        fatal("Exiting @ tick %i because %s" % (m5.curTick(), cause))
+
+def stat(mem_ctrls, name):
+    return sum(ctrl.dram.getCCObject().resolveStat(name).value()
+               for ctrl in mem_ctrls)
+
+print("%-24s %12s %10s %10s %10s" % ("mapping", "ticks", "bursts",
+                                     "row hits", "conflicts"))
+for c, subsystem in enumerate(system.candidates):
+    mem_ctrls = subsystem.mem_ctrls
+    bursts = stat(mem_ctrls, "readBursts") + stat(mem_ctrls, "writeBursts")
+    row_hits = stat(mem_ctrls, "readRowHits") + \
+        stat(mem_ctrls, "writeRowHits")
+    conflicts = stat(mem_ctrls, "bankConflicts")
+    print("%-24s %12d %10d %9.1f%% %9.1f%%" %
+          (candidates[c]["name"], done_at[c], bursts,
+           100.0 * row_hits / max(bursts, 1),
+           100.0 * conflicts / max(bursts, 1)))
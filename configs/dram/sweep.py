@@ -81,6 +81,10 @@ parser.add_option("--addr-map", type="choice",
                   choices=ObjectList.dram_addr_map_list.get_names(),
                   default="RoRaBaCoCh", help = "DRAM address map policy")
 
+parser.add_option("--check-sched-index", action="store_true",
+                  help = "Check every decision of the indexed FR-FCFS \
+                          scheduler against a scan of the queue")
+
 (options, args) = parser.parse_args()
 
 if args:
@@ -126,6 +130,9 @@ system.mem_ctrls[0].dram.null = True
 # Set the address mapping based on input argument
 system.mem_ctrls[0].dram.addr_mapping = options.addr_map
 
+if options.check_sched_index:
+    system.mem_ctrls[0].check_sched_index = True
+
 # stay in each state for 0.25 ms, long enough to warm things up, and
 # short enough to avoid hitting a refresh
 period = 250000000
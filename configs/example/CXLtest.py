@@ -87,6 +87,7 @@ from m5.objects import *
 from m5.util import *
 addToPath('../')
 from common import MemConfig
+from common import ObjectList
 #from common import HMC
 def add_options(parser):
     # ************CXL CONTROLLER PARAMETERS*************
@@ -207,6 +208,56 @@ def add_options(parser):
                         type=int, help="Number of packets to buffer at the\
                         response side of the crossbar")
 
+    # Record every flit of the CXL controller, the trace can be replayed
+    # with cxl_replay.py
+    parser.add_option("--cxl-flit-trace", default="", type=str,
+                        help="Record the flits of the CXL controller to\
+                        this file")
+
+    # *******************RUBY CXL DIRECTORY**************************
+    # Put the memory of an extra Ruby directory controller behind a CXL
+    # link, see config_cxl_ruby_subsystem
+    parser.add_option("--ruby-cxl-dir", action="store_true",
+                        help="Attach a CXL memory node to Ruby through a\
+                        separate directory controller")
+
+    parser.add_option("--cxl-mem-start", default='0x200000000', type=str,
+                        help="Start address of the CXL memory node")
+
+    parser.add_option("--cxl-mem-size", default='512MB', type=str,
+                        help="Size of the CXL memory node")
+
+    # directory lookup of the far node, the default local one is 6 cycles
+    parser.add_option("--cxl-dir-latency", default=12, action="store",
+                        type=int, help="Directory latency (cycles) of the\
+                        CXL directory controller")
+
+    # the far node needs more transactions in flight to hide the link
+    # latency, the default of a local directory is 256
+    parser.add_option("--cxl-dir-tbes", default=1024, action="store",
+                        type=int, help="Number of TBEs of the CXL directory\
+                        controller")
+
+    # *******************CXL LINK POWER STATES**********************
+    # Let idle CXL links drop to L0p and then L1, see
+    # config_cxl_link_power
+    parser.add_option("--cxl-link-pm", action="store_true",
+                        help="Enable the L0p/L1 link power states of the\
+                        CXL serial links")
+
+    parser.add_option("--cxl-l0p-lanes", default=0, action="store",
+                        type=int, help="Number of lanes active in L0p,\
+                        0 means half of the lanes")
+
+    parser.add_option("--cxl-l0p-timeout", default='200ns', type=str,
+                        help="Idle time before a CXL link enters L0p")
+
+    parser.add_option("--cxl-l1-timeout", default='5us', type=str,
+                        help="Idle time before a CXL link enters L1")
+
+    parser.add_option("--cxl-l1-exit-latency", default='2us', type=str,
+                        help="Time to retrain a CXL link leaving L1")
+
 
 def config_cxl_subsystem(options, system):
     """
@@ -284,6 +335,9 @@ def config_cxl_subsystem(options, system):
                                         delay=options.total_ctrl_latency)
 
     subsystem.cxl_controller.monitor = CommMonitor()
+    if options.cxl_flit_trace:
+        subsystem.cxl_controller.flit_trace = CXLFlitTraceProbe(
+            trace_file = options.cxl_flit_trace)
 
     xbar.mem_side_ports = subsystem.cxl_controller.cpu_side_ports
     sl = subsystem.cxl_controller.seriallink
@@ -316,6 +370,113 @@ def config_cxl_subsystem(options, system):
     mc2.dram.range = AddrRange(start = '0x200000000', size = '512MB')
     subsystem.cxl_device2.mem_side_ports = mc2.port
 
+def config_cxl_ruby_subsystem(options, ruby_system, dir_cntrl):
+    """
+    Put the memory of a Ruby directory controller behind a CXL link.
+
+    The directory memory port is connected to a CXL controller, which
+    packs the requests into flits and sends them over a serial link to
+    a CXL device in front of a memory controller. The directory sees a
+    far memory, so it gets a longer lookup and more TBEs than the local
+    ones.
+    """
+    cxl_range = AddrRange(start = options.cxl_mem_start,
+                          size = options.cxl_mem_size)
+
+    ruby_system.cxl_controller = CXLController(
+        width = 16,
+        frontend_latency = 2,
+        forward_latency = 3,
+        response_latency = 3,
+    )
+    ruby_system.cxl_device = CXLDevice(
+        width = 16,
+        frontend_latency = 2,
+        forward_latency = 2,
+        response_latency = 4,
+    )
+    ruby_system.cxl_controller.seriallink = SerialLink(ranges=cxl_range,
+                                        req_size=options.link_buffer_size_req,
+                                        resp_size=options.link_buffer_size_rsp,
+                                        num_lanes=options.num_lanes_per_link,
+                                        link_speed=options.serial_link_speed,
+                                        delay=options.total_ctrl_latency)
+
+    dir_cntrl.addr_ranges = [cxl_range]
+    dir_cntrl.number_of_TBEs = options.cxl_dir_tbes
+    # the name of the directory lookup latency depends on the protocol
+    if hasattr(dir_cntrl, 'directory_latency'):
+        dir_cntrl.directory_latency = options.cxl_dir_latency
+
+    ctrl = ruby_system.cxl_controller
+    sl = ctrl.seriallink
+    if options.cxl_flit_trace:
+        ctrl.flit_trace = CXLFlitTraceProbe(
+            trace_file = options.cxl_flit_trace)
+    dir_cntrl.memory_out_port = ctrl.cpu_side_ports
+    if options.enable_link_monitor:
+        ctrl.monitor = CommMonitor()
+        ctrl.mem_side_ports = ctrl.monitor.cpu_side_port
+        ctrl.monitor.mem_side_port = sl.cpu_side_port
+    else:
+        ctrl.mem_side_ports = sl.cpu_side_port
+    sl.mem_side_port = ruby_system.cxl_device.cpu_side_ports
+
+    mem_type = ObjectList.mem_list.get(options.mem_type)
+    ruby_system.cxl_mem_ctrl = MemCtrl()
+    mc = ruby_system.cxl_mem_ctrl
+    mc.dram = mem_type()
+    mc.dram.range = cxl_range
+    mc.port = ruby_system.cxl_device.mem_side_ports
+
+class CXLLinkPowerOn(MathExprPowerModel):
+    def __init__(self, link_path, static_mw, **kwargs):
+        super(CXLLinkPowerOn, self).__init__(**kwargs)
+        # the link accounts for the energy of every bit it carries
+        self.dyn = "{}.dynPower".format(link_path)
+        self.st = "{} / 1000".format(static_mw)
+
+class CXLLinkPowerOff(MathExprPowerModel):
+    dyn = "0"
+    st = "0"
+
+class CXLLinkPowerModel(PowerModel):
+    def __init__(self, link, **kwargs):
+        super(CXLLinkPowerModel, self).__init__(**kwargs)
+        # L0, L0p and L1 show up as ON, CLK_GATED and SRAM_RETENTION
+        self.pm = [
+            CXLLinkPowerOn(link.path(), link.l0_static_power), # ON
+            CXLLinkPowerOn(link.path(), link.l0p_static_power), # CLK_GATED
+            CXLLinkPowerOn(link.path(), link.l1_static_power), # SRAM_RET.
+            CXLLinkPowerOff(), # OFF
+        ]
+
+def config_cxl_link_power(options, root):
+    """
+    Enable the link power states on every serial link of the CXL
+    subsystem and give each of them a power model, so that the link
+    power shows up in the power stats. This has to be called once the
+    root has been created as the power models refer to the link stats by
+    name.
+    """
+    if not options.cxl_link_pm:
+        return
+
+    links = [ obj for obj in root.descendants()
+              if isinstance(obj, SerialLink) ]
+    # power models have to belong to a subsystem
+    root.cxl_link_power = SubSystem()
+
+    for link in links:
+
+        link.link_pm = True
+        link.l0p_lanes = options.cxl_l0p_lanes
+        link.l0p_idle_timeout = options.cxl_l0p_timeout
+        link.l1_idle_timeout = options.cxl_l1_timeout
+        link.l1_exit_latency = options.cxl_l1_exit_latency
+        link.power_model = CXLLinkPowerModel(link,
+            subsystem = root.cxl_link_power)
+
 class L1Cache(Cache):
     """Simple L1 Cache with default values"""
 
@@ -453,4 +614,4 @@ class L2Cache(Cache):
 #
 #print("Beginning simulation!")
 #exit_event = m5.simulate()
-#print('Exiting @ tick %i because %s' % (m5.curTick(), exit_event.getCause()))
\ No newline at end of file
+#print('Exiting @ tick %i because %s' % (m5.curTick(), exit_event.getCause()))
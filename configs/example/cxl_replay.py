@@ -0,0 +1,73 @@
+# Replay the host requests of a CXL flit trace without simulating CPUs.
+#
+# Record a trace with --cxl-flit-trace in a full-system run, then
+# replay it against another CXL configuration, e.g.
+#
+#   build/X86/gem5.opt configs/example/cxl_replay.py \
+#       --trace=m5out/flits.trc.gz --serial-link-speed=16
+#
+# Only the M2S flits are replayed, the responses come from the
+# simulated device.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import optparse
+import os
+import tempfile
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from example import CXLtest
+
+parser = optparse.OptionParser()
+CXLtest.add_options(parser)
+
+parser.add_option("--trace", type=str, default="",
+                  help="CXL flit trace to replay")
+parser.add_option("--addr-offset", type=int, default=0,
+                  help="Offset added to every replayed address")
+parser.add_option("--elastic", action="store_true",
+                  help="Delay the trace when the link pushes back")
+parser.add_option("--max-outstanding", type=int, default=64,
+                  help="Maximum number of outstanding requests")
+
+(options, args) = parser.parse_args()
+
+if not options.trace:
+    fatal("A trace is needed, see --trace")
+
+# The state machine of the traffic generator has a single state that
+# replays the whole trace
+cfg_file_name = os.path.join(tempfile.mkdtemp(), "cxl_replay.cfg")
+with open(cfg_file_name, 'w') as cfg_file:
+    cfg_file.write("STATE 0 %d CXL_TRACE %s %d\n" %
+                   (m5.MaxTick, os.path.abspath(options.trace),
+                    options.addr_offset))
+    cfg_file.write("INIT 0\n")
+    cfg_file.write("TRANSITION 0 0 1\n")
+
+system = System(mem_mode = 'timing')
+system.clk_domain = SrcClockDomain(clock = '2GHz',
+                                   voltage_domain = VoltageDomain())
+
+system.membus = SystemXBar()
+system.tgen = TrafficGen(config_file = cfg_file_name,
+                         elastic_req = options.elastic,
+                         max_outstanding_reqs = options.max_outstanding)
+system.tgen.port = system.membus.cpu_side_ports
+system.system_port = system.membus.cpu_side_ports
+
+CXLtest.config_cxl_subsystem(options, system)
+
+root = Root(full_system = False, system = system)
+CXLtest.config_cxl_link_power(options, root)
+m5.instantiate()
+
+print("Beginning replay of %s" % options.trace)
+event = m5.simulate()
+print('Exiting @ tick %i because %s' % (m5.curTick(), event.getCause()))
@@ -0,0 +1,139 @@
+# Run a traffic generator against CXL memory with a DRAM cache in front
+# of it, and check that the cache hits, misses and writes back lines, e.g.
+#
+#   build/NULL/gem5.opt configs/example/dram_cache.py --block-size=2kB
+#
+# The memory controller of the cache side is only used for its timing,
+# it is a null memory outside of the address map whose size sets the size
+# of the cache. The CXL memory sits behind a CXL controller, a serial link
+# and a CXL device, as in CXLtest.py.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import optparse
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import ObjectList
+from example import CXLtest
+
+parser = optparse.OptionParser()
+CXLtest.add_options(parser)
+
+parser.add_option("--mem-type", type="choice", default="DDR4_2400_8x8",
+                  choices=ObjectList.mem_list.get_names(),
+                  help = "type of the CXL memory")
+parser.add_option("--cache-mem-type", type="choice",
+                  default="DDR4_2400_8x8",
+                  choices=ObjectList.mem_list.get_names(),
+                  help = "type of the memory of the DRAM cache")
+parser.add_option("--cache-size", type="string", default="1MB",
+                  help = "size of the DRAM cache")
+parser.add_option("--block-size", type="string", default="64B",
+                  help = "size of the blocks of the DRAM cache")
+parser.add_option("--miss-predictor-entries", type="int", default=256,
+                  help = "number of counters of the miss predictor")
+parser.add_option("--range", type="string", default="4MB",
+                  help = "size of the range of the CXL memory accessed")
+parser.add_option("--rd-perc", type="int", default=50,
+                  help = "percentage of reads")
+parser.add_option("--period", type="int", default=10000,
+                  help = "ticks between requests")
+parser.add_option("--duration", type="int", default=200000000,
+                  help = "ticks of traffic")
+
+(options, args) = parser.parse_args()
+
+if args:
+    fatal("This script doesn't take any positional arguments")
+
+system = System(mem_mode = 'timing')
+system.clk_domain = SrcClockDomain(clock = '2GHz',
+                                   voltage_domain = VoltageDomain())
+
+cxl_range = AddrRange(start = options.cxl_mem_start,
+                      size = options.cxl_mem_size)
+system.mem_ranges = [cxl_range]
+
+# do not worry about reserving space for the backing store
+system.mmap_using_noreserve = True
+
+system.membus = SystemXBar()
+
+system.dram_cache = DRAMCache(
+    block_size = options.block_size,
+    miss_predictor_entries = options.miss_predictor_entries)
+system.dram_cache.cpu_side_port = system.membus.mem_side_ports
+
+# the cache array, only used for its timing
+cache_dram = ObjectList.mem_list.get(options.cache_mem_type)()
+cache_dram.range = AddrRange(0, size = options.cache_size)
+cache_dram.null = True
+cache_dram.in_addr_map = False
+system.cache_mem_ctrl = MemCtrl(dram = cache_dram)
+system.cache_mem_ctrl.port = system.dram_cache.cache_side_port
+
+# the CXL memory
+system.cxl_controller = CXLController(
+    width = 16,
+    frontend_latency = 2,
+    forward_latency = 3,
+    response_latency = 3,
+)
+system.cxl_device = CXLDevice(
+    width = 16,
+    frontend_latency = 2,
+    forward_latency = 2,
+    response_latency = 4,
+)
+system.cxl_controller.seriallink = SerialLink(ranges = cxl_range,
+                                    req_size = options.link_buffer_size_req,
+                                    resp_size = options.link_buffer_size_rsp,
+                                    num_lanes = options.num_lanes_per_link,
+                                    link_speed = options.serial_link_speed,
+                                    delay = options.total_ctrl_latency)
+sl = system.cxl_controller.seriallink
+system.dram_cache.mem_side_port = system.cxl_controller.cpu_side_ports
+system.cxl_controller.mem_side_ports = sl.cpu_side_port
+sl.mem_side_port = system.cxl_device.cpu_side_ports
+
+cxl_dram = ObjectList.mem_list.get(options.mem_type)()
+cxl_dram.range = cxl_range
+# there is no point slowing things down by saving any data
+cxl_dram.null = True
+system.cxl_mem_ctrl = MemCtrl(dram = cxl_dram)
+system.cxl_mem_ctrl.port = system.cxl_device.mem_side_ports
+
+system.tgen = PyTrafficGen()
+system.tgen.port = system.membus.cpu_side_ports
+system.system_port = system.membus.cpu_side_ports
+
+root = Root(full_system = False, system = system)
+m5.instantiate()
+
+start = cxl_range.start.value
+system.tgen.start([system.tgen.createRandom(options.duration, start,
+                       start + AddrRange(options.range).size() - 1, 64,
+                       options.period, options.period, options.rd_perc, 0),
+                   system.tgen.createExit(0)])
+
+event = m5.simulate()
+cause = event.getCause()
+if not cause.startswith(system.tgen.path() + " "):
+    fatal("Exiting @ tick %i because %s" % (m5.curTick(), cause))
+
+def stat(name):
+    return system.dram_cache.getCCObject().resolveStat(name).value()
+
+hits = stat("readHits") + stat("writeHits")
+misses = stat("readMisses") + stat("writeMisses")
+writebacks = stat("writebacks")
+print("DRAM cache hits: %d, misses: %d, writebacks: %d" %
+      (hits, misses, writebacks))
+if hits == 0 or misses == 0 or writebacks == 0:
+    fatal("The DRAM cache did not hit, miss and write back")
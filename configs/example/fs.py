@@ -372,6 +372,8 @@ else:
     print("Error I don't know how to create more than 2 systems.")
     sys.exit(1)
 
+CXLtest.config_cxl_link_power(options, root)
+
 if options.timesync:
     root.time_sync_enable = True
 
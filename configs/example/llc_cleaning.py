@@ -0,0 +1,130 @@
+# Run a traffic generator through a last-level cache that cleans its
+# dirty blocks while it is idle, and check that it does, e.g.
+#
+#   build/NULL/gem5.opt configs/example/llc_cleaning.py --eager-writeback
+#
+# The eager writeback cleans the dirty blocks at the LRU end of their set
+# whose DRAM row is open. A linear stream through a small cache keeps
+# them in the rows it has just left in the other banks, which stay open
+# until the stream wraps around the banks. The dead block predictor
+# rather bypasses the fills, and cleans the dirty blocks hit, that it
+# predicts dead, which random accesses to a range a few times the size
+# of the cache train it to, e.g.
+#
+#   build/NULL/gem5.opt configs/example/llc_cleaning.py \
+#       --dead-block-predictor --mode=RANDOM --range=256kB
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import optparse
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import ObjectList
+
+parser = optparse.OptionParser()
+
+parser.add_option("--mem-type", type="choice", default="DDR4_2400_8x8",
+                  choices=ObjectList.mem_list.get_names(),
+                  help = "type of memory to use")
+parser.add_option("--llc-size", type="string", default="16kB",
+                  help = "size of the last-level cache")
+parser.add_option("--llc-assoc", type="int", default=4,
+                  help = "associativity of the last-level cache")
+parser.add_option("--mode", type="choice", default="LINEAR",
+                  choices=["LINEAR", "RANDOM"],
+                  help = "LINEAR: stream through the range; \
+                          RANDOM: random accesses to the range")
+parser.add_option("--range", type="string", default="4MB",
+                  help = "size of the range accessed")
+parser.add_option("--rd-perc", type="int", default=50,
+                  help = "percentage of reads")
+parser.add_option("--period", type="int", default=20000,
+                  help = "ticks between requests")
+parser.add_option("--duration", type="int", default=100000000,
+                  help = "ticks of traffic")
+parser.add_option("--eager-writeback", action="store_true",
+                  help = "clean the dirty blocks whose DRAM row is open")
+parser.add_option("--dead-block-predictor", action="store_true",
+                  help = "bypass the fills, and clean the dirty blocks, \
+                          predicted dead")
+
+(options, args) = parser.parse_args()
+
+if args:
+    fatal("This script doesn't take any positional arguments")
+
+system = System(membus = SystemXBar())
+system.clk_domain = SrcClockDomain(clock = '2.0GHz',
+                                   voltage_domain =
+                                   VoltageDomain(voltage = '1V'))
+
+mem_range = AddrRange('256MB')
+system.mem_ranges = [mem_range]
+
+# do not worry about reserving space for the backing store
+system.mmap_using_noreserve = True
+
+dram = ObjectList.mem_list.get(options.mem_type)()
+dram.range = mem_range
+# there is no point slowing things down by saving any data
+dram.null = True
+system.mem_ctrl = MemCtrl(dram = dram)
+system.mem_ctrl.port = system.membus.mem_side_ports
+
+system.llc = Cache(size = options.llc_size, assoc = options.llc_assoc,
+                   tag_latency = 10, data_latency = 10,
+                   response_latency = 10, mshrs = 16, tgts_per_mshr = 8)
+if options.eager_writeback:
+    system.llc.eager_writeback = EagerWriteback(
+        mem_ctrls = [system.mem_ctrl])
+if options.dead_block_predictor:
+    system.llc.dead_block_predictor = DeadBlockPredictor()
+system.llc.mem_side = system.membus.cpu_side_ports
+
+system.tgen = PyTrafficGen()
+system.tgen.port = system.llc.cpu_side
+
+# connect the system port even if it is not used in this example
+system.system_port = system.membus.cpu_side_ports
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+if options.mode == "LINEAR":
+    generator = system.tgen.createLinear
+else:
+    generator = system.tgen.createRandom
+system.tgen.start([generator(options.duration, 0,
+                             AddrRange(options.range).size(), 64,
+                             options.period, options.period,
+                             options.rd_perc, 0),
+                   system.tgen.createExit(0)])
+
+event = m5.simulate()
+cause = event.getCause()
+if not cause.startswith(system.tgen.path() + " "):
+    fatal("Exiting @ tick %i because %s" % (m5.curTick(), cause))
+
+def stat(obj, name):
+    return obj.getCCObject().resolveStat(name).value()
+
+if options.eager_writeback:
+    cleanings = stat(system.llc.eager_writeback, "cleanings")
+    print("Eager writeback cleanings: %d" % cleanings)
+    if cleanings == 0:
+        fatal("The eager writeback cleaned no block")
+
+if options.dead_block_predictor:
+    bypasses = stat(system.llc.dead_block_predictor, "bypasses")
+    cleanings = stat(system.llc.dead_block_predictor, "deadCleanings")
+    print("Dead block bypasses: %d, cleanings: %d" % (bypasses, cleanings))
+    if bypasses == 0 or cleanings == 0:
+        fatal("The dead block predictor bypassed or cleaned no block")
@@ -121,6 +121,10 @@ def setup_memory_controllers(system, ruby, dir_cntrls, options):
     # for each address range as the abstract memory can handle only one
     # contiguous address range as of now.
     for dir_cntrl in dir_cntrls:
+        # the CXL directory already has its memory behind the CXL link
+        if getattr(dir_cntrl, '_cxl', False):
+            continue
+
         crossbar = None
         if len(system.mem_ranges) > 1:
             crossbar = IOXBar()
@@ -253,11 +257,25 @@ def create_directories(options, bootmem, ruby_system, system):
         exec("ruby_system.dir_cntrl%d = dir_cntrl" % i)
         dir_cntrl_nodes.append(dir_cntrl)
 
+    # A far memory node behind a CXL link gets its own directory, which is
+    # handled as a memory directory but does not get a local controller
+    if getattr(options, 'ruby_cxl_dir', False):
+        from example import CXLtest
+        cxl_dir_cntrl = Directory_Controller()
+        cxl_dir_cntrl.version = options.num_dirs + \
+                                (1 if bootmem is not None else 0)
+        cxl_dir_cntrl.directory = RubyDirectoryMemory()
+        cxl_dir_cntrl.ruby_system = ruby_system
+        cxl_dir_cntrl._cxl = True
+        ruby_system.cxl_dir_cntrl = cxl_dir_cntrl
+        CXLtest.config_cxl_ruby_subsystem(options, ruby_system, cxl_dir_cntrl)
+        dir_cntrl_nodes.append(cxl_dir_cntrl)
+
     if bootmem is not None:
         rom_dir_cntrl = Directory_Controller()
         rom_dir_cntrl.directory = RubyDirectoryMemory()
         rom_dir_cntrl.ruby_system = ruby_system
-        rom_dir_cntrl.version = i + 1
+        rom_dir_cntrl.version = options.num_dirs
         rom_dir_cntrl.memory = bootmem.port
         rom_dir_cntrl.addr_ranges = bootmem.range
         return (dir_cntrl_nodes, rom_dir_cntrl)
@@ -65,7 +65,7 @@ Stage2MMU::readDataUntimed(ThreadContext *tc, Addr oVAddr, Addr descAddr,
     Fault fault;
 
     // translate to physical address using the second stage MMU
-    auto req = std::make_shared<Request>();
+    auto req = makeRequest();
     req->setVirt(descAddr, numBytes, flags | Request::PT_WALK,
                 requestorId, 0);
     if (isFunctional) {
@@ -112,7 +112,7 @@ Stage2MMU::Stage2Translation::Stage2Translation(Stage2MMU &_parent,
     : data(_data), numBytes(0), event(_event), parent(_parent), oVAddr(_oVAddr),
     fault(NoFault)
 {
-    req = std::make_shared<Request>();
+    req = makeRequest();
 }
 
 void
@@ -0,0 +1,153 @@
+/**
+ * @file
+ * Declaration of a direct decode table for interleaved address ranges.
+ */
+
+#ifndef __BASE_ADDR_DECODE_TABLE_HH__
+#define __BASE_ADDR_DECODE_TABLE_HH__
+
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/bitfield.hh"
+#include "base/types.hh"
+
+/**
+ * The AddrDecodeTable decodes interleaved address ranges without
+ * searching. Ranges that share their start, end and interleaving masks
+ * form a group, and within a group the interleaving bits of an address
+ * directly index a table holding the value of the matching range. When
+ * the masks are single, consecutive bits the index is a plain bit
+ * field of the address, otherwise it is computed from the parity of
+ * the masked address, like AddrRange::contains() does.
+ *
+ * The table is meant to sit in front of an AddrRangeMap. It only holds
+ * interleaved ranges, and a lookup that does not find a range in any
+ * of the groups has to be resolved by the map.
+ */
+template <typename V>
+class AddrDecodeTable
+{
+  public:
+
+    /** Largest number of stripes of a group that gets a table */
+    static const unsigned maxStripes = 256;
+
+    /**
+     * Add a range to the table.
+     *
+     * @param r the range, which is expected not to overlap with the
+     *          ranges already in the table
+     * @param v the value to return for addresses in the range
+     * @return false if the range cannot be decoded by the table
+     */
+    bool
+    insert(const AddrRange &r, const V &v)
+    {
+        if (!r.interleaved() || r.stripes() > maxStripes)
+            return false;
+
+        Group *group = nullptr;
+        for (auto &g : groups) {
+            if (g.start == r.start() && g.end == r.end() &&
+                g.masks == r.intlvMasks()) {
+                group = &g;
+                break;
+            }
+        }
+
+        if (!group) {
+            groups.emplace_back(r);
+            group = &groups.back();
+        }
+
+        Entry &e = group->entries[r.intlvMatchValue()];
+        e.range = r;
+        e.value = v;
+        e.valid = true;
+        return true;
+    }
+
+    /**
+     * Find the value of the range that contains the given range.
+     *
+     * @param r a non-interleaved range, e.g. the range of a packet
+     * @return the value, or nullptr if none of the ranges in the
+     *         table contains r
+     */
+    const V *
+    contains(const AddrRange &r) const
+    {
+        const Addr a = r.start();
+        for (const auto &g : groups) {
+            if (a < g.start || a >= g.end)
+                continue;
+
+            const Entry &e = g.entries[g.select(a)];
+            // the range still has to fit within a single stripe
+            if (e.valid && r.isSubset(e.range))
+                return &e.value;
+        }
+        return nullptr;
+    }
+
+    /** Remove all the ranges */
+    void clear() { groups.clear(); }
+
+    /** Number of interleaved groups in the table */
+    size_t numGroups() const { return groups.size(); }
+
+  private:
+
+    struct Entry
+    {
+        Entry() : value(), valid(false) {}
+
+        AddrRange range;
+        V value;
+        bool valid;
+    };
+
+    struct Group
+    {
+        explicit Group(const AddrRange &r)
+            : start(r.start()), end(r.end()), masks(r.intlvMasks()),
+              lowBit(ctz64(masks[0])), bitField(true), entries(r.stripes())
+        {
+            for (int i = 0; i < masks.size(); i++) {
+                if (masks[i] != ULL(1) << (lowBit + i))
+                    bitField = false;
+            }
+        }
+
+        /** Interleaving bits of an address, i.e. its stripe */
+        unsigned
+        select(Addr a) const
+        {
+            if (bitField)
+                return bits(a, lowBit + masks.size() - 1, lowBit);
+
+            unsigned sel = 0;
+            for (int i = 0; i < masks.size(); i++)
+                sel |= (popCount(a & masks[i]) % 2) << i;
+            return sel;
+        }
+
+        Addr start;
+        Addr end;
+        std::vector<Addr> masks;
+
+        /** Lowest interleaving bit when the masks form a bit field */
+        unsigned lowBit;
+
+        /** Whether the masks are single, consecutive bits */
+        bool bitField;
+
+        /** The ranges of the group indexed by their stripe */
+        std::vector<Entry> entries;
+    };
+
+    std::vector<Group> groups;
+};
+
+#endif //__BASE_ADDR_DECODE_TABLE_HH__
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "base/addr_decode_table.hh"
+#include "base/addr_range_map.hh"
+
+namespace {
+
+/** Ranges for n channels interleaved at a 64 byte granularity */
+std::vector<AddrRange>
+channelRanges(Addr start, Addr end, unsigned intlv_bits)
+{
+    std::vector<AddrRange> ranges;
+    for (unsigned i = 0; i < (1 << intlv_bits); i++)
+        ranges.emplace_back(start, end, 6 + intlv_bits - 1, 0,
+                            intlv_bits, i);
+    return ranges;
+}
+
+} // anonymous namespace
+
+TEST(AddrDecodeTableTest, NonInterleavedRangesAreRejected)
+{
+    AddrDecodeTable<int> t;
+
+    EXPECT_FALSE(t.insert(RangeIn(0x1000, 0x1fff), 1));
+    EXPECT_EQ(0, t.numGroups());
+    EXPECT_EQ(nullptr, t.contains(RangeSize(0x1000, 64)));
+}
+
+TEST(AddrDecodeTableTest, BitFieldInterleaving)
+{
+    AddrDecodeTable<int> t;
+
+    auto ranges = channelRanges(0, 0x100000, 5);
+    for (int i = 0; i < ranges.size(); i++)
+        ASSERT_TRUE(t.insert(ranges[i], i));
+    EXPECT_EQ(1, t.numGroups());
+
+    for (Addr a = 0; a < 0x10000; a += 64) {
+        const int *v = t.contains(RangeSize(a, 64));
+        ASSERT_NE(nullptr, v);
+        EXPECT_EQ((a >> 6) & 0x1f, *v);
+    }
+
+    // outside of the group, and straddling two stripes
+    EXPECT_EQ(nullptr, t.contains(RangeSize(0x100000, 64)));
+    EXPECT_EQ(nullptr, t.contains(RangeSize(0x20, 64)));
+}
+
+TEST(AddrDecodeTableTest, HashedInterleaving)
+{
+    AddrDecodeTable<int> t;
+    AddrRangeMap<int> m;
+
+    // two channels selected by the parity of bits 6 and 12, and
+    // two more by the parity of bits 7 and 13
+    const std::vector<Addr> masks = { (1 << 6) | (1 << 12),
+                                      (1 << 7) | (1 << 13) };
+    for (int i = 0; i < 4; i++) {
+        AddrRange r(0x40000, 0x80000, masks, i);
+        ASSERT_TRUE(t.insert(r, i));
+        ASSERT_NE(m.end(), m.insert(r, i));
+    }
+
+    // the table agrees with the map for every line
+    for (Addr a = 0x40000; a < 0x80000; a += 64) {
+        const int *v = t.contains(RangeSize(a, 64));
+        auto i = m.contains(RangeSize(a, 64));
+        ASSERT_NE(nullptr, v);
+        ASSERT_NE(m.end(), i);
+        EXPECT_EQ(i->second, *v);
+    }
+}
+
+TEST(AddrDecodeTableTest, MatchesRangeMap)
+{
+    AddrDecodeTable<int> t;
+    AddrRangeMap<int> m;
+
+    // two separately interleaved regions and a partially populated
+    // group of which the missing stripes are left to the map
+    int id = 0;
+    for (const auto &r : channelRanges(0, 0x400000, 3)) {
+        t.insert(r, id);
+        m.insert(r, id++);
+    }
+    for (const auto &r : channelRanges(0x800000, 0xc00000, 2)) {
+        t.insert(r, id);
+        m.insert(r, id++);
+    }
+    auto partial = channelRanges(0x1000000, 0x1400000, 1);
+    t.insert(partial[0], id);
+    m.insert(partial[0], id++);
+    EXPECT_EQ(3, t.numGroups());
+
+    std::mt19937_64 rng(0);
+    std::uniform_int_distribution<Addr> addr(0, 0x1400000 - 1);
+    std::uniform_int_distribution<Addr> size(1, 128);
+    for (int n = 0; n < 10000; n++) {
+        const AddrRange r = RangeSize(addr(rng), size(rng));
+        const int *v = t.contains(r);
+        auto i = m.contains(r);
+        if (i == m.end()) {
+            EXPECT_EQ(nullptr, v);
+        } else {
+            ASSERT_NE(nullptr, v);
+            EXPECT_EQ(i->second, *v);
+        }
+    }
+}
+
+TEST(AddrDecodeTableTest, Clear)
+{
+    AddrDecodeTable<int> t;
+
+    for (const auto &r : channelRanges(0, 0x1000, 1))
+        t.insert(r, 0);
+    t.clear();
+
+    EXPECT_EQ(0, t.numGroups());
+    EXPECT_EQ(nullptr, t.contains(RangeSize(0, 64)));
+}
@@ -256,6 +256,17 @@ class AddrRange
      */
     bool interleaved() const { return masks.size() > 0; }
 
+    /**
+     * Get the masks selecting the interleaving bits of the range.
+     */
+    const std::vector<Addr> &intlvMasks() const { return masks; }
+
+    /**
+     * Get the value the interleaving bits of an address have to
+     * match for the address to be in the range.
+     */
+    uint8_t intlvMatchValue() const { return intlvMatch; }
+
     /**
      * Determing the interleaving granularity of the range.
      *
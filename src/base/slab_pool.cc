@@ -0,0 +1,101 @@
+/**
+ * @file
+ * Definition of the SlabPool free-list allocator.
+ */
+
+#include "base/slab_pool.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+// definitions of the constants that are odr-used, e.g. by roundUp
+const size_t SlabPool::blockAlign;
+const unsigned SlabPool::maxPools;
+const size_t SlabPool::slabBytes;
+
+__thread SlabPool::ThreadState SlabPool::threadStates[SlabPool::maxPools];
+
+std::vector<SlabPool *> &
+SlabPool::poolList()
+{
+    // function-local so that pools created during static initialisation
+    // of other translation units find it constructed
+    static std::vector<SlabPool *> pool_list;
+    return pool_list;
+}
+
+const std::vector<SlabPool *> &
+SlabPool::pools()
+{
+    return poolList();
+}
+
+SlabPool::SlabPool(const std::string &name, size_t size)
+    : _name(name),
+      blockSize(roundUp(std::max(size, sizeof(FreeBlock)), blockAlign)),
+      id(poolList().size())
+{
+    fatal_if(id >= maxPools, "Too many slab pools, increase maxPools\n");
+    fatal_if(blockSize > slabBytes, "Slab pool %s: blocks of %d bytes do "
+             "not fit in a slab\n", name, blockSize);
+    poolList().push_back(this);
+}
+
+void
+SlabPool::registerThread(ThreadState &ts)
+{
+    std::lock_guard<std::mutex> lock(threadLock);
+    threads.push_back(&ts);
+    ts.registered = true;
+}
+
+void *
+SlabPool::refill(ThreadState &ts)
+{
+    assert(!ts.freeList);
+
+    // the blocks are never handed back to the heap, the slab is reused
+    // through the free list for the rest of the simulation
+    char *slab = static_cast<char *>(::operator new(slabBytes));
+    const size_t num_blocks = slabBytes / blockSize;
+
+    for (size_t i = num_blocks - 1; i > 0; --i) {
+        FreeBlock *blk = reinterpret_cast<FreeBlock *>(slab + i * blockSize);
+        blk->next = ts.freeList;
+        ts.freeList = blk;
+    }
+
+    return slab;
+}
+
+uint64_t
+SlabPool::allocs() const
+{
+    std::lock_guard<std::mutex> lock(threadLock);
+    uint64_t total = 0;
+    for (auto ts : threads)
+        total += ts->allocs;
+    return total;
+}
+
+uint64_t
+SlabPool::hits() const
+{
+    std::lock_guard<std::mutex> lock(threadLock);
+    uint64_t total = 0;
+    for (auto ts : threads)
+        total += ts->hits;
+    return total;
+}
+
+uint64_t
+SlabPool::peakLive() const
+{
+    std::lock_guard<std::mutex> lock(threadLock);
+    uint64_t total = 0;
+    for (auto ts : threads)
+        total += ts->peakLive;
+    return total;
+}
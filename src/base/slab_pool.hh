@@ -0,0 +1,220 @@
+/**
+ * @file
+ * Declaration of a free-list allocator for small fixed-size objects
+ * that are allocated and freed at a high rate, e.g. packets and
+ * requests.
+ */
+
+#ifndef __BASE_SLAB_POOL_HH__
+#define __BASE_SLAB_POOL_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * A SlabPool hands out blocks of a fixed size. Blocks are carved out of
+ * large slabs which are never returned to the system, and freed blocks
+ * are kept on a free list for reuse. Every thread, and thus every event
+ * queue when simulating in parallel, has its own free list so that
+ * neither allocation nor release needs any locking. A block may be
+ * released by another thread than the one that allocated it, it then
+ * simply ends up on the free list of the releasing thread.
+ *
+ * The pool keeps track of the number of allocations, how many of them
+ * were served from the free list, and the peak number of live blocks.
+ * The counters are kept per thread and summed up when read, the peak is
+ * therefore exact when simulating with a single thread and an upper
+ * bound otherwise.
+ */
+class SlabPool
+{
+  public:
+
+    /**
+     * Create a pool. Pools are expected to be created during static
+     * initialisation so that they are known by the time the stats are
+     * registered.
+     *
+     * @param name name of the pool used in the stats
+     * @param size size of the blocks in bytes
+     */
+    SlabPool(const std::string &name, size_t size);
+
+    SlabPool(const SlabPool &) = delete;
+    SlabPool &operator=(const SlabPool &) = delete;
+
+    /** Alignment of every block */
+    static const size_t blockAlign = alignof(std::max_align_t);
+
+    /** Get a block from the pool */
+    void *
+    allocate()
+    {
+        ThreadState &ts = threadState();
+        ++ts.allocs;
+        if (++ts.live > ts.peakLive)
+            ts.peakLive = ts.live;
+
+        if (ts.freeList) {
+            ++ts.hits;
+            FreeBlock *blk = ts.freeList;
+            ts.freeList = blk->next;
+            return blk;
+        }
+
+        return refill(ts);
+    }
+
+    /** Return a block to the pool */
+    void
+    release(void *p)
+    {
+        ThreadState &ts = threadState();
+        --ts.live;
+        FreeBlock *blk = static_cast<FreeBlock *>(p);
+        blk->next = ts.freeList;
+        ts.freeList = blk;
+    }
+
+    const std::string &name() const { return _name; }
+
+    /** Usable size of the blocks in bytes */
+    size_t size() const { return blockSize; }
+
+    /** Total number of allocations */
+    uint64_t allocs() const;
+
+    /** Allocations served from a free list */
+    uint64_t hits() const;
+
+    /** Peak number of live blocks */
+    uint64_t peakLive() const;
+
+    /** All the pools that have been created */
+    static const std::vector<SlabPool *> &pools();
+
+  private:
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    /**
+     * The per-thread part of a pool. This has to be trivial as it lives
+     * in thread-local storage.
+     */
+    struct ThreadState
+    {
+        FreeBlock *freeList;
+        uint64_t allocs;
+        uint64_t hits;
+        int64_t live;
+        int64_t peakLive;
+        bool registered;
+    };
+
+    /** Maximum number of pools in the simulator */
+    static const unsigned maxPools = 16;
+
+    /** Number of bytes carved out of the heap at once */
+    static const size_t slabBytes = 64 * 1024;
+
+    static __thread ThreadState threadStates[maxPools];
+
+    ThreadState &
+    threadState()
+    {
+        ThreadState &ts = threadStates[id];
+        if (!ts.registered)
+            registerThread(ts);
+        return ts;
+    }
+
+    /** Make the counters of the calling thread visible to the stats */
+    void registerThread(ThreadState &ts);
+
+    /**
+     * Allocate a new slab, put all but one of its blocks on the free
+     * list and return the remaining one.
+     */
+    void *refill(ThreadState &ts);
+
+    static std::vector<SlabPool *> &poolList();
+
+    const std::string _name;
+
+    const size_t blockSize;
+
+    const unsigned id;
+
+    /** Protects the list of per-thread states */
+    mutable std::mutex threadLock;
+
+    std::vector<ThreadState *> threads;
+};
+
+/**
+ * An STL allocator drawing single objects from a SlabPool, used with
+ * std::allocate_shared to pool the object together with its reference
+ * counts. Requests for arrays, or for types that do not fit in the
+ * blocks of the pool, fall back to the heap.
+ */
+template <typename T>
+class PoolAllocator
+{
+  public:
+    typedef T value_type;
+
+    explicit PoolAllocator(SlabPool &_pool) : pool(&_pool) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &other) : pool(other.pool) {}
+
+    T *
+    allocate(size_t n)
+    {
+        if (fits(n))
+            return static_cast<T *>(pool->allocate());
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T *p, size_t n)
+    {
+        if (fits(n))
+            pool->release(p);
+        else
+            ::operator delete(p);
+    }
+
+    SlabPool *pool;
+
+  private:
+    bool
+    fits(size_t n) const
+    {
+        return n == 1 && sizeof(T) <= pool->size() &&
+            alignof(T) <= SlabPool::blockAlign;
+    }
+};
+
+template <typename T, typename U>
+inline bool
+operator==(const PoolAllocator<T> &a, const PoolAllocator<U> &b)
+{
+    return a.pool == b.pool;
+}
+
+template <typename T, typename U>
+inline bool
+operator!=(const PoolAllocator<T> &a, const PoolAllocator<U> &b)
+{
+    return a.pool != b.pool;
+}
+
+#endif //__BASE_SLAB_POOL_HH__
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "base/slab_pool.hh"
+
+/*
+ * The pools outlive the tests, which mirrors how they are used in the
+ * simulator, so every test uses its own pool.
+ */
+
+TEST(SlabPoolTest, BlockSizeIsAligned)
+{
+    static SlabPool pool("test_align", 20);
+
+    EXPECT_GE(pool.size(), 20);
+    EXPECT_EQ(0, pool.size() % SlabPool::blockAlign);
+
+    void *p = pool.allocate();
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) % SlabPool::blockAlign);
+    pool.release(p);
+}
+
+TEST(SlabPoolTest, ReleasedBlocksAreReused)
+{
+    static SlabPool pool("test_reuse", 64);
+
+    void *a = pool.allocate();
+    pool.release(a);
+    void *b = pool.allocate();
+
+    EXPECT_EQ(a, b);
+    pool.release(b);
+}
+
+TEST(SlabPoolTest, LiveBlocksAreDistinct)
+{
+    static SlabPool pool("test_distinct", 64);
+
+    // enough blocks to need more than one slab
+    std::vector<void *> blocks;
+    std::set<void *> seen;
+    for (int i = 0; i < 4096; i++) {
+        blocks.push_back(pool.allocate());
+        seen.insert(blocks.back());
+    }
+    EXPECT_EQ(blocks.size(), seen.size());
+
+    for (auto p : blocks)
+        pool.release(p);
+}
+
+TEST(SlabPoolTest, Counters)
+{
+    static SlabPool pool("test_counters", 32);
+
+    void *a = pool.allocate();
+    void *b = pool.allocate();
+    pool.release(a);
+    pool.release(b);
+    void *c = pool.allocate();
+    pool.release(c);
+
+    EXPECT_EQ(3, pool.allocs());
+    // the first allocation has to get a slab, the second one comes from
+    // the rest of that slab and the last one is a reused block
+    EXPECT_EQ(2, pool.hits());
+    EXPECT_EQ(2, pool.peakLive());
+}
+
+TEST(SlabPoolTest, PoolsAreRegistered)
+{
+    static SlabPool pool("test_registered", 16);
+
+    const auto &pools = SlabPool::pools();
+    EXPECT_NE(pools.end(), std::find(pools.begin(), pools.end(), &pool));
+}
+
+TEST(SlabPoolTest, SharedPtrAllocator)
+{
+    static SlabPool pool("test_shared", 128);
+
+    const uint64_t allocs = pool.allocs();
+    {
+        auto p = std::allocate_shared<int>(PoolAllocator<int>(pool), 42);
+        EXPECT_EQ(42, *p);
+        EXPECT_EQ(allocs + 1, pool.allocs());
+    }
+
+    // the block of the object and its counts went back to the pool
+    auto q = std::allocate_shared<int>(PoolAllocator<int>(pool), 7);
+    EXPECT_EQ(allocs + 2, pool.allocs());
+    EXPECT_EQ(7, *q);
+}
+
+TEST(SlabPoolTest, AllocatorFallsBackForLargeTypes)
+{
+    static SlabPool pool("test_large", 16);
+
+    struct Large { char c[256]; };
+    PoolAllocator<Large> alloc(pool);
+
+    Large *l = alloc.allocate(1);
+    alloc.deallocate(l, 1);
+    int *arr = PoolAllocator<int>(pool).allocate(16);
+    PoolAllocator<int>(pool).deallocate(arr, 16);
+
+    EXPECT_EQ(0, pool.allocs());
+}
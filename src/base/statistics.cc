@@ -299,6 +299,12 @@ VectorDistInfo::enable()
         subdescs.resize(s);
 }
 
+string
+QuantileSketchInfo::quantileName(off_type i) const
+{
+    return csprintf("p%g", quantiles[i] * 100);
+}
+
 void
 Vector2dInfo::enable()
 {
@@ -72,6 +72,7 @@
 #include <string>
 #include <vector>
 
+#include "base/stats/ddsketch.hh"
 #include "base/stats/group.hh"
 #include "base/stats/info.hh"
 #include "base/stats/output.hh"
@@ -3028,6 +3029,352 @@ class SparseHistogram : public SparseHistBase<SparseHistogram, SparseHistStor>
     }
 };
 
+template <class Stat>
+class QuantileSketchInfoProxy : public InfoProxy<Stat, QuantileSketchInfo>
+{
+  public:
+    QuantileSketchInfoProxy(Stat &stat)
+        : InfoProxy<Stat, QuantileSketchInfo>(stat)
+    {}
+};
+
+/**
+ * Storage for a quantile sketch stat. @sa DDSketch
+ */
+class QuantileSketchStor
+{
+  public:
+    /** The parameters for a quantile sketch stat. */
+    struct Params : public StorageParams
+    {
+        /** The relative accuracy of the quantiles. */
+        double accuracy;
+        /** The largest number of buckets of a sketch. */
+        unsigned maxBuckets;
+
+        Params() : accuracy(0.01), maxBuckets(2048) {}
+    };
+
+  private:
+    DDSketch sketch;
+
+  public:
+    QuantileSketchStor(Info *info)
+        : sketch(safe_cast<const Params *>(info->storageParams)->accuracy,
+                 safe_cast<const Params *>(info->storageParams)->maxBuckets)
+    {
+    }
+
+    /**
+     * Add a value to the sketch for the given number of times.
+     * @param val The value to add.
+     * @param number The number of times to add the value.
+     */
+    void sample(Counter val, int number) { sketch.add(val, number); }
+
+    /**
+     * Returns true if any calls to sample have been made.
+     * @return True if any values have been sampled.
+     */
+    bool zero() const { return sketch.count() == Counter(); }
+
+    void
+    prepare(Info *info, QuantileSketchData &data)
+    {
+        const QuantileSketchInfo *qinfo =
+            safe_cast<const QuantileSketchInfo *>(info);
+
+        data.samples = sketch.count();
+        data.sum = sketch.sum();
+        data.min_val = sketch.min();
+        data.max_val = sketch.max();
+        data.values.resize(qinfo->quantiles.size());
+        for (off_type i = 0; i < data.values.size(); ++i)
+            data.values[i] = sketch.quantile(qinfo->quantiles[i]);
+    }
+
+    /**
+     * Reset stat value to default
+     */
+    void reset(Info *info) { sketch.clear(); }
+
+    /** Add the samples of another sketch to this one. */
+    void add(const QuantileSketchStor *other) { sketch.merge(other->sketch); }
+
+    const DDSketch &value() const { return sketch; }
+};
+
+/**
+ * Implementation of a quantile sketch stat. @sa QuantileSketchStor
+ */
+template <class Derived, class Stor>
+class QuantileSketchBase : public DataWrap<Derived, QuantileSketchInfoProxy>
+{
+  public:
+    typedef QuantileSketchInfoProxy<Derived> Info;
+    typedef Stor Storage;
+    typedef typename Stor::Params Params;
+
+  protected:
+    /** The storage for this stat. */
+    char storage[sizeof(Storage)] __attribute__ ((aligned (8)));
+
+  protected:
+    Storage *
+    data()
+    {
+        return reinterpret_cast<Storage *>(storage);
+    }
+
+    const Storage *
+    data() const
+    {
+        return reinterpret_cast<const Storage *>(storage);
+    }
+
+    void
+    doInit()
+    {
+        new (storage) Storage(this->info());
+        this->setInit();
+    }
+
+  public:
+    QuantileSketchBase(Group *parent, const char *name, const char *desc)
+        : DataWrap<Derived, QuantileSketchInfoProxy>(parent, name, desc)
+    {
+    }
+
+    ~QuantileSketchBase()
+    {
+        if (this->info()->flags.isSet(init))
+            data()->~Storage();
+    }
+
+    /**
+     * Add a value to the sketch n times.
+     * @param v The value to add.
+     * @param n The number of times to add it, defaults to 1.
+     */
+    template <typename U>
+    void sample(const U &v, int n = 1) { data()->sample(v, n); }
+
+    size_type size() const { return 1; }
+    bool zero() const { return data()->zero(); }
+
+    void
+    prepare()
+    {
+        Info *info = this->info();
+        info->data.resize(1);
+        data()->prepare(info, info->data[0]);
+    }
+
+    /**
+     * Reset stat value to default
+     */
+    void
+    reset()
+    {
+        data()->reset(this->info());
+    }
+
+    /** Add the samples of another sketch to this one. */
+    void add(QuantileSketchBase &s) { data()->add(s.data()); }
+
+    /** The underlying sketch, e.g. to merge it outside of the stats. */
+    const DDSketch &sketch() const { return data()->value(); }
+};
+
+template <class Derived, class Stor>
+class VectorQuantileSketchBase
+    : public DataWrapVec<Derived, QuantileSketchInfoProxy>
+{
+  public:
+    typedef QuantileSketchInfoProxy<Derived> Info;
+    typedef Stor Storage;
+    typedef typename Stor::Params Params;
+    typedef DistProxy<Derived> Proxy;
+    friend class DistProxy<Derived>;
+    friend class DataWrapVec<Derived, QuantileSketchInfoProxy>;
+
+  protected:
+    Storage *storage;
+    size_type _size;
+
+  protected:
+    Storage *
+    data(off_type index)
+    {
+        return &storage[index];
+    }
+
+    const Storage *
+    data(off_type index) const
+    {
+        return &storage[index];
+    }
+
+    void
+    doInit(size_type s)
+    {
+        assert(s > 0 && "size must be positive!");
+        assert(!storage && "already initialized");
+        _size = s;
+
+        char *ptr = new char[_size * sizeof(Storage)];
+        storage = reinterpret_cast<Storage *>(ptr);
+
+        Info *info = this->info();
+        for (off_type i = 0; i < _size; ++i)
+            new (&storage[i]) Storage(info);
+
+        // the subnames tell the outputs that this is a vector
+        info->subnames.resize(_size);
+        info->subdescs.resize(_size);
+
+        this->setInit();
+    }
+
+  public:
+    VectorQuantileSketchBase(Group *parent, const char *name,
+                             const char *desc)
+        : DataWrapVec<Derived, QuantileSketchInfoProxy>(parent, name, desc),
+          storage(NULL)
+    {}
+
+    ~VectorQuantileSketchBase()
+    {
+        if (!storage)
+            return ;
+
+        for (off_type i = 0; i < _size; ++i)
+            data(i)->~Storage();
+        delete [] reinterpret_cast<char *>(storage);
+    }
+
+    Proxy operator[](off_type index)
+    {
+        assert(index < size());
+        return Proxy(this->self(), index);
+    }
+
+    size_type
+    size() const
+    {
+        return _size;
+    }
+
+    bool
+    zero() const
+    {
+        for (off_type i = 0; i < size(); ++i)
+            if (!data(i)->zero())
+                return false;
+        return true;
+    }
+
+    void
+    prepare()
+    {
+        Info *info = this->info();
+        size_type size = this->size();
+        info->data.resize(size);
+        for (off_type i = 0; i < size; ++i)
+            data(i)->prepare(info, info->data[i]);
+    }
+
+    bool
+    check() const
+    {
+        return storage != NULL;
+    }
+
+    /**
+     * The samples of all the sketches merged into one.
+     * @param total The sketch to merge them into.
+     */
+    void
+    total(DDSketch &total) const
+    {
+        for (off_type i = 0; i < size(); ++i)
+            total.merge(data(i)->value());
+    }
+};
+
+/**
+ * A stat that estimates quantiles of the sampled values, e.g. the
+ * median and the tail latencies, with a bounded relative error in
+ * little memory. Unlike a histogram it does not need to know the
+ * range of the values in advance. @sa DDSketch
+ */
+class QuantileSketch
+    : public QuantileSketchBase<QuantileSketch, QuantileSketchStor>
+{
+  public:
+    QuantileSketch(Group *parent = nullptr, const char *name = nullptr,
+                   const char *desc = nullptr)
+        : QuantileSketchBase<QuantileSketch, QuantileSketchStor>(
+            parent, name, desc)
+    {
+    }
+
+    /**
+     * Set the parameters of this sketch. @sa QuantileSketchStor::Params
+     * @param quantiles The quantiles to report.
+     * @param accuracy The relative accuracy of the quantiles.
+     * @return A reference to this sketch.
+     */
+    QuantileSketch &
+    init(const std::vector<double> &quantiles = { 0.5, 0.99, 0.999 },
+         double accuracy = 0.01)
+    {
+        QuantileSketchStor::Params *params = new QuantileSketchStor::Params;
+        params->accuracy = accuracy;
+        this->setParams(params);
+        this->info()->quantiles = quantiles;
+        this->doInit();
+        return this->self();
+    }
+};
+
+/**
+ * A vector of quantile sketches.
+ * @sa VectorQuantileSketchBase, QuantileSketch
+ */
+class VectorQuantileSketch
+    : public VectorQuantileSketchBase<VectorQuantileSketch,
+                                      QuantileSketchStor>
+{
+  public:
+    VectorQuantileSketch(Group *parent = nullptr, const char *name = nullptr,
+                         const char *desc = nullptr)
+        : VectorQuantileSketchBase<VectorQuantileSketch, QuantileSketchStor>(
+            parent, name, desc)
+    {
+    }
+
+    /**
+     * Initialize storage and parameters for this vector.
+     * @param size The size of the vector (the number of sketches).
+     * @param quantiles The quantiles to report.
+     * @param accuracy The relative accuracy of the quantiles.
+     * @return A reference to this vector.
+     */
+    VectorQuantileSketch &
+    init(size_type size,
+         const std::vector<double> &quantiles = { 0.5, 0.99, 0.999 },
+         double accuracy = 0.01)
+    {
+        QuantileSketchStor::Params *params = new QuantileSketchStor::Params;
+        params->accuracy = accuracy;
+        this->setParams(params);
+        this->info()->quantiles = quantiles;
+        this->doInit(size);
+        return this->self();
+    }
+};
+
 class Temp;
 /**
  * A formula for statistics that is calculated when printed. A formula is
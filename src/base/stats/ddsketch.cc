@@ -0,0 +1,129 @@
+#include "base/stats/ddsketch.hh"
+
+#include <limits>
+
+#include "base/logging.hh"
+
+namespace Stats {
+
+DDSketch::DDSketch(double _alpha, unsigned max_buckets)
+    : alpha(_alpha), gamma((1 + _alpha) / (1 - _alpha)),
+      invLogGamma(1 / std::log(gamma)),
+      minIndexable(std::numeric_limits<double>::min() * gamma),
+      maxBuckets(max_buckets), offset(0)
+{
+    fatal_if(alpha <= 0 || alpha >= 1,
+             "Quantile sketch accuracy must be in (0, 1), got %f\n", alpha);
+    fatal_if(maxBuckets == 0, "Quantile sketch needs at least one bucket\n");
+    clear();
+}
+
+void
+DDSketch::merge(const DDSketch &other)
+{
+    panic_if(other.gamma != gamma,
+             "Cannot merge quantile sketches of different accuracy\n");
+
+    if (other._count == 0)
+        return;
+
+    if (_count == 0) {
+        _min = other._min;
+        _max = other._max;
+    } else {
+        _min = std::min(_min, other._min);
+        _max = std::max(_max, other._max);
+    }
+    _count += other._count;
+    _sum += other._sum;
+    zeroCount += other.zeroCount;
+
+    if (other.buckets.empty())
+        return;
+
+    extend(other.offset, other.offset + other.buckets.size() - 1);
+    for (int i = 0; i < (int)other.buckets.size(); i++) {
+        const int j = std::max(other.offset + i, offset) - offset;
+        buckets[j] += other.buckets[i];
+    }
+}
+
+double
+DDSketch::quantile(double q) const
+{
+    if (_count == 0 || q < 0 || q > 1)
+        return NAN;
+
+    // the extremes are known exactly
+    if (q == 0)
+        return _min;
+    if (q == 1)
+        return _max;
+
+    const Counter rank = q * (_count - 1);
+
+    double v = 0;
+    Counter seen = zeroCount;
+    if (seen <= rank) {
+        for (int i = 0; i < (int)buckets.size(); i++) {
+            seen += buckets[i];
+            if (seen > rank) {
+                v = value(offset + i);
+                break;
+            }
+        }
+    }
+
+    // the bucket may be wider than the range of the values in it
+    return std::max(_min, std::min(_max, v));
+}
+
+void
+DDSketch::clear()
+{
+    buckets.clear();
+    offset = 0;
+    zeroCount = 0;
+    _count = 0;
+    _sum = 0;
+    _min = NAN;
+    _max = NAN;
+}
+
+double
+DDSketch::value(int i) const
+{
+    // the point of the bucket with the same relative error to both
+    // of its bounds
+    return 2 * std::pow(gamma, i) / (gamma + 1);
+}
+
+void
+DDSketch::extend(int lo, int hi)
+{
+    if (!buckets.empty()) {
+        lo = std::min(lo, offset);
+        hi = std::max(hi, offset + (int)buckets.size() - 1);
+    }
+
+    // give up the resolution of the lowest values
+    const int new_offset = std::max(lo, hi - (int)maxBuckets + 1);
+    const size_t new_size = hi - new_offset + 1;
+
+    if (buckets.empty()) {
+        buckets.assign(new_size, 0);
+        offset = new_offset;
+        return;
+    }
+
+    if (new_offset == offset && new_size == buckets.size())
+        return;
+
+    std::vector<Counter> moved(new_size, 0);
+    for (int i = 0; i < (int)buckets.size(); i++)
+        moved[std::max(offset + i, new_offset) - new_offset] += buckets[i];
+    buckets.swap(moved);
+    offset = new_offset;
+}
+
+} // namespace Stats
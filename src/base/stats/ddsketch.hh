@@ -0,0 +1,145 @@
+/**
+ * @file
+ * Declaration of a mergeable streaming quantile sketch.
+ */
+
+#ifndef __BASE_STATS_DDSKETCH_HH__
+#define __BASE_STATS_DDSKETCH_HH__
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "base/stats/types.hh"
+
+namespace Stats {
+
+/**
+ * A DDSketch estimates the quantiles of a stream of non-negative
+ * values with a bounded relative error (Masson et al., VLDB 2019).
+ * Values are counted in buckets whose bounds grow geometrically by a
+ * factor gamma = (1 + alpha) / (1 - alpha), so that any value reported
+ * for a bucket is within a factor alpha of every value in it. Values
+ * that are too small to be indexed, zero included, are counted
+ * separately.
+ *
+ * The number of buckets only depends on the ratio between the largest
+ * and the smallest value, e.g. latencies from a picosecond to a second
+ * take less than 1400 buckets with a 1% error. Should the sketch need
+ * more buckets than allowed, the lowest ones are collapsed, which
+ * keeps the error bound for the upper quantiles that matter for tail
+ * latencies.
+ *
+ * Two sketches with the same accuracy can be merged, and the result is
+ * the same as if all the values had been added to one of them.
+ */
+class DDSketch
+{
+  public:
+
+    /**
+     * @param alpha relative accuracy of the quantiles
+     * @param max_buckets largest number of buckets to keep
+     */
+    explicit DDSketch(double alpha = 0.01, unsigned max_buckets = 2048);
+
+    /** Add a value n times */
+    void
+    add(double v, Counter n = 1)
+    {
+        if (n <= 0)
+            return;
+
+        if (_count == 0) {
+            _min = v;
+            _max = v;
+        } else {
+            _min = std::min(_min, v);
+            _max = std::max(_max, v);
+        }
+        _count += n;
+        _sum += v * n;
+
+        if (v < minIndexable) {
+            zeroCount += n;
+            return;
+        }
+
+        // values below collapsed buckets end up in the lowest one
+        const int i = index(v);
+        if (buckets.empty() || i >= offset + (int)buckets.size() ||
+            (i < offset && buckets.size() < maxBuckets))
+            extend(i, i);
+        buckets[std::max(i, offset) - offset] += n;
+    }
+
+    /**
+     * Add all the values of another sketch to this one.
+     *
+     * @param other a sketch with the same accuracy
+     */
+    void merge(const DDSketch &other);
+
+    /**
+     * Estimate a quantile.
+     *
+     * @param q the quantile in [0, 1], e.g. 0.99 for the 99th percentile
+     * @return the estimate, or NAN if the sketch is empty
+     */
+    double quantile(double q) const;
+
+    /** Remove all the values */
+    void clear();
+
+    Counter count() const { return _count; }
+    double sum() const { return _sum; }
+    double mean() const { return _count ? _sum / _count : NAN; }
+    double min() const { return _count ? _min : NAN; }
+    double max() const { return _count ? _max : NAN; }
+
+    double accuracy() const { return alpha; }
+
+    /** Number of buckets in use */
+    size_t numBuckets() const { return buckets.size(); }
+
+  private:
+
+    /** Index of the bucket of a value, gamma^(i-1) < v <= gamma^i */
+    int
+    index(double v) const
+    {
+        return (int)std::ceil(std::log(v) * invLogGamma);
+    }
+
+    /** Value reported for a bucket */
+    double value(int i) const;
+
+    /**
+     * Make the buckets cover the indices from lo to hi, collapsing the
+     * lowest ones if that takes more than maxBuckets.
+     */
+    void extend(int lo, int hi);
+
+    const double alpha;
+    const double gamma;
+    const double invLogGamma;
+
+    /** Values below this are counted as zero */
+    const double minIndexable;
+
+    const unsigned maxBuckets;
+
+    /** Counts of the buckets, starting at the index offset */
+    std::vector<Counter> buckets;
+    int offset;
+
+    Counter zeroCount;
+    Counter _count;
+    double _sum;
+    double _min;
+    double _max;
+};
+
+} // namespace Stats
+
+#endif // __BASE_STATS_DDSKETCH_HH__
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "base/stats/ddsketch.hh"
+
+using namespace Stats;
+
+namespace {
+
+/** The exact quantile with the rank used by the sketch */
+double
+exactQuantile(std::vector<double> values, double q)
+{
+    std::sort(values.begin(), values.end());
+    return values[(size_t)std::floor(q * (values.size() - 1))];
+}
+
+} // anonymous namespace
+
+TEST(DDSketchTest, Empty)
+{
+    DDSketch s;
+
+    EXPECT_EQ(0, s.count());
+    EXPECT_TRUE(std::isnan(s.quantile(0.5)));
+    EXPECT_TRUE(std::isnan(s.min()));
+    EXPECT_TRUE(std::isnan(s.mean()));
+}
+
+TEST(DDSketchTest, SingleValue)
+{
+    DDSketch s;
+    s.add(1000, 3);
+
+    EXPECT_EQ(3, s.count());
+    EXPECT_EQ(3000, s.sum());
+    EXPECT_EQ(1000, s.quantile(0));
+    EXPECT_EQ(1000, s.quantile(0.5));
+    EXPECT_EQ(1000, s.quantile(1));
+}
+
+TEST(DDSketchTest, Zeros)
+{
+    DDSketch s;
+    s.add(0, 90);
+    s.add(500, 10);
+
+    EXPECT_EQ(0, s.quantile(0.5));
+    EXPECT_EQ(0, s.quantile(0.89));
+    EXPECT_NEAR(500, s.quantile(0.95), 500 * s.accuracy());
+}
+
+TEST(DDSketchTest, RelativeAccuracy)
+{
+    const double alpha = 0.01;
+    DDSketch s(alpha);
+
+    // a long-tailed distribution, like memory latencies
+    std::mt19937_64 rng(0);
+    std::lognormal_distribution<double> dist(10, 1.5);
+    std::vector<double> values;
+    for (int i = 0; i < 100000; i++) {
+        values.push_back(dist(rng));
+        s.add(values.back());
+    }
+
+    for (double q : { 0.0, 0.1, 0.5, 0.9, 0.99, 0.999, 1.0 }) {
+        const double exact = exactQuantile(values, q);
+        EXPECT_NEAR(exact, s.quantile(q), exact * alpha) << "q = " << q;
+    }
+}
+
+TEST(DDSketchTest, MergeMatchesSingleSketch)
+{
+    DDSketch a, b, all;
+
+    std::mt19937_64 rng(1);
+    std::exponential_distribution<double> fast(1 / 50.0);
+    std::exponential_distribution<double> slow(1 / 5000.0);
+    for (int i = 0; i < 10000; i++) {
+        const double f = fast(rng), s = slow(rng);
+        a.add(f);
+        b.add(s);
+        all.add(f);
+        all.add(s);
+    }
+
+    a.merge(b);
+    EXPECT_EQ(all.count(), a.count());
+    EXPECT_DOUBLE_EQ(all.sum(), a.sum());
+    EXPECT_EQ(all.min(), a.min());
+    EXPECT_EQ(all.max(), a.max());
+    for (double q : { 0.01, 0.5, 0.99, 0.999 })
+        EXPECT_EQ(all.quantile(q), a.quantile(q));
+}
+
+TEST(DDSketchTest, CollapsingKeepsTheTail)
+{
+    const double alpha = 0.01;
+    DDSketch s(alpha, 100);
+
+    // values spanning far more buckets than the sketch may keep
+    std::vector<double> values;
+    for (double v = 1; v < 1e9; v *= 1.001) {
+        values.push_back(v);
+        s.add(v);
+    }
+
+    EXPECT_LE(s.numBuckets(), 100);
+    for (double q : { 0.99, 0.999 }) {
+        const double exact = exactQuantile(values, q);
+        EXPECT_NEAR(exact, s.quantile(q), exact * alpha) << "q = " << q;
+    }
+    EXPECT_EQ(1, s.quantile(0));
+}
+
+TEST(DDSketchTest, Clear)
+{
+    DDSketch s;
+    s.add(10);
+    s.clear();
+
+    EXPECT_EQ(0, s.count());
+    EXPECT_EQ(0, s.numBuckets());
+    s.add(20);
+    EXPECT_EQ(20, s.quantile(0.5));
+}
@@ -37,6 +37,8 @@
 
 #include "base/stats/hdf5.hh"
 
+#include <cmath>
+
 #include "base/logging.hh"
 #include "base/stats/info.hh"
 
@@ -192,6 +194,41 @@ Hdf5::visit(const SparseHistInfo &info)
     warn_once("HDF5 stat files don't support sparse histograms.\n");
 }
 
+void
+Hdf5::visit(const QuantileSketchInfo &info)
+{
+    // Request a 3-dimensional stat, the first dimension will be
+    // populated by the Hdf5::appendStat() helper. The remaining two
+    // dimensions are the sketches and their summary values.
+    const size_t fields = 4 + info.quantiles.size();
+    std::vector<double> values;
+    values.reserve(info.data.size() * fields);
+    for (const auto &d : info.data) {
+        values.push_back(d.samples);
+        values.push_back(d.samples ? d.sum / d.samples : NAN);
+        values.push_back(d.min_val);
+        values.push_back(d.max_val);
+        values.insert(values.end(), d.values.begin(), d.values.end());
+    }
+
+    hsize_t fdims[3] = { 0, info.data.size(), fields };
+    H5::DataSet data_set = appendStat(info, 3, fdims, values.data());
+
+    if (dumpCount == 0) {
+        std::vector<std::string> y_subnames = {
+            "samples", "mean", "min_value", "max_value" };
+        for (off_type i = 0; i < info.quantiles.size(); ++i)
+            y_subnames.push_back(info.quantileName(i));
+        addMetaData(data_set, "y_subnames", y_subnames);
+
+        if (!info.subnames.empty() && !emptyStrings(info.subnames))
+            addMetaData(data_set, "subnames", info.subnames);
+
+        if (!info.subdescs.empty() && !emptyStrings(info.subdescs))
+            addMetaData(data_set, "subdescs", info.subdescs);
+    }
+}
+
 H5::DataSet
 Hdf5::appendVectorInfo(const VectorInfo &info)
 {
@@ -76,6 +76,7 @@ class Hdf5 : public Output
     void visit(const Vector2dInfo &info) override;
     void visit(const FormulaInfo &info) override;
     void visit(const SparseHistInfo &info) override;
+    void visit(const QuantileSketchInfo &info) override;
 
   protected:
     /**
@@ -255,6 +255,36 @@ class SparseHistInfo : public Info
     SparseHistData data;
 };
 
+struct QuantileSketchData
+{
+    Counter samples;
+    Counter sum;
+    Counter min_val;
+    Counter max_val;
+    /** Estimates of the reported quantiles */
+    VResult values;
+};
+
+class QuantileSketchInfo : public Info
+{
+  public:
+    /** The reported quantiles, e.g. 0.99 for the 99th percentile */
+    std::vector<double> quantiles;
+
+    /** Local storage for the entry values, used for printing. */
+    std::vector<QuantileSketchData> data;
+
+    /**
+     * Names and descriptions of subfields, only used by vectors of
+     * sketches.
+     */
+    std::vector<std::string> subnames;
+    std::vector<std::string> subdescs;
+
+    /** Name of a reported quantile, e.g. p99.9 for 0.999 */
+    std::string quantileName(off_type i) const;
+};
+
 } // namespace Stats
 
 #endif // __BASE_STATS_INFO_HH__
@@ -54,6 +54,7 @@ class VectorDistInfo;
 class Vector2dInfo;
 class FormulaInfo;
 class SparseHistInfo; // Sparse histogram
+class QuantileSketchInfo;
 
 struct Output
 {
@@ -73,6 +74,7 @@ struct Output
     virtual void visit(const Vector2dInfo &info) = 0;
     virtual void visit(const FormulaInfo &info) = 0;
     virtual void visit(const SparseHistInfo &info) = 0; // Sparse histogram
+    virtual void visit(const QuantileSketchInfo &info) = 0;
 };
 
 } // namespace Stats
@@ -813,6 +813,105 @@ Text::visit(const SparseHistInfo &info)
     print(*stream);
 }
 
+/*
+  This struct implements the output methods for the quantile sketch
+  stat
+*/
+struct QuantileSketchPrint
+{
+    string name;
+    string separatorString;
+    string desc;
+    Flags flags;
+    bool descriptions;
+    bool spaces;
+    int precision;
+
+    const QuantileSketchInfo &info;
+    const QuantileSketchData &data;
+
+    QuantileSketchPrint(const Text *text, const QuantileSketchInfo &info,
+                        int i);
+    void operator()(ostream &stream) const;
+};
+
+QuantileSketchPrint::QuantileSketchPrint(const Text *text,
+                                         const QuantileSketchInfo &info,
+                                         int i)
+    : info(info), data(info.data[i])
+{
+    separatorString = info.separatorString;
+    desc = info.desc;
+    flags = info.flags;
+    precision = info.precision;
+    descriptions = text->descriptions;
+    spaces = text->spaces;
+
+    // only vectors of sketches have subnames
+    if (info.subnames.empty()) {
+        name = text->statName(info.name);
+    } else {
+        name = text->statName(
+            info.name + "_" +
+            (info.subnames[i].empty() ? std::to_string(i) :
+             info.subnames[i]));
+
+        if (!info.subdescs[i].empty())
+            desc = info.subdescs[i];
+    }
+}
+
+void
+QuantileSketchPrint::operator()(ostream &stream) const
+{
+    if (flags.isSet(nozero) && data.samples == 0)
+        return;
+
+    string base = name + separatorString;
+
+    ScalarPrint print(spaces);
+    print.precision = precision;
+    print.flags = flags;
+    print.descriptions = descriptions;
+    print.desc = desc;
+    print.pdf = NAN;
+    print.cdf = NAN;
+
+    print.name = base + "samples";
+    print.value = data.samples;
+    print(stream);
+
+    print.name = base + "mean";
+    print.value = data.samples ? data.sum / data.samples : NAN;
+    print(stream);
+
+    print.name = base + "min_value";
+    print.value = data.min_val;
+    print(stream);
+
+    print.name = base + "max_value";
+    print.value = data.max_val;
+    print(stream);
+
+    for (off_type i = 0; i < data.values.size(); ++i) {
+        print.name = base + info.quantileName(i);
+        print.value = data.values[i];
+        print(stream);
+    }
+}
+
+void
+Text::visit(const QuantileSketchInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    for (off_type i = 0; i < info.data.size(); ++i) {
+        QuantileSketchPrint print(this, info, i);
+        print(*stream);
+    }
+}
+
 Output *
 initText(const string &filename, bool desc, bool spaces)
 {
@@ -85,6 +85,7 @@ class Text : public Output
     void visit(const Vector2dInfo &info) override;
     void visit(const FormulaInfo &info) override;
     void visit(const SparseHistInfo &info) override;
+    void visit(const QuantileSketchInfo &info) override;
 
     // Group handling
     void beginGroup(const char *name) override;
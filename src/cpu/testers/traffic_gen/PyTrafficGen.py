@@ -70,3 +70,12 @@ class PyTrafficGen(BaseTrafficGen):
         else:
             raise NotImplementedError("Trace playback requires that gem5 "
                                       "was built with protobuf support.")
+
+    @cxxMethod(override=True)
+    def createCXLTrace(self, duration, trace_file, addr_offset=0):
+        if buildEnv['HAVE_PROTOBUF']:
+            return self.getCCObject().createCXLTrace(duration, trace_file,
+                                                     addr_offset=addr_offset)
+        else:
+            raise NotImplementedError("CXL trace playback requires that gem5 "
+                                      "was built with protobuf support.")
@@ -60,6 +60,7 @@
 #include "sim/system.hh"
 
 #if HAVE_PROTOBUF
+#include "cpu/testers/traffic_gen/cxl_trace_gen.hh"
 #include "cpu/testers/traffic_gen/trace_gen.hh"
 #endif
 
@@ -527,6 +528,21 @@ BaseTrafficGen::createTrace(Tick duration,
 #endif
 }
 
+std::shared_ptr<BaseGen>
+BaseTrafficGen::createCXLTrace(Tick duration,
+                               const std::string& trace_file,
+                               Addr addr_offset)
+{
+#if HAVE_PROTOBUF
+    return std::shared_ptr<BaseGen>(
+        new CXLTraceGen(*this, requestorId, duration, trace_file,
+                        addr_offset));
+#else
+    panic("Can't instantiate CXL trace generation without Protobuf "
+          "support!\n");
+#endif
+}
+
 bool
 BaseTrafficGen::recvTimingResp(PacketPtr pkt)
 {
@@ -318,6 +318,10 @@ class BaseTrafficGen : public ClockedObject
         Tick duration,
         const std::string& trace_file, Addr addr_offset);
 
+    std::shared_ptr<BaseGen> createCXLTrace(
+        Tick duration,
+        const std::string& trace_file, Addr addr_offset);
+
   protected:
     void start();
 
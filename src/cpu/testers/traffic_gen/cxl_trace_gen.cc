@@ -0,0 +1,138 @@
+#include "cpu/testers/traffic_gen/cxl_trace_gen.hh"
+
+#include <algorithm>
+
+#include "base/trace.hh"
+#include "debug/TrafficGen.hh"
+#include "proto/cxl_flit.pb.h"
+
+CXLTraceGen::InputStream::InputStream(const std::string& filename)
+    : trace(filename)
+{
+    init();
+}
+
+void
+CXLTraceGen::InputStream::init()
+{
+    // Create a protobuf message for the header and read it from the stream
+    ProtoMessage::CXLFlitHeader header_msg;
+    if (!trace.read(header_msg)) {
+        panic("Failed to read flit header from trace\n");
+    } else if (header_msg.tick_freq() != SimClock::Frequency) {
+        panic("Trace was recorded with a different tick frequency %d\n",
+              header_msg.tick_freq());
+    }
+}
+
+void
+CXLTraceGen::InputStream::reset()
+{
+    trace.reset();
+    init();
+}
+
+bool
+CXLTraceGen::InputStream::read(TraceElement& element)
+{
+    ProtoMessage::CXLFlit flit_msg;
+    while (trace.read(flit_msg)) {
+        // responses are produced by the device under test
+        if (flit_msg.channel() != ProtoMessage::CXLFlit::M2S_REQ &&
+            flit_msg.channel() != ProtoMessage::CXLFlit::M2S_RWD)
+            continue;
+
+        // the generator waits for a response to everything it sends,
+        // so writebacks are replayed as plain writes
+        const MemCmd host_cmd = flit_msg.host_cmd();
+        element.cmd = host_cmd.isWrite() ? MemCmd::WriteReq :
+                                           MemCmd::ReadReq;
+        element.addr = flit_msg.addr();
+        element.blocksize = flit_msg.size();
+        element.tick = flit_msg.tick();
+        element.flags = flit_msg.has_flags() ? flit_msg.flags() : 0;
+        return true;
+    }
+
+    // We have reached the end of the file
+    return false;
+}
+
+Tick
+CXLTraceGen::nextPacketTick(bool elastic, Tick delay) const
+{
+    if (traceComplete) {
+        DPRINTF(TrafficGen, "No next tick as trace is finished\n");
+        // We are at the end of the file, thus we have no more data in
+        // the trace Return MaxTick to signal that there will be no
+        // more transactions in this active period for the state.
+        return MaxTick;
+    }
+
+    assert(nextElement.isValid());
+
+    DPRINTF(TrafficGen, "Next packet tick is %d\n", tickOffset +
+            nextElement.tick - traceStart);
+
+    // if the playback is supposed to be elastic, add the delay
+    if (elastic)
+        tickOffset += delay;
+
+    return std::max(tickOffset + nextElement.tick - traceStart, curTick());
+}
+
+void
+CXLTraceGen::enter()
+{
+    // update the trace offset to the time where the state was entered.
+    tickOffset = curTick();
+
+    // clear everything
+    currElement.clear();
+
+    // read the first element in the file and set the complete flag
+    traceComplete = !trace.read(nextElement);
+    traceStart = traceComplete ? 0 : nextElement.tick;
+}
+
+PacketPtr
+CXLTraceGen::getNextPacket()
+{
+    // shift things one step forward
+    currElement = nextElement;
+    nextElement.clear();
+
+    // read the next element and set the complete flag
+    traceComplete = !trace.read(nextElement);
+
+    // it is the responsibility of the traceComplete flag to ensure we
+    // always have a valid element here
+    assert(currElement.isValid());
+
+    DPRINTF(TrafficGen, "CXLTraceGen::getNextPacket: %s %d %d %d 0x%x\n",
+            currElement.cmd.toString(),
+            currElement.addr,
+            currElement.blocksize,
+            currElement.tick,
+            currElement.flags);
+
+    return getPacket(currElement.addr + addrOffset,
+                     currElement.blocksize,
+                     currElement.cmd, currElement.flags);
+}
+
+void
+CXLTraceGen::exit()
+{
+    // Check if we reached the end of the trace file. If we did not
+    // then we want to generate a warning stating that not the entire
+    // trace was played.
+    if (!traceComplete) {
+        warn("CXL trace player %s was unable to replay the entire trace!\n",
+             name());
+    }
+
+    // Clear any flags and start over again from the beginning of the
+    // file
+    trace.reset();
+}
@@ -0,0 +1,179 @@
+/**
+ * @file
+ * Declaration of the CXL flit trace generator that replays the host
+ * requests recorded by a CXLFlitTraceProbe.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_CXL_TRACE_GEN_HH__
+#define __CPU_TRAFFIC_GEN_CXL_TRACE_GEN_HH__
+
+#include "base_gen.hh"
+#include "mem/packet.hh"
+#include "proto/protoio.hh"
+
+/**
+ * The CXL trace generator replays the host side of a CXL flit trace.
+ * Only the M2S flits of the trace are used, and every one of them is
+ * turned back into the host request it was packed from, keeping the
+ * original timing. The S2M flits belong to the device that was used
+ * when recording and are skipped, so the same host request stream can
+ * be sent to any other device or switch configuration.
+ */
+class CXLTraceGen : public BaseGen
+{
+
+  private:
+
+    /**
+     * This struct stores a host request of the trace file.
+     */
+    struct TraceElement {
+
+        /** The host command of the request */
+        MemCmd cmd;
+
+        /** The address for the request */
+        Addr addr;
+
+        /** The size of the access for the request */
+        Addr blocksize;
+
+        /** The time at which the request should be sent */
+        Tick tick;
+
+        /** Potential request flags to use */
+        Request::FlagsType flags;
+
+        /**
+         * Check validity of this element.
+         *
+         * @return if this element is valid
+         */
+        bool isValid() const {
+            return cmd != MemCmd::InvalidCmd;
+        }
+
+        /**
+         * Make this element invalid.
+         */
+        void clear() {
+            cmd = MemCmd::InvalidCmd;
+        }
+    };
+
+    /**
+     * The InputStream encapsulates a flit trace file and populates
+     * TraceElements from its M2S flits.
+     */
+    class InputStream
+    {
+
+      private:
+
+        /// Input file stream for the protobuf trace
+        ProtoInputStream trace;
+
+      public:
+
+        /**
+         * Create a trace input stream for a given file name.
+         *
+         * @param filename Path to the file to read from
+         */
+        InputStream(const std::string& filename);
+
+        /**
+         * Reset the stream such that it can be played once
+         * again.
+         */
+        void reset();
+
+        /**
+         * Check the trace header to make sure that it is of the right
+         * format.
+         */
+        void init();
+
+        /**
+         * Read the next M2S flit from the stream, skipping any S2M
+         * flit, and also notify the caller if the end of the file
+         * was reached.
+         *
+         * @param element Trace element to populate
+         * @return True if an element could be read successfully
+         */
+        bool read(TraceElement& element);
+    };
+
+  public:
+
+    /**
+     * Create a CXL trace generator.
+     *
+     * @param obj SimObject owning this sequence generator
+     * @param requestor_id RequestorID related to the memory requests
+     * @param _duration duration of this state before transitioning
+     * @param trace_file File to read the flits from
+     * @param addr_offset Positive offset to add to trace address
+     */
+    CXLTraceGen(SimObject &obj, RequestorID requestor_id, Tick _duration,
+                const std::string& trace_file, Addr addr_offset)
+        : BaseGen(obj, requestor_id, _duration),
+          trace(trace_file),
+          tickOffset(0),
+          traceStart(0),
+          addrOffset(addr_offset),
+          traceComplete(false)
+    {
+    }
+
+    void enter();
+
+    PacketPtr getNextPacket();
+
+    void exit();
+
+    /**
+     * Returns the tick when the next request should be generated. If
+     * the end of the file has been reached, it returns MaxTick to
+     * indicate that there will be no more requests.
+     */
+    Tick nextPacketTick(bool elastic, Tick delay) const;
+
+  private:
+
+    /** Input stream used for reading the input trace file */
+    InputStream trace;
+
+    /** Store the current and next element in the trace */
+    TraceElement currElement;
+    TraceElement nextElement;
+
+    /**
+     * Stores the time when the state was entered. This is to add an
+     * offset to the times stored in the trace file. This is mutable
+     * to allow us to change it as part of nextPacketTick.
+     */
+    mutable Tick tickOffset;
+
+    /**
+     * Tick of the first flit in the trace. Flit traces are recorded
+     * from a running system, so the replay starts with the first
+     * recorded flit rather than at tick zero.
+     */
+    Tick traceStart;
+
+    /**
+     * Offset for memory requests. Used to shift the trace
+     * away from the CPU address space.
+     */
+    Addr addrOffset;
+
+    /**
+     * Set to true when the trace replay for one instance of
+     * state is complete.
+     */
+    bool traceComplete;
+};
+
+#endif
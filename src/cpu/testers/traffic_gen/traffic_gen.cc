@@ -175,6 +175,16 @@ TrafficGen::parseConfig()
 
                     states[id] = createTrace(duration, traceFile, addrOffset);
                     DPRINTF(TrafficGen, "State: %d TraceGen\n", id);
+                } else if (mode == "CXL_TRACE") {
+                    string traceFile;
+                    Addr addrOffset;
+
+                    is >> traceFile >> addrOffset;
+                    traceFile = resolveFile(traceFile);
+
+                    states[id] = createCXLTrace(duration, traceFile,
+                                                addrOffset);
+                    DPRINTF(TrafficGen, "State: %d CXLTraceGen\n", id);
                 } else if (mode == "IDLE") {
                     states[id] = createIdle(duration);
                     DPRINTF(TrafficGen, "State: %d IdleGen\n", id);
@@ -1234,7 +1234,7 @@ ComputeUnit::injectGlobalMemFence(GPUDynInstPtr gpuDynInst,
            gpuDynInst->executedAs() == Enums::SC_GLOBAL);
 
     if (!req) {
-        req = std::make_shared<Request>(
+        req = makeRequest(
             0, 0, 0, requestorId(), 0, gpuDynInst->wfDynId);
     }
 
@@ -1497,7 +1497,7 @@ ComputeUnit::DTLBPort::recvTimingResp(PacketPtr pkt)
             if (!stride)
                 break;
 
-            RequestPtr prefetch_req = std::make_shared<Request>(
+            RequestPtr prefetch_req = makeRequest(
                 vaddr + stride * pf * TheISA::PageBytes,
                 sizeof(uint8_t), 0,
                 computeUnit->requestorId(),
@@ -2540,7 +2540,7 @@ ComputeUnit::sendToLds(GPUDynInstPtr gpuDynInst)
 {
     // this is just a request to carry the GPUDynInstPtr
     // back and forth
-    RequestPtr newRequest = std::make_shared<Request>();
+    RequestPtr newRequest = makeRequest();
     newRequest->setPaddr(0x0);
 
     // ReadReq is not evaluted by the LDS but the Packet ctor requires this
@@ -69,3 +69,9 @@ class AbstractMemory(ClockedObject):
     # particularly useful for ROMs.
     image_file = Param.String('',
             "Image to load into memory as its initial contents")
+
+    # Link compression sends the data of the read responses compressed,
+    # so that it takes fewer bytes on the crossbars and links, e.g. a CXL
+    # link in front of the memory
+    link_compressor = Param.BaseCacheCompressor(NULL,
+            "Compressor of the read responses sent over the memory fabric")
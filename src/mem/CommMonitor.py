@@ -76,6 +76,12 @@ class CommMonitor(SimObject):
     # latency from request to response (not using sample period)
     latency_bins = Param.Unsigned('20', "# bins in latency histograms")
     disable_latency_hists = Param.Bool(False, "Disable latency histograms")
+    # the quantiles of the latency are estimated with a bounded relative
+    # error, and are disabled together with the histograms
+    latency_quantiles = VectorParam.Float([0.5, 0.99, 0.999],
+                                          "Latency quantiles to report")
+    latency_quantile_accuracy = Param.Float(0.01, "Relative accuracy of " \
+                                                "the latency quantiles")
 
     # inter transaction time (ITT) distributions in uniformly sized
     # bins up to the maximum, independently for read-to-read,
@@ -0,0 +1,38 @@
+from m5.params import *
+from m5.proxy import *
+from m5.objects.ClockedObject import ClockedObject
+
+# A direct-mapped DRAM cache with its tags stored along with the data, in
+# front of a slower memory such as CXL memory. The memory controller on
+# the cache side provides the timing of the cache array, and its range
+# sets the size of the cache. It should be a null memory outside of the
+# address map, as the data is kept in the cache.
+class DRAMCache(ClockedObject):
+    type = 'DRAMCache'
+    cxx_header = "mem/dram_cache.hh"
+
+    system = Param.System(Parent.any, "System this cache belongs to")
+
+    cpu_side_port = ResponsePort("This port receives requests and "
+                                 "sends responses")
+    mem_side_port = RequestPort("This port sends requests to the backing "
+                                "memory and receives responses")
+    cache_side_port = RequestPort("This port sends the accesses of the "
+                                  "cache array to its memory controller")
+
+    block_size = Param.MemorySize('64B', "Size of the blocks of the cache, "
+                                  "the line size for an Alloy cache, or a "
+                                  "page of lines filled on demand")
+    line_size = Param.Unsigned(Parent.cache_line_size, "Size of a line")
+
+    response_latency = Param.Cycles(2, "Latency of the tag check and of "
+                                    "sending a response")
+    max_outstanding = Param.Unsigned(64, "Maximum number of accesses "
+                                     "handled at once")
+
+    miss_predictor_entries = Param.Unsigned(256, "Number of counters of "
+                                            "the MAP-I miss predictor (0 "
+                                            "reads the backing memory after "
+                                            "the tag check only)")
+    miss_predictor_bits = Param.Unsigned(3, "Bits of the miss predictor "
+                                         "counters")
@@ -45,6 +45,12 @@ from m5.objects.MemInterface import *
 class PageManage(Enum): vals = ['open', 'open_adaptive', 'close',
                                 'close_adaptive']
 
+# Enum for the refresh command, either refreshing all the banks of a rank
+# at once, the same bank of every bank group (DDR5 REFsb), or a single
+# bank (LPDDR REFpb). With the last two, the banks not being refreshed
+# keep serving accesses.
+class RefreshMode(Enum): vals = ['all_bank', 'same_bank', 'per_bank']
+
 class DRAMInterface(MemInterface):
     type = 'DRAMInterface'
     cxx_header = "mem/mem_interface.hh"
@@ -124,6 +130,19 @@ class DRAMInterface(MemInterface):
     # to be sent. It is 7.8 us for a 64ms refresh requirement
     tREFI = Param.Latency("Refresh command interval")
 
+    # with same bank or per bank refresh, the banks are refreshed in
+    # turn, so that all of them are refreshed once every tREFI, and each
+    # refresh only holds its banks for tRFCsb
+    refresh_mode = Param.RefreshMode('all_bank', "Refresh command")
+    tRFCsb = Param.Latency("0ns", "Same bank or per bank refresh cycle time")
+
+    # with on-die ECC, a write of part of a burst is a read-modify-write
+    # inside the device, as the code word covers the whole burst; the
+    # internal read holds the bank group of the write for longer
+    on_die_ecc = Param.Bool(False, "DRAM devices have on-die ECC")
+    tCCD_L_WR_RMW = Param.Latency(Self.tCCD_L_WR,
+      "Same bank group delay after a read-modify-write")
+
     # write-to-read, same rank turnaround penalty for same bank group
     tWTR_L = Param.Latency(Self.tWTR, "Write to read, same rank switching "
                            "time, same bank group")
@@ -638,6 +657,135 @@ class DDR4_2400_4x16(DDR4_2400_16x4):
     IDD5 = '280mA'
     IDD3P1 = '41mA'
 
+# A single DDR5-4800 x32 sub-channel (one command and address bus), with
+# timings based on the JEDEC DDR5 specification for a 16 Gbit x8 device.
+# A DDR5 DIMM has two independent 32-bit sub-channels, each with its own
+# command and address bus, so a DIMM is two of these channels, e.g.
+# interleaved at a cache line granularity.
+# 4 devices/rank * 1 rank/channel * 2GB/device = 8GB/channel
+class DDR5_4800_4x8(DRAMInterface):
+    # size of device
+    device_size = '2GB'
+
+    # 4x8 configuration, 4 devices each with an 8-bit interface
+    device_bus_width = 8
+
+    # DDR5 is a BL16 device, which gives 64 byte bursts on a sub-channel
+    burst_length = 16
+
+    # Each device has a page (row buffer) size of 1 Kbyte (1K columns x8)
+    device_rowbuffer_size = '1kB'
+
+    # 4x8 configuration, so 4 devices
+    devices_per_rank = 4
+
+    # Single rank
+    ranks_per_channel = 1
+
+    # DDR5 x4 and x8 devices have 8 bank groups of 4 banks
+    bank_groups_per_rank = 8
+    banks_per_rank = 32
+
+    # override the default buffer sizes and go for something larger to
+    # accommodate the larger bank count
+    write_buffer_size = 128
+    read_buffer_size = 64
+
+    # 2400 MHz
+    tCK = '0.416ns'
+
+    # 16 beats across an x32 interface translates to 8 clocks @ 2400 MHz
+    # With bank group architectures, tBURST represents the CAS-to-CAS
+    # delay for bursts to different bank groups (tCCD_S)
+    tBURST = '3.333ns'
+
+    # Greater of 8 CK or 5ns
+    tCCD_L = '5ns'
+
+    # Greater of 16 CK or 10ns, and greater of 32 CK or 20ns when the
+    # first write is a read-modify-write of the on-die ECC
+    tCCD_L_WR = '10ns'
+    tCCD_L_WR_RMW = '20ns'
+
+    # DDR5 devices always correct single bit errors on die
+    on_die_ecc = True
+
+    # DDR5-4800B 40-39-39
+    tRCD = '16ns'
+    tCL = '16.666ns'
+    tRP = '16ns'
+    tRAS = '32ns'
+
+    # RRD_S (different bank group) is 8 CK
+    tRRD = '3.333ns'
+
+    # RRD_L (same bank group) is greater of 8 CK or 5ns
+    tRRD_L = '5ns'
+
+    # tFAW for 1K page is greater of 32 CK or 13.333ns
+    tXAW = '13.333ns'
+    activation_limit = 4
+
+    # tRFC1 and tRFCsb for a 16 Gbit device
+    tRFC = '295ns'
+    tRFCsb = '130ns'
+
+    # Refresh the same bank of every bank group, so that the other
+    # banks keep serving accesses
+    refresh_mode = 'same_bank'
+
+    tWR = '30ns'
+
+    # WTR_S is greater of 4 CK or 2.5ns, WTR_L is greater of 16 CK or 10ns
+    tWTR = '2.5ns'
+    tWTR_L = '10ns'
+
+    # Greater of 12 CK or 7.5 ns
+    tRTP = '7.5ns'
+
+    # Default same rank rd-to-wr bus turnaround to 2 CK, @2400 MHz = 0.833 ns
+    tRTW = '0.833ns'
+
+    # Default different rank bus delay to 2 CK, @2400 MHz = 0.833 ns
+    tCS = '0.833ns'
+
+    # <=85C, half for >85C
+    tREFI = '3.9us'
+
+    # active powerdown and precharge powerdown exit time
+    tXP = '7.5ns'
+
+    # self refresh exit time
+    # tRFC + 10ns = 305ns
+    tXS = '305ns'
+
+    VDD = '1.1V'
+    VDD2 = '1.8V'
+
+# A single DDR5-5600 x32 sub-channel (one command and address bus), with
+# timings based on the JEDEC DDR5 specification for a 16 Gbit x8 device.
+# 4 devices/rank * 1 rank/channel * 2GB/device = 8GB/channel
+class DDR5_5600_4x8(DDR5_4800_4x8):
+    # 2800 MHz
+    tCK = '0.357ns'
+
+    # 16 beats across an x32 interface translates to 8 clocks @ 2800 MHz
+    tBURST = '2.857ns'
+
+    # DDR5-5600B 46-45-45
+    tRCD = '16ns'
+    tCL = '16.428ns'
+    tRP = '16ns'
+
+    # RRD_S (different bank group) is 8 CK
+    tRRD = '2.857ns'
+
+    # Default same rank rd-to-wr bus turnaround to 2 CK, @2800 MHz = 0.714 ns
+    tRTW = '0.714ns'
+
+    # Default different rank bus delay to 2 CK, @2800 MHz = 0.714 ns
+    tCS = '0.714ns'
+
 # A single LPDDR2-S4 x32 interface (one command/address bus), with
 # default timings based on a LPDDR2-1066 4 Gbit part (Micron MT42L128M32D1)
 # in a 1x32 configuration.
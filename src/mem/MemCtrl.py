@@ -82,6 +82,13 @@ class MemCtrl(QoSMemCtrl):
     # scheduler, address map and page policy
     mem_sched_policy = Param.MemSched('frfcfs', "Memory scheduling policy")
 
+    # FR-FCFS keeps an index of the queued DRAM packets per bank and row
+    # rather than looking at every queued packet for each decision, the
+    # check compares every decision with the one found by a full scan
+    indexed_sched = Param.Bool(True, "Index the queues for FR-FCFS")
+    check_sched_index = Param.Bool(False, "Check the indexed FR-FCFS "
+                                   "decisions against a scan of the queue")
+
     # pipeline latency of the controller and PHY, split into a
     # frontend part and a backend part, with reads and writes serviced
     # by the queues only seeing the frontend contribution, and reads
@@ -66,6 +66,21 @@ class MemInterface(AbstractMemory):
     # scheduler, address map
     addr_mapping = Param.AddrMap('RoRaBaCoCh', "Address mapping policy")
 
+    # programmable mapping on top of the address map, working on the
+    # address within the channel, i.e. with the channel bits removed:
+    # the address bits are first permuted, and each bank and rank bit
+    # is then XORed with the parity of the address bits selected by its
+    # mask, e.g. with low row bits to spread the strides that are a
+    # multiple of the row size over the banks. The masks should only
+    # select row and column bits, so that the mapping stays one to one.
+    # The channel bits are selected by the masks of the address range.
+    addr_permutation = VectorParam.Unsigned([], "Address bit used for each "
+                                            "address bit, from the LSB")
+    bank_xor_masks = VectorParam.Addr([], "Address bits XORed into each "
+                                      "bank bit, from the LSB")
+    rank_xor_masks = VectorParam.Addr([], "Address bits XORed into each "
+                                      "rank bit, from the LSB")
+
     # size of memory device in Bytes
     device_size = Param.MemorySize("Size of memory device")
     # the physical organisation of the memory
@@ -65,3 +65,29 @@ class SerialLink(ClockedObject):
         "link. (aka. lane width)")
     link_speed = Param.UInt64(1, "Gb/s Speed of each parallel lane inside the"
         "serial link. (aka. lane speed)")
+
+    # Link power management. An idle link first drops to L0p, where only
+    # l0p_lanes lanes are kept active, and then to L1. A packet arriving
+    # in L0p is serialized on the active lanes while the others are
+    # brought back up, whereas a packet arriving in L1 has to wait for
+    # the link to retrain.
+    link_pm = Param.Bool(False, "Enable link power states (L0p/L1)")
+    l0p_lanes = Param.Unsigned(0, "Number of lanes active in L0p "
+        "(0 means half of the lanes)")
+    l0p_idle_timeout = Param.Latency('200ns', "Idle time before entering L0p")
+    l1_idle_timeout = Param.Latency('5us', "Idle time before entering L1")
+    l0p_exit_latency = Param.Latency('20ns', "Time to bring the idle lanes "
+        "back up when leaving L0p")
+    l1_exit_latency = Param.Latency('2us', "Time to retrain the link when "
+        "leaving L1")
+    l0_energy_per_bit = Param.Float(5.0, "Energy per bit in L0 (pJ/bit)")
+    l0p_energy_per_bit = Param.Float(5.5, "Energy per bit in L0p (pJ/bit)")
+    l0_static_power = Param.Float(100.0, "Static power in L0 (mW)")
+    l0p_static_power = Param.Float(60.0, "Static power in L0p (mW)")
+    l1_static_power = Param.Float(5.0, "Static power in L1 (mW)")
+
+    def __init__(self, **kwargs):
+        super(SerialLink, self).__init__(**kwargs)
+        # L0, L0p and L1 map on ON, CLK_GATED and SRAM_RETENTION
+        self.power_state.possible_states = ['ON', 'CLK_GATED',
+                                            'SRAM_RETENTION']
@@ -42,6 +42,7 @@ from m5.proxy import *
 from m5.SimObject import SimObject
 
 from m5.objects.ClockedObject import ClockedObject
+from m5.objects.ReplacementPolicies import LRURP
 
 class BaseXBar(ClockedObject):
     type = 'BaseXBar'
@@ -94,6 +95,12 @@ class BaseXBar(ClockedObject):
     use_default_range = Param.Bool(False, "Perform address mapping for " \
                                        "the default port")
 
+    # Interleaved address ranges, e.g. of many memory channels, are
+    # decoded by indexing a table with the interleaving bits of the
+    # address, rather than by searching the address map.
+    use_decode_table = Param.Bool(True, "Decode interleaved address " \
+                                      "ranges using a direct table")
+
 class NoncoherentXBar(BaseXBar):
     type = 'NoncoherentXBar'
     cxx_header = "mem/noncoherent_xbar.hh"
@@ -140,6 +147,13 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MB', "Maximum capacity of snoop filter")
 
+    # With a non-zero associativity the snoop filter only tracks
+    # max_capacity worth of lines, organised in sets, and evicting a line
+    # back-invalidates it in the caches above.
+    assoc = Param.Unsigned(0, "Associativity, 0 for an unbounded filter")
+    replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of the set-associative snoop filter")
+
 # We use a coherent crossbar to connect multiple requestors to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
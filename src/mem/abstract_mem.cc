@@ -49,6 +49,7 @@
 #include "cpu/thread_context.hh"
 #include "debug/LLSC.hh"
 #include "debug/MemoryAccess.hh"
+#include "mem/cache/compressors/base.hh"
 #include "mem/packet_access.hh"
 #include "sim/system.hh"
 
@@ -60,7 +61,7 @@ AbstractMemory::AbstractMemory(const Params *p) :
              (MemBackdoor::Flags)(MemBackdoor::Readable |
                                   MemBackdoor::Writeable)),
     confTableReported(p->conf_table_reported), inAddrMap(p->in_addr_map),
-    kvmMap(p->kvm_map), _system(NULL),
+    kvmMap(p->kvm_map), linkCompressor(p->link_compressor), _system(NULL),
     stats(*this)
 {
     panic_if(!range.valid() || !range.size(),
@@ -471,6 +472,25 @@ AbstractMemory::access(PacketPtr pkt)
     }
 }
 
+Tick
+AbstractMemory::compressForLink(PacketPtr pkt)
+{
+    if (!linkCompressor || !pkt->isResponse() || !pkt->hasData() ||
+        pkt->getSize() != linkCompressor->getBlockSize()) {
+        return 0;
+    }
+
+    Cycles comp_lat = Cycles(0);
+    Cycles decomp_lat = Cycles(0);
+    linkCompressor->compressForLink(pkt, comp_lat, decomp_lat);
+    pkt->decompressionDelay = cyclesToTicks(decomp_lat);
+
+    DPRINTF(MemoryAccess, "Read response to %#llx sent as %d bytes\n",
+            pkt->getAddr(), pkt->getLinkSize());
+
+    return cyclesToTicks(comp_lat);
+}
+
 void
 AbstractMemory::functionalAccess(PacketPtr pkt)
 {
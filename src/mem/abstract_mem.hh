@@ -55,6 +55,10 @@
 
 class System;
 
+namespace Compressor {
+    class Base;
+}
+
 /**
  * Locked address class that represents a physical address and a
  * context id.
@@ -123,6 +127,9 @@ class AbstractMemory : public ClockedObject
     // Should KVM map this memory for the guest
     const bool kvmMap;
 
+    // Compressor of the read responses sent over the memory fabric
+    Compressor::Base *linkCompressor;
+
     std::list<LockedAddr> lockedAddrList;
 
     // helper function for checkLockedAddrs(): we really want to
@@ -324,6 +331,16 @@ class AbstractMemory : public ClockedObject
      */
     void access(PacketPtr pkt);
 
+    /**
+     * Compress the data of a read response for its transfer over the
+     * memory fabric, if the memory has a link compressor. The receiver
+     * pays for the decompression.
+     *
+     * @param pkt The response
+     * @return The compression latency, in ticks
+     */
+    Tick compressForLink(PacketPtr pkt);
+
     /**
      * Perform an untimed memory read or write without changing
      * anything but the memory itself. No stats are affected by this
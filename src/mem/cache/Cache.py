@@ -42,6 +42,8 @@ from m5.SimObject import SimObject
 
 from m5.objects.ClockedObject import ClockedObject
 from m5.objects.Compressors import BaseCacheCompressor
+from m5.objects.DeadBlockPredictor import DeadBlockPredictor
+from m5.objects.EagerWriteback import EagerWriteback
 from m5.objects.Prefetcher import BasePrefetcher
 from m5.objects.ReplacementPolicies import *
 from m5.objects.Tags import *
@@ -103,10 +105,42 @@ class BaseCache(ClockedObject):
         "Replacement policy")
 
     compressor = Param.BaseCacheCompressor(NULL, "Cache compressor.")
+    # Link compression sends the data of the writebacks, and of the
+    # responses to the caches above, compressed, so that it takes fewer
+    # bytes on the crossbars and links. The link compressor is separate
+    # from the cache compressor, so that the stats of each tell the data
+    # transferred and the data stored apart
+    link_compressor = Param.BaseCacheCompressor(NULL,
+        "Compressor of the data sent over the memory fabric")
+
+    dead_block_predictor = Param.DeadBlockPredictor(NULL,
+        "Dead block predictor, to bypass dead fills and clean dead blocks")
+
+    eager_writeback = Param.EagerWriteback(NULL,
+        "Eager writeback of the dirty blocks whose DRAM row is open, for "
+        "a last-level cache")
 
     sequential_access = Param.Bool(False,
         "Whether to access tags and data sequentially")
 
+    way_prediction = Param.WayPrediction('none',
+        "Way predictor used to probe a single way first")
+    way_mispredict_penalty = Param.Cycles(1,
+        "Extra lookup latency when the predicted way does not hit")
+
+    tag_access_energy = Param.Float(0.0,
+        "Dynamic energy of reading one tag, in pJ")
+    data_access_energy = Param.Float(0.0,
+        "Dynamic energy of reading one data block, in pJ")
+
+    partitioning = Param.CachePartitioning('none',
+        "Whether the partitions are given ways")
+    partition_masks = VectorParam.UInt64([],
+        "Ways each partition can allocate in")
+    partition_requestors = VectorParam.String([],
+        "Space separated name prefixes of the requestors of each "
+        "partition; the other requestors are in partition 0")
+
     cpu_side = ResponsePort("Upstream port closer to the CPU and/or device")
     mem_side = RequestPort("Downstream port closer to memory")
 
@@ -0,0 +1,34 @@
+from m5.params import *
+from m5.proxy import *
+from m5.SimObject import SimObject
+
+# Sampling dead block predictor: a few sampled sets train tables of
+# counters indexed by hashes of the PC of the last access to a block. The
+# cache bypasses the fills predicted dead on arrival, and cleans the dirty
+# blocks predicted dead when it has nothing else to send
+class DeadBlockPredictor(SimObject):
+    type = 'DeadBlockPredictor'
+    cxx_header = "mem/cache/dead_block_predictor.hh"
+
+    bypass_fills = Param.Bool(True,
+        "Do not allocate the fills predicted to be dead on arrival")
+    clean_dead_blocks = Param.Bool(True,
+        "Write back the dirty blocks predicted dead while idle")
+
+    num_sampled_sets = Param.Unsigned(32, "Number of sampled sets")
+    sampler_assoc = Param.Unsigned(12, "Associativity of the sampler")
+    num_tables = Param.Unsigned(3, "Number of tables of counters")
+    table_size = Param.Unsigned(4096, "Number of counters per table")
+    counter_bits = Param.Unsigned(2, "Number of bits per counter")
+    threshold = Param.Unsigned(8,
+        "Sum of the counters from which a block is predicted dead")
+
+    bypass_history = Param.Unsigned(1024,
+        "Number of recent bypasses checked for reuse to measure accuracy")
+    dead_blocks = Param.Unsigned(64,
+        "Maximum number of blocks predicted dead waiting to be cleaned")
+
+    # Geometry of the cache, for the sampler to find the set of a block
+    size = Param.MemorySize(Parent.size, "Capacity of the cache")
+    assoc = Param.Int(Parent.assoc, "Associativity of the cache")
+    block_size = Param.Int(Parent.cache_line_size, "Block size in bytes")
@@ -0,0 +1,21 @@
+from m5.params import *
+from m5.SimObject import SimObject
+
+# Eager writeback for the last-level cache: while the cache has nothing
+# else to send, dirty blocks at the LRU end of their set are cleaned if
+# their DRAM row is open and the write queue of their controller is below
+# its low threshold, rather than written back in bursts on eviction
+class EagerWriteback(SimObject):
+    type = 'EagerWriteback'
+    cxx_header = "mem/cache/eager_writeback.hh"
+
+    mem_ctrls = VectorParam.MemCtrl(
+        "Controllers of the DRAM channels below the cache")
+
+    scan_sets = Param.Unsigned(4,
+        "Number of sets scanned each time the cache is idle")
+    lru_depth = Param.Unsigned(2,
+        "Number of blocks of a set, from its LRU end, that are scanned")
+    idle_interval = Param.Cycles(1000,
+        "Cycles between scans while the write queues are not low, or once "
+        "a sweep of the whole cache found nothing to clean")
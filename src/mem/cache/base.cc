@@ -81,7 +81,12 @@ BaseCache::BaseCache(const BaseCacheParams *p, unsigned blk_size)
       writeBuffer("write buffer", p->write_buffers, p->mshrs), // see below
       tags(p->tags),
       compressor(p->compressor),
+      linkCompressor(p->link_compressor),
+      partitioned(p->partitioning != CachePartitioning::none),
       prefetcher(p->prefetcher),
+      deadBlockPredictor(p->dead_block_predictor),
+      eagerWriteback(p->eager_writeback),
+      nextCleaningTick(0), nextEagerScanTick(0),
       writeAllocator(p->write_allocator),
       writebackClean(p->writeback_clean),
       tempBlockWriteback(nullptr),
@@ -222,6 +227,7 @@ BaseCache::handleTimingReqHit(PacketPtr pkt, CacheBlk *blk, Tick request_time)
         // lat, neglecting responseLatency, modelling hit latency
         // just as the value of lat overriden by access(), which calls
         // the calculateAccessLatency() function.
+        request_time += compressForLink(pkt);
         cpuSidePort.schedTimingResp(pkt, request_time);
     } else {
         DPRINTF(Cache, "%s satisfied %s, no response needed\n", __func__,
@@ -273,6 +279,12 @@ BaseCache::handleTimingReqMiss(PacketPtr pkt, MSHR *mshr, CacheBlk *blk,
                 assert(pkt->req->requestorId() < system->maxRequestors());
                 stats.cmdStats(pkt).mshr_hits[pkt->req->requestorId()]++;
 
+                // a demand access waiting for a prefetch in flight
+                if (prefetcher && mshr->fromPrefetcher() &&
+                    !pkt->cmd.isSWPrefetch()) {
+                    prefetcher->prefetchLate(pkt->getAddr());
+                }
+
                 // We use forward_time here because it is the same
                 // considering new targets. We have multiple
                 // requests for the same address here. It
@@ -384,6 +396,12 @@ BaseCache::recvTimingReq(PacketPtr pkt)
             schedMemSideSendEvent(next_pf_time);
         }
     }
+
+    if (deadBlockPredictor && deadBlockPredictor->hasDeadBlocks()) {
+        // the access may have predicted a block dead, to clean once
+        // there is nothing else to send
+        schedMemSideSendEvent(nextCleaningTime());
+    }
 }
 
 void
@@ -408,6 +426,10 @@ BaseCache::recvTimingResp(PacketPtr pkt)
     panic_if(pkt->headerDelay != 0 && pkt->cmd != MemCmd::HardPFResp,
              "%s saw a non-zero packet delay\n", name());
 
+    // compressed data is decompressed once its payload has arrived
+    pkt->payloadDelay += pkt->decompressionDelay;
+    pkt->decompressionDelay = 0;
+
     const bool is_error = pkt->isError();
 
     if (is_error) {
@@ -788,12 +810,83 @@ BaseCache::getNextQueueEntry()
         }
     }
 
+    // Nothing else to send, so clean a block predicted dead, or one that
+    // the DRAM can take cheaply, while the link is idle, rather than
+    // write it back when it is evicted
+    if (nextCleaningTime() > curTick()) {
+        return nullptr;
+    }
+
+    WriteQueueEntry *clean_entry = nullptr;
+    if (deadBlockPredictor) {
+        clean_entry = cleanDeadBlock();
+    }
+    if (!clean_entry && eagerWriteback &&
+        nextEagerScanTick <= curTick()) {
+        clean_entry = cleanEagerBlock();
+    }
+
+    if (clean_entry) {
+        nextCleaningTick = clockEdge(Cycles(1));
+    }
+
+    return clean_entry;
+}
+
+WriteQueueEntry*
+BaseCache::cleanDeadBlock()
+{
+    Addr blk_addr;
+    bool is_secure;
+    while (deadBlockPredictor->nextDeadBlock(blk_addr, is_secure)) {
+        CacheBlk *blk = tags->findBlock(blk_addr, is_secure);
+        if (!blk || !blk->isDirty() ||
+            mshrQueue.findMatch(blk_addr, is_secure)) {
+            continue;
+        }
+
+        DPRINTF(Cache, "Cleaning dead block %s\n", blk->print());
+        deadBlockPredictor->deadBlockCleaned();
+
+        return cleanBlock(blk);
+    }
+
     return nullptr;
 }
 
+WriteQueueEntry*
+BaseCache::cleanEagerBlock()
+{
+    CacheBlk *blk = nullptr;
+    if (eagerWriteback->writeQueuesLow()) {
+        blk = eagerWriteback->findBlock(*tags);
+    }
+    if (!blk || mshrQueue.findMatch(regenerateBlkAddr(blk),
+                                    blk->isSecure())) {
+        nextEagerScanTick = clockEdge(eagerWriteback->retryDelay());
+        return nullptr;
+    }
+
+    DPRINTF(Cache, "Eagerly cleaning block %s\n", blk->print());
+    eagerWriteback->blockCleaned();
+
+    return cleanBlock(blk);
+}
+
+WriteQueueEntry*
+BaseCache::cleanBlock(CacheBlk *blk)
+{
+    PacketList writebacks;
+    writebacks.push_back(writecleanBlk(blk, Request::Flags(), 0));
+    doWritebacks(writebacks, curTick());
+
+    // the entry is not ready yet if the block must be decompressed
+    return writeBuffer.getNext();
+}
+
 bool
 BaseCache::handleEvictions(std::vector<CacheBlk*> &evict_blks,
-    PacketList &writebacks)
+    PacketList &writebacks, bool by_prefetch)
 {
     bool replacement = false;
     for (const auto& blk : evict_blks) {
@@ -820,6 +913,10 @@ BaseCache::handleEvictions(std::vector<CacheBlk*> &evict_blks,
         // Evict valid blocks associated to this victim block
         for (auto& blk : evict_blks) {
             if (blk->isValid()) {
+                if (prefetcher) {
+                    prefetcher->notifyEviction(regenerateBlkAddr(blk),
+                                               by_prefetch);
+                }
                 evictBlock(blk, writebacks);
             }
         }
@@ -1039,11 +1136,16 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
 
     // Access block in the tags
     Cycles tag_latency(0);
-    blk = tags->accessBlock(pkt->getAddr(), pkt->isSecure(), tag_latency);
+    blk = tags->accessBlock(pkt, tag_latency);
 
     DPRINTF(Cache, "%s for %s %s\n", __func__, pkt->print(),
             blk ? "hit " + blk->print() : "miss");
 
+    if (deadBlockPredictor && !pkt->isEviction() &&
+        !pkt->req->isCacheMaintenance()) {
+        deadBlockPredictor->access(pkt, blk != nullptr);
+    }
+
     if (pkt->req->isCacheMaintenance()) {
         // A cache maintenance operation is always forwarded to the
         // memory below even if the block is found in dirty state.
@@ -1321,6 +1423,12 @@ BaseCache::handleFill(PacketPtr pkt, CacheBlk *blk, PacketList &writebacks,
         // better have read new data...
         assert(pkt->hasData() || pkt->cmd == MemCmd::InvalidateResp);
 
+        // fills predicted to be dead on arrival are not worth a block
+        if (allocate && deadBlockPredictor &&
+            deadBlockPredictor->bypass(pkt)) {
+            allocate = false;
+        }
+
         // need to do a replacement if allocating, otherwise we stick
         // with the temporary storage
         blk = allocate ? allocateBlock(pkt, writebacks) : nullptr;
@@ -1429,9 +1537,10 @@ BaseCache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
     // Find replacement victim
     std::vector<CacheBlk*> evict_blks;
     CacheBlk *victim = tags->findVictim(addr, is_secure, blk_size_bits,
-                                        evict_blks);
+                                        evict_blks, tags->partitionOf(pkt));
 
-    // It is valid to return nullptr if there is no victim
+    // It is valid to return nullptr if there is no victim, e.g., when the
+    // partition of the requestor is given none of the ways
     if (!victim)
         return nullptr;
 
@@ -1439,7 +1548,8 @@ BaseCache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
     DPRINTF(CacheRepl, "Replacement victim: %s\n", victim->print());
 
     // Try to evict blocks; if it fails, give up on allocation
-    if (!handleEvictions(evict_blks, writebacks)) {
+    if (!handleEvictions(evict_blks, writebacks,
+                         pkt->cmd == MemCmd::HardPFResp)) {
         return nullptr;
     }
 
@@ -1482,6 +1592,13 @@ BaseCache::evictBlock(CacheBlk *blk, PacketList &writebacks)
     }
 }
 
+RequestorID
+BaseCache::evictionRequestorId(const CacheBlk *blk) const
+{
+    return partitioned && blk->srcRequestorId != Request::invldRequestorId ?
+        blk->srcRequestorId : Request::wbRequestorId;
+}
+
 PacketPtr
 BaseCache::writebackBlk(CacheBlk *blk)
 {
@@ -1491,8 +1608,8 @@ BaseCache::writebackBlk(CacheBlk *blk)
 
     stats.writebacks[Request::wbRequestorId]++;
 
-    RequestPtr req = std::make_shared<Request>(
-        regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
+    RequestPtr req = makeRequest(
+        regenerateBlkAddr(blk), blkSize, 0, evictionRequestorId(blk));
 
     if (blk->isSecure())
         req->setFlags(Request::SECURE);
@@ -1522,10 +1639,12 @@ BaseCache::writebackBlk(CacheBlk *blk)
     pkt->setDataFromBlock(blk->data, blkSize);
 
     // When a block is compressed, it must first be decompressed before being
-    // sent for writeback.
+    // sent for writeback, and then compressed again if it is sent
+    // compressed.
     if (compressor) {
         pkt->payloadDelay = compressor->getDecompressionLatency(blk);
     }
+    pkt->payloadDelay += compressForLink(pkt);
 
     return pkt;
 }
@@ -1533,8 +1652,8 @@ BaseCache::writebackBlk(CacheBlk *blk)
 PacketPtr
 BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
 {
-    RequestPtr req = std::make_shared<Request>(
-        regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
+    RequestPtr req = makeRequest(
+        regenerateBlkAddr(blk), blkSize, 0, evictionRequestorId(blk));
 
     if (blk->isSecure()) {
         req->setFlags(Request::SECURE);
@@ -1567,14 +1686,33 @@ BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
     pkt->setDataFromBlock(blk->data, blkSize);
 
     // When a block is compressed, it must first be decompressed before being
-    // sent for writeback.
+    // sent for writeback, and then compressed again if it is sent
+    // compressed.
     if (compressor) {
         pkt->payloadDelay = compressor->getDecompressionLatency(blk);
     }
+    pkt->payloadDelay += compressForLink(pkt);
 
     return pkt;
 }
 
+Tick
+BaseCache::compressForLink(PacketPtr pkt)
+{
+    if (!linkCompressor || !pkt->hasData() || pkt->getSize() != blkSize) {
+        return 0;
+    }
+
+    Cycles compression_lat = Cycles(0);
+    Cycles decompression_lat = Cycles(0);
+    linkCompressor->compressForLink(pkt, compression_lat, decompression_lat);
+    pkt->decompressionDelay = cyclesToTicks(decompression_lat);
+
+    DPRINTF(Cache, "%s: %s sent as %d bytes\n", __func__, pkt->print(),
+            pkt->getLinkSize());
+
+    return cyclesToTicks(compression_lat);
+}
 
 void
 BaseCache::memWriteback()
@@ -1606,7 +1744,7 @@ BaseCache::writebackVisitor(CacheBlk &blk)
     if (blk.isDirty()) {
         assert(blk.isValid());
 
-        RequestPtr request = std::make_shared<Request>(
+        RequestPtr request = makeRequest(
             regenerateBlkAddr(&blk), blkSize, 0, Request::funcRequestorId);
 
         request->taskId(blk.task_id);
@@ -1636,6 +1774,26 @@ BaseCache::invalidateVisitor(CacheBlk &blk)
     }
 }
 
+Tick
+BaseCache::nextCleaningTime() const
+{
+    if (isReadOnly || !writeBuffer.isEmpty()) {
+        return MaxTick;
+    }
+
+    Tick next_clean = MaxTick;
+    if (deadBlockPredictor && deadBlockPredictor->hasDeadBlocks()) {
+        next_clean = nextCleaningTick;
+    }
+    if (eagerWriteback) {
+        next_clean = std::min(next_clean,
+                              std::max(nextCleaningTick, nextEagerScanTick));
+    }
+
+    return next_clean == MaxTick ? MaxTick :
+        std::max(next_clean, curTick());
+}
+
 Tick
 BaseCache::nextQueueReadyTime() const
 {
@@ -1649,6 +1807,10 @@ BaseCache::nextQueueReadyTime() const
                              prefetcher->nextPrefetchReadyTime());
     }
 
+    // The cleaning engines are ready once the write buffer drains, and
+    // the port is rescheduled whenever it does
+    nextReady = std::min(nextReady, nextCleaningTime());
+
     return nextReady;
 }
 
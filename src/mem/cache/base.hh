@@ -59,6 +59,8 @@
 #include "enums/Clusivity.hh"
 #include "mem/cache/cache_blk.hh"
 #include "mem/cache/compressors/base.hh"
+#include "mem/cache/dead_block_predictor.hh"
+#include "mem/cache/eager_writeback.hh"
 #include "mem/cache/mshr_queue.hh"
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/write_queue.hh"
@@ -322,9 +324,40 @@ class BaseCache : public ClockedObject
     /** Compression method being used. */
     Compressor::Base* compressor;
 
+    /**
+     * Compressor of the data of the writebacks, and of the responses to
+     * the caches above, so that it takes fewer bytes on the crossbars and
+     * links, if any.
+     */
+    Compressor::Base* linkCompressor;
+
+    /**
+     * Whether the tags are partitioned, in which case the evictions are
+     * made for the requestors that brought the blocks in.
+     */
+    const bool partitioned;
+
     /** Prefetcher */
     Prefetcher::Base *prefetcher;
 
+    /** Dead block predictor */
+    DeadBlockPredictor *deadBlockPredictor;
+
+    /** Eager writeback engine */
+    EagerWriteback *eagerWriteback;
+
+    /**
+     * Tick from which the idle cache may clean its next block, so that
+     * the cleaning engines clean at most one block a cycle.
+     */
+    Tick nextCleaningTick;
+
+    /**
+     * Tick from which the eager writeback engine may scan the cache
+     * again, after a scan that found nothing to clean.
+     */
+    Tick nextEagerScanTick;
+
     /** To probe when a cache hit occurs */
     ProbePointArg<PacketPtr> *ppHit;
 
@@ -587,6 +620,41 @@ class BaseCache : public ClockedObject
      */
     QueueEntry* getNextQueueEntry();
 
+    /**
+     * Write back a dirty block that the dead block predictor expects not
+     * to be accessed again, keeping a clean copy of it, so that the link
+     * below is used while idle rather than when the block is evicted.
+     *
+     * @return The write buffer entry of the block, if one was cleaned.
+     */
+    WriteQueueEntry* cleanDeadBlock();
+
+    /**
+     * Write back a dirty block at the LRU end of its set whose DRAM row
+     * is open, keeping a clean copy of it, while the write queue of the
+     * memory controller is low.
+     *
+     * @return The write buffer entry of the block, if one was cleaned.
+     */
+    WriteQueueEntry* cleanEagerBlock();
+
+    /**
+     * Write back a dirty block while the cache is idle, keeping a clean
+     * copy of it.
+     *
+     * @param blk The block to clean.
+     * @return The write buffer entry of the block.
+     */
+    WriteQueueEntry* cleanBlock(CacheBlk *blk);
+
+    /**
+     * Find the time at which the cleaning engines may clean a block,
+     * which is only while the write buffer is empty.
+     *
+     * @return The tick, or MaxTick if there is nothing to clean.
+     */
+    Tick nextCleaningTime() const;
+
     /**
      * Insert writebacks into the write buffer
      */
@@ -712,10 +780,11 @@ class BaseCache : public ClockedObject
      *
      * @param evict_blks Blocks marked for eviction.
      * @param writebacks List for any writebacks that need to be performed.
+     * @param by_prefetch Whether the blocks make room for a prefetch.
      * @return False if any of the evicted blocks is in transient state.
      */
     bool handleEvictions(std::vector<CacheBlk*> &evict_blks,
-        PacketList &writebacks);
+        PacketList &writebacks, bool by_prefetch = false);
 
     /**
      * Handle a fill operation caused by a received packet.
@@ -778,6 +847,19 @@ class BaseCache : public ClockedObject
      */
     void invalidateBlock(CacheBlk *blk);
 
+    /**
+     * Get the requestor that a request evicting a block is made for.
+     * When the cache is partitioned, this is the requestor that brought
+     * the block in, so that the caches below attribute the block to it,
+     * e.g. to allocate it in its partition. Otherwise, and for blocks
+     * without a known requestor, the eviction is attributed to the
+     * writebacks.
+     *
+     * @param blk The block that is evicted.
+     * @return The requestor of the eviction request.
+     */
+    RequestorID evictionRequestorId(const CacheBlk *blk) const;
+
     /**
      * Create a writeback request for the given block.
      *
@@ -799,6 +881,16 @@ class BaseCache : public ClockedObject
      */
     PacketPtr writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id);
 
+    /**
+     * Compress the data of an outgoing packet with the link compressor,
+     * if any. Only packets with the data of a whole block are
+     * compressed, and the receiver pays for the decompression.
+     *
+     * @param pkt The outgoing packet.
+     * @return The compression latency, in ticks.
+     */
+    Tick compressForLink(PacketPtr pkt);
+
     /**
      * Write back dirty blocks in the cache using functional accesses.
      */
@@ -1221,6 +1313,7 @@ class BaseCache : public ClockedObject
     {
         assert(pkt->req->requestorId() < system->maxRequestors());
         stats.cmdStats(pkt).misses[pkt->req->requestorId()]++;
+        tags->recordPartitionAccess(pkt, false);
         pkt->req->incAccessDepth();
         if (missCount) {
             --missCount;
@@ -1232,6 +1325,7 @@ class BaseCache : public ClockedObject
     {
         assert(pkt->req->requestorId() < system->maxRequestors());
         stats.cmdStats(pkt).hits[pkt->req->requestorId()]++;
+        tags->recordPartitionAccess(pkt, true);
     }
 
     /**
@@ -370,7 +370,7 @@ Cache::handleTimingReqMiss(PacketPtr pkt, CacheBlk *blk, Tick forward_time,
 
         if (!mshr) {
             // copy the request and create a new SoftPFReq packet
-            RequestPtr req = std::make_shared<Request>(pkt->req->getPaddr(),
+            RequestPtr req = makeRequest(pkt->req->getPaddr(),
                                                     pkt->req->getSize(),
                                                     pkt->req->getFlags(),
                                                     pkt->req->requestorId());
@@ -844,6 +844,7 @@ Cache::serviceMSHRTargets(MSHR *mshr, const PacketPtr pkt, CacheBlk *blk)
             }
             // Reset the bus additional time as it is now accounted for
             tgt_pkt->headerDelay = tgt_pkt->payloadDelay = 0;
+            completion_time += compressForLink(tgt_pkt);
             cpuSidePort.schedTimingResp(tgt_pkt, completion_time);
             break;
 
@@ -911,8 +912,8 @@ Cache::cleanEvictBlk(CacheBlk *blk)
     assert(blk && blk->isValid() && !blk->isDirty());
 
     // Creating a zero sized write, a message to the snoop filter
-    RequestPtr req = std::make_shared<Request>(
-        regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
+    RequestPtr req = makeRequest(
+        regenerateBlkAddr(blk), blkSize, 0, evictionRequestorId(blk));
 
     if (blk->isSecure())
         req->setFlags(Request::SECURE);
@@ -1266,7 +1267,7 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
         // state to determine if it is dirty and writable, we use the
         // command and fields of the writeback packet
         bool respond = wb_pkt->cmd == MemCmd::WritebackDirty &&
-            pkt->needsResponse();
+            pkt->needsResponse() && !pkt->req->isBackInvalidate();
         bool have_writable = !wb_pkt->hasSharers();
         bool invalidate = pkt->isInvalidate();
 
@@ -1287,6 +1288,16 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
                                    false, false);
         }
 
+        if (pkt->req->isBackInvalidate() &&
+            wb_pkt->cmd == MemCmd::WritebackDirty) {
+            // a snoop filter evicted the line and nobody takes the
+            // data from a response, so the dirty data still goes
+            // down, but as a WriteClean, as the snoop filter no
+            // longer tracks the line and does not expect a writeback
+            // for it
+            wb_pkt->cmd = MemCmd::WriteClean;
+        }
+
         if (invalidate && wb_pkt->cmd != MemCmd::WriteClean) {
             // Invalidation trumps our writeback... discard here
             // Note: markInService will remove entry from writeback buffer.
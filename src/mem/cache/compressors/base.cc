@@ -38,6 +38,7 @@
 #include <cstdint>
 #include <string>
 
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/CacheComp.hh"
 #include "mem/cache/tags/super_blk.hh"
@@ -93,10 +94,15 @@ Base::toChunks(const uint64_t* data) const
     const unsigned num_chunks_per_64 =
         (sizeof(uint64_t) * CHAR_BIT) / chunkSizeBits;
 
+    // Chunks of 64 bits are the data itself
+    if (num_chunks_per_64 == 1) {
+        return std::vector<Chunk>(data, data + blkSize / sizeof(uint64_t));
+    }
+
     // Turn a 64-bit array into a chunkSizeBits-array
     std::vector<Chunk> chunks((blkSize * CHAR_BIT) / chunkSizeBits, 0);
     for (int i = 0; i < chunks.size(); i++) {
-        const int index_64 = std::floor(i / (double)num_chunks_per_64);
+        const int index_64 = i / num_chunks_per_64;
         const unsigned start = i % num_chunks_per_64;
         chunks[i] = bits(data[index_64],
             (start + 1) * chunkSizeBits - 1, start * chunkSizeBits);
@@ -112,10 +118,16 @@ Base::fromChunks(const std::vector<Chunk>& chunks, uint64_t* data) const
     const unsigned num_chunks_per_64 =
         (sizeof(uint64_t) * CHAR_BIT) / chunkSizeBits;
 
+    // Chunks of 64 bits are the data itself
+    if (num_chunks_per_64 == 1) {
+        std::copy(chunks.begin(), chunks.end(), data);
+        return;
+    }
+
     // Turn a chunkSizeBits-array into a 64-bit array
     std::memset(data, 0, blkSize);
     for (int i = 0; i < chunks.size(); i++) {
-        const int index_64 = std::floor(i / (double)num_chunks_per_64);
+        const int index_64 = i / num_chunks_per_64;
         const unsigned start = i % num_chunks_per_64;
         replaceBits(data[index_64], (start + 1) * chunkSizeBits - 1,
             start * chunkSizeBits, chunks[i]);
@@ -168,6 +180,23 @@ Base::compress(const uint64_t* data, Cycles& comp_lat, Cycles& decomp_lat)
     return comp_data;
 }
 
+void
+Base::compressForLink(PacketPtr pkt, Cycles& comp_lat, Cycles& decomp_lat)
+{
+    assert(pkt->hasData() && pkt->getSize() == blkSize);
+
+    const std::size_t comp_size_bits =
+        compress(pkt->getConstPtr<uint64_t>(), comp_lat,
+                 decomp_lat)->getSizeBits();
+
+    if (comp_size_bits < blkSize * CHAR_BIT) {
+        pkt->setCompressedSize(divCeil(comp_size_bits, CHAR_BIT));
+    } else {
+        pkt->setCompressedSize(0);
+        decomp_lat = Cycles(0);
+    }
+}
+
 Cycles
 Base::getDecompressionLatency(const CacheBlk* blk)
 {
@@ -40,6 +40,7 @@
 
 #include "base/statistics.hh"
 #include "base/types.hh"
+#include "mem/packet.hh"
 #include "sim/sim_object.hh"
 
 class CacheBlk;
@@ -181,6 +182,21 @@ class Base : public SimObject
     std::unique_ptr<CompressionData>
     compress(const uint64_t* data, Cycles& comp_lat, Cycles& decomp_lat);
 
+    /**
+     * Compress the data of a packet for its transfer over the memory
+     * fabric, and record its compressed size in the packet. Data that
+     * does not compress below the size threshold is sent uncompressed,
+     * and needs no decompression.
+     *
+     * @param pkt The packet, with the data of a whole cache line.
+     * @param comp_lat Compression latency in number of cycles.
+     * @param decomp_lat Decompression latency in number of cycles.
+     */
+    void compressForLink(PacketPtr pkt, Cycles& comp_lat, Cycles& decomp_lat);
+
+    /** Get the size of the cache lines, in bytes. */
+    std::size_t getBlockSize() const { return blkSize; }
+
     /**
      * Get the decompression latency if the block is compressed. Latency is 0
      * otherwise.
@@ -101,6 +101,9 @@ class BaseDelta : public DictionaryCompressor<BaseType>
         return PatternFactory::getPattern(bytes, dict_bytes, match_location);
     }
 
+    std::unique_ptr<typename DictionaryCompressor<BaseType>::Pattern>
+    findPattern(const DictionaryEntry& bytes) const override;
+
     std::string
     getName(int number) const override
     {
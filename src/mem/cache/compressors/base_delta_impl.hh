@@ -33,9 +33,11 @@
 #ifndef __MEM_CACHE_COMPRESSORS_BASE_DELTA_IMPL_HH__
 #define __MEM_CACHE_COMPRESSORS_BASE_DELTA_IMPL_HH__
 
+#include "base/bitfield.hh"
 #include "debug/CacheComp.hh"
 #include "mem/cache/compressors/base_delta.hh"
 #include "mem/cache/compressors/dictionary_compressor_impl.hh"
+#include "mem/cache/compressors/simd.hh"
 
 namespace Compressor {
 
@@ -65,6 +67,26 @@ BaseDelta<BaseType, DeltaSizeBits>::addToDictionary(DictionaryEntry data)
         DictionaryCompressor<BaseType>::numEntries++] = data;
 }
 
+template <class BaseType, std::size_t DeltaSizeBits>
+std::unique_ptr<typename DictionaryCompressor<BaseType>::Pattern>
+BaseDelta<BaseType, DeltaSizeBits>::findPattern(
+    const DictionaryEntry& bytes) const
+{
+    // A delta is always smaller than an uncompressed value, so the best
+    // pattern uses the first base that is close enough to the value
+    const BaseType limit = DeltaSizeBits ? mask(DeltaSizeBits - 1) : 0;
+    const int location = SIMD::findDeltaMatch(
+        DictionaryCompressor<BaseType>::dictionaryData(),
+        DictionaryCompressor<BaseType>::numEntries,
+        DictionaryCompressor<BaseType>::fromDictionaryEntry(bytes), limit);
+    if (location >= 0) {
+        return std::unique_ptr<typename DictionaryCompressor<BaseType>::
+            Pattern>(new PatternM(bytes, location));
+    }
+    return std::unique_ptr<typename DictionaryCompressor<BaseType>::Pattern>(
+        new PatternX(bytes, -1));
+}
+
 template <class BaseType, std::size_t DeltaSizeBits>
 std::unique_ptr<Base::CompressionData>
 BaseDelta<BaseType, DeltaSizeBits>::compress(
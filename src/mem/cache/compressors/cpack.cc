@@ -33,6 +33,7 @@
 #include "mem/cache/compressors/cpack.hh"
 
 #include "mem/cache/compressors/dictionary_compressor_impl.hh"
+#include "mem/cache/compressors/simd.hh"
 #include "params/CPack.hh"
 
 namespace Compressor {
@@ -49,6 +50,40 @@ CPack::addToDictionary(DictionaryEntry data)
     dictionary[numEntries++] = data;
 }
 
+std::unique_ptr<DictionaryCompressor<uint32_t>::Pattern>
+CPack::findPattern(const DictionaryEntry& bytes) const
+{
+    // The patterns of the factory are strictly sorted by size, so the best
+    // pattern is the first one that matches any dictionary entry, and it
+    // is given the first entry it matches. The value patterns do not use
+    // the dictionary and keep the negative match location
+    const uint32_t value = fromDictionaryEntry(bytes);
+    const uint8_t* entries = dictionaryData();
+    int location;
+    if (value == 0) {
+        return std::unique_ptr<Pattern>(new PatternZZZZ(bytes, -1));
+    }
+    location = SIMD::findMaskedMatch(entries, numEntries, value,
+                                     uint32_t(0xFFFFFFFF));
+    if (location >= 0) {
+        return std::unique_ptr<Pattern>(new PatternMMMM(bytes, location));
+    }
+    if ((value & 0xFFFFFF00) == 0) {
+        return std::unique_ptr<Pattern>(new PatternZZZX(bytes, -1));
+    }
+    location = SIMD::findMaskedMatch(entries, numEntries, value,
+                                     uint32_t(0xFFFFFF00));
+    if (location >= 0) {
+        return std::unique_ptr<Pattern>(new PatternMMMX(bytes, location));
+    }
+    location = SIMD::findMaskedMatch(entries, numEntries, value,
+                                     uint32_t(0xFFFF0000));
+    if (location >= 0) {
+        return std::unique_ptr<Pattern>(new PatternMMXX(bytes, location));
+    }
+    return std::unique_ptr<Pattern>(new PatternXXXX(bytes, -1));
+}
+
 std::unique_ptr<Base::CompressionData>
 CPack::compress(const std::vector<Chunk>& chunks,
     Cycles& comp_lat, Cycles& decomp_lat)
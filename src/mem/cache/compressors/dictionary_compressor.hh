@@ -195,6 +195,33 @@ class DictionaryCompressor : public BaseDictionaryCompressor
     getPattern(const DictionaryEntry& bytes, const DictionaryEntry& dict_bytes,
         const int match_location) const = 0;
 
+    /**
+     * Find the pattern that compresses a value the most. By default every
+     * dictionary entry is tried with getPattern(), and the first of the
+     * smallest patterns is kept. Compressors whose patterns allow it find
+     * the same pattern with a direct search of the dictionary instead,
+     * without instantiating the other candidates.
+     *
+     * @param bytes The value to be compressed.
+     * @return The best pattern for the value.
+     */
+    virtual std::unique_ptr<Pattern>
+    findPattern(const DictionaryEntry& bytes) const;
+
+    /**
+     * Get the dictionary as consecutive little-endian entries, to be
+     * searched with the vector kernels.
+     *
+     * @return The bytes of the first dictionary entry.
+     */
+    const uint8_t*
+    dictionaryData() const
+    {
+        static_assert(sizeof(DictionaryEntry) == sizeof(T),
+            "Dictionary entries must not be padded.");
+        return dictionary.front().data();
+    }
+
     /**
      * Compress data.
      *
@@ -52,6 +52,16 @@ RepeatedQwords::addToDictionary(DictionaryEntry data)
     dictionary[numEntries++] = data;
 }
 
+std::unique_ptr<DictionaryCompressor<uint64_t>::Pattern>
+RepeatedQwords::findPattern(const DictionaryEntry& bytes) const
+{
+    // Only the first dictionary entry can be matched
+    if ((numEntries > 0) && (bytes == dictionary[0])) {
+        return getPattern(bytes, dictionary[0], 0);
+    }
+    return getPattern(bytes, toDictionaryEntry(0), -1);
+}
+
 std::unique_ptr<Base::CompressionData>
 RepeatedQwords::compress(const std::vector<Chunk>& chunks,
     Cycles& comp_lat, Cycles& decomp_lat)
@@ -0,0 +1,186 @@
+/**
+ * @file
+ * Microbenchmark of the dictionary searches, comparing the scalar search
+ * with the one the compressors use, which is vectorized for the targets
+ * the build enables.
+ *
+ * Every line of a memory image is used as a dictionary, and the values
+ * of the next line are searched for in it, as the compressors do with
+ * the values they have seen. The image is a raw memory dump given in
+ * the GEM5_SIMD_BENCH_IMAGE environment variable, e.g., a decompressed
+ * physical memory checkpoint, or else a generated one.
+ *
+ * This is a standalone program rather than a unit test, as its timings
+ * depend on the host; the unit tests check that the searches agree.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "mem/cache/compressors/simd.hh"
+
+using namespace Compressor;
+
+namespace {
+
+const std::size_t lineSize = 64;
+
+/** Number of searches over the whole image that are timed. */
+const int rounds = 4;
+
+/**
+ * Get the memory image, which is generated with zeros, small integers,
+ * pointers and random data when no image is given.
+ */
+const std::vector<uint8_t> &
+memoryImage()
+{
+    static std::vector<uint8_t> image;
+    if (!image.empty()) {
+        return image;
+    }
+
+    const char *path = std::getenv("GEM5_SIMD_BENCH_IMAGE");
+    if (path) {
+        std::ifstream file(path, std::ios::binary);
+        image.assign(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+        image.resize(image.size() / lineSize * lineSize);
+    }
+
+    if (image.size() < 2 * lineSize) {
+        std::mt19937_64 rng(0);
+        image.resize(1 << 22);
+        for (std::size_t i = 0; i < image.size(); i += sizeof(uint64_t)) {
+            uint64_t value;
+            switch (rng() % 4) {
+              case 0:
+                value = 0;
+                break;
+              case 1:
+                value = static_cast<int8_t>(rng());
+                break;
+              case 2:
+                value = 0x00007f3a12c40000 + (rng() % 4096) * 8;
+                break;
+              default:
+                value = rng();
+            }
+            for (std::size_t j = 0; j < sizeof(uint64_t); j++) {
+                image[i + j] = value >> (8 * j);
+            }
+        }
+    }
+    return image;
+}
+
+/**
+ * Time a search over the image.
+ *
+ * @param search The search, called with the dictionary and the value.
+ * @param checksum Sum of the indices found, which the searches compared
+ *                 must agree on.
+ * @return Nanoseconds per search.
+ */
+template <class T, class Search>
+double
+timeSearch(Search search, int64_t &checksum)
+{
+    const std::vector<uint8_t> &image = memoryImage();
+    const std::size_t entries = lineSize / sizeof(T);
+
+    checksum = 0;
+    uint64_t searches = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (std::size_t line = 0; line + 2 * lineSize <= image.size();
+             line += lineSize) {
+            const uint8_t *dict = image.data() + line;
+            for (std::size_t i = 0; i < entries; i++) {
+                checksum += search(dict, entries,
+                    SIMD::loadEntry<T>(dict + lineSize + i * sizeof(T)));
+                searches++;
+            }
+        }
+    }
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / searches;
+}
+
+/**
+ * Report the timings of the searches, and fail if they did not find the
+ * same entries.
+ */
+void
+report(const char *name, double scalar_ns, double simd_ns,
+       int64_t scalar_sum, int64_t simd_sum)
+{
+    if (scalar_sum != simd_sum) {
+        std::cerr << name << ": the scalar and simd searches differ"
+                  << std::endl;
+        std::exit(1);
+    }
+    std::cout << name << ": scalar " << scalar_ns << " ns, simd "
+              << simd_ns << " ns per search, speedup "
+              << scalar_ns / simd_ns << std::endl;
+}
+
+template <class T>
+void
+benchMaskedMatch(const char *name, T mask)
+{
+    int64_t scalar_sum, simd_sum;
+    const double scalar_ns = timeSearch<T>(
+        [mask](const uint8_t *dict, std::size_t n, T value) {
+            return SIMD::findMaskedMatchScalar(dict, n, value, mask);
+        }, scalar_sum);
+    const double simd_ns = timeSearch<T>(
+        [mask](const uint8_t *dict, std::size_t n, T value) {
+            return SIMD::findMaskedMatch(dict, n, value, mask);
+        }, simd_sum);
+    report(name, scalar_ns, simd_ns, scalar_sum, simd_sum);
+}
+
+template <class T>
+void
+benchDeltaMatch(const char *name, T limit)
+{
+    int64_t scalar_sum, simd_sum;
+    const double scalar_ns = timeSearch<T>(
+        [limit](const uint8_t *dict, std::size_t n, T value) {
+            return SIMD::findDeltaMatchScalar(dict, n, value, limit);
+        }, scalar_sum);
+    const double simd_ns = timeSearch<T>(
+        [limit](const uint8_t *dict, std::size_t n, T value) {
+            return SIMD::findDeltaMatch(dict, n, value, limit);
+        }, simd_sum);
+    report(name, scalar_ns, simd_ns, scalar_sum, simd_sum);
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    // The masked searches of CPack, with the masks of its patterns
+    benchMaskedMatch<uint32_t>("MaskedMatch32 (full)", 0xFFFFFFFF);
+    benchMaskedMatch<uint32_t>("MaskedMatch32 (3 bytes)", 0xFFFFFF00);
+    benchMaskedMatch<uint32_t>("MaskedMatch32 (2 bytes)", 0xFFFF0000);
+    benchMaskedMatch<uint64_t>("MaskedMatch64", 0xFFFFFFFFFFFFFFFF);
+
+    // The delta searches of BDI, with the limits of its deltas
+    benchDeltaMatch<uint16_t>("DeltaMatch16 (1 byte)", 0x7F);
+    benchDeltaMatch<uint32_t>("DeltaMatch32 (1 byte)", 0x7F);
+    benchDeltaMatch<uint32_t>("DeltaMatch32 (2 bytes)", 0x7FFF);
+    benchDeltaMatch<uint64_t>("DeltaMatch64 (1 byte)", 0x7F);
+    benchDeltaMatch<uint64_t>("DeltaMatch64 (2 bytes)", 0x7FFF);
+    benchDeltaMatch<uint64_t>("DeltaMatch64 (4 bytes)", 0x7FFFFFFF);
+
+    return 0;
+}
@@ -0,0 +1,425 @@
+/**
+ * @file
+ * Vectorized searches over the dictionaries of the compressors.
+ *
+ * A dictionary is an array of little-endian entries of 16, 32 or 64 bits.
+ * The searches return the index of the first entry that matches a value,
+ * or -1 if there is none. They compare several entries at a time with
+ * AVX2 or SSE2 when the compiler targets them (e.g., -mavx2 or
+ * -march=native), and fall back to a scalar loop for the remaining
+ * entries and on other hosts. Every version returns the same index.
+ */
+
+#ifndef __MEM_CACHE_COMPRESSORS_SIMD_HH__
+#define __MEM_CACHE_COMPRESSORS_SIMD_HH__
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "base/bitfield.hh"
+
+namespace Compressor {
+namespace SIMD {
+
+/**
+ * Read a dictionary entry.
+ *
+ * @param entry The little-endian bytes of the entry.
+ * @return The value of the entry.
+ */
+template <class T>
+inline T
+loadEntry(const uint8_t* entry)
+{
+    T value = 0;
+    for (int i = sizeof(T) - 1; i >= 0; i--) {
+        value = (value << 8) | entry[i];
+    }
+    return value;
+}
+
+/**
+ * Scalar search for the first entry whose masked bits are equal to the
+ * masked value.
+ *
+ * @param entries The dictionary entries.
+ * @param num_entries Number of valid entries.
+ * @param value The value to be matched.
+ * @param mask The bits that must match.
+ * @param start Index of the first entry to check.
+ * @return The index of the matching entry, or -1.
+ */
+template <class T>
+inline int
+findMaskedMatchScalar(const uint8_t* entries, std::size_t num_entries,
+    T value, T mask, std::size_t start = 0)
+{
+    for (std::size_t i = start; i < num_entries; i++) {
+        if (((loadEntry<T>(entries + i * sizeof(T)) ^ value) & mask) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Scalar search for the first base the value is at most limit away from,
+ * using wrapping signed deltas.
+ *
+ * @param entries The dictionary entries, i.e., the bases.
+ * @param num_entries Number of valid entries.
+ * @param value The value to be matched.
+ * @param limit The largest absolute delta.
+ * @param start Index of the first entry to check.
+ * @return The index of the matching entry, or -1.
+ */
+template <class T>
+inline int
+findDeltaMatchScalar(const uint8_t* entries, std::size_t num_entries,
+    T value, T limit, std::size_t start = 0)
+{
+    // The signed delta is in [-limit, limit] if and only if adding limit
+    // to it gives an unsigned value that is not greater than twice limit
+    for (std::size_t i = start; i < num_entries; i++) {
+        const T base = loadEntry<T>(entries + i * sizeof(T));
+        if (static_cast<T>(value - base + limit) <=
+            static_cast<T>(2 * limit)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+#if defined(__SSE2__)
+/**
+ * Lane operations of the vector searches. Comparisons set all the bits
+ * of the lanes that compare true, and laneMask() packs them into one bit
+ * per lane, lowest lane first.
+ */
+template <class T>
+struct SSE2Ops
+{
+    typedef __m128i Vec;
+    static constexpr std::size_t lanes = sizeof(Vec) / sizeof(T);
+
+    static Vec
+    load(const uint8_t* p)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    static Vec andBits(Vec a, Vec b) { return _mm_and_si128(a, b); }
+    static Vec xorBits(Vec a, Vec b) { return _mm_xor_si128(a, b); }
+};
+
+struct SSE2Ops16 : public SSE2Ops<uint16_t>
+{
+    static Vec set(uint16_t v) { return _mm_set1_epi16(v); }
+    static Vec add(Vec a, Vec b) { return _mm_add_epi16(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm_sub_epi16(a, b); }
+    static Vec eq(Vec a, Vec b) { return _mm_cmpeq_epi16(a, b); }
+    static Vec gt(Vec a, Vec b) { return _mm_cmpgt_epi16(a, b); }
+
+    static unsigned
+    laneMask(Vec v)
+    {
+        return _mm_movemask_epi8(_mm_packs_epi16(v, _mm_setzero_si128()));
+    }
+};
+
+struct SSE2Ops32 : public SSE2Ops<uint32_t>
+{
+    static Vec set(uint32_t v) { return _mm_set1_epi32(v); }
+    static Vec add(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm_sub_epi32(a, b); }
+    static Vec eq(Vec a, Vec b) { return _mm_cmpeq_epi32(a, b); }
+    static Vec gt(Vec a, Vec b) { return _mm_cmpgt_epi32(a, b); }
+
+    static unsigned
+    laneMask(Vec v)
+    {
+        return _mm_movemask_ps(_mm_castsi128_ps(v));
+    }
+};
+
+struct SSE2Ops64 : public SSE2Ops<uint64_t>
+{
+    static Vec set(uint64_t v) { return _mm_set1_epi64x(v); }
+    static Vec add(Vec a, Vec b) { return _mm_add_epi64(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm_sub_epi64(a, b); }
+
+    static Vec
+    eq(Vec a, Vec b)
+    {
+        // Both halves of a lane must be equal
+        const Vec eq32 = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(eq32,
+            _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+
+#if defined(__SSE4_2__)
+    static Vec gt(Vec a, Vec b) { return _mm_cmpgt_epi64(a, b); }
+#endif
+
+    static unsigned
+    laneMask(Vec v)
+    {
+        return _mm_movemask_pd(_mm_castsi128_pd(v));
+    }
+};
+#endif // __SSE2__
+
+#if defined(__AVX2__)
+template <class T>
+struct AVX2Ops
+{
+    typedef __m256i Vec;
+    static constexpr std::size_t lanes = sizeof(Vec) / sizeof(T);
+
+    static Vec
+    load(const uint8_t* p)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    static Vec andBits(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+    static Vec xorBits(Vec a, Vec b) { return _mm256_xor_si256(a, b); }
+};
+
+struct AVX2Ops32 : public AVX2Ops<uint32_t>
+{
+    static Vec set(uint32_t v) { return _mm256_set1_epi32(v); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_epi32(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm256_sub_epi32(a, b); }
+    static Vec eq(Vec a, Vec b) { return _mm256_cmpeq_epi32(a, b); }
+    static Vec gt(Vec a, Vec b) { return _mm256_cmpgt_epi32(a, b); }
+
+    static unsigned
+    laneMask(Vec v)
+    {
+        return _mm256_movemask_ps(_mm256_castsi256_ps(v));
+    }
+};
+
+struct AVX2Ops64 : public AVX2Ops<uint64_t>
+{
+    static Vec set(uint64_t v) { return _mm256_set1_epi64x(v); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_epi64(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm256_sub_epi64(a, b); }
+    static Vec eq(Vec a, Vec b) { return _mm256_cmpeq_epi64(a, b); }
+    static Vec gt(Vec a, Vec b) { return _mm256_cmpgt_epi64(a, b); }
+
+    static unsigned
+    laneMask(Vec v)
+    {
+        return _mm256_movemask_pd(_mm256_castsi256_pd(v));
+    }
+};
+#endif // __AVX2__
+
+/**
+ * Vector search for the first masked match. It checks whole vectors of
+ * entries from index i on, and stops at the first one with a match, or
+ * when fewer entries than lanes are left.
+ *
+ * @param i Index of the first entry to check. It is updated to the index
+ *          of the match, or to the first entry that was not checked.
+ * @return Whether a match was found.
+ */
+template <class Ops, class T>
+inline bool
+findMaskedMatchVector(const uint8_t* entries, std::size_t num_entries,
+    T value, T mask, std::size_t& i)
+{
+    const typename Ops::Vec masked_value = Ops::set(value & mask);
+    const typename Ops::Vec vec_mask = Ops::set(mask);
+    for (; i + Ops::lanes <= num_entries; i += Ops::lanes) {
+        const unsigned hits = Ops::laneMask(Ops::eq(Ops::andBits(
+            Ops::load(entries + i * sizeof(T)), vec_mask), masked_value));
+        if (hits) {
+            i += findLsbSet(hits);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Vector search for the first delta match. The unsigned comparison of
+ * the scalar search is done as a signed one by flipping the sign bits.
+ *
+ * @see findMaskedMatchVector
+ */
+template <class Ops, class T>
+inline bool
+findDeltaMatchVector(const uint8_t* entries, std::size_t num_entries,
+    T value, T limit, std::size_t& i)
+{
+    const T sign_bit = T(1) << (sizeof(T) * 8 - 1);
+    const typename Ops::Vec vec_value = Ops::set(value + limit);
+    const typename Ops::Vec vec_sign = Ops::set(sign_bit);
+    const typename Ops::Vec bound = Ops::set(T(2 * limit) ^ sign_bit);
+    const unsigned all_lanes = (1 << Ops::lanes) - 1;
+    for (; i + Ops::lanes <= num_entries; i += Ops::lanes) {
+        const typename Ops::Vec biased_delta = Ops::xorBits(Ops::sub(
+            vec_value, Ops::load(entries + i * sizeof(T))), vec_sign);
+        const unsigned hits =
+            ~Ops::laneMask(Ops::gt(biased_delta, bound)) & all_lanes;
+        if (hits) {
+            i += findLsbSet(hits);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Find the first entry whose masked bits are equal to the masked value.
+ *
+ * @param entries The dictionary entries.
+ * @param num_entries Number of valid entries.
+ * @param value The value to be matched.
+ * @param mask The bits that must match.
+ * @return The index of the matching entry, or -1.
+ */
+template <class T>
+inline int
+findMaskedMatch(const uint8_t* entries, std::size_t num_entries, T value,
+    T mask)
+{
+    return findMaskedMatchScalar(entries, num_entries, value, mask);
+}
+
+inline int
+findMaskedMatch(const uint8_t* entries, std::size_t num_entries,
+    uint16_t value, uint16_t mask)
+{
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    if (findMaskedMatchVector<SSE2Ops16>(entries, num_entries, value, mask,
+                                         i)) {
+        return i;
+    }
+#endif
+    return findMaskedMatchScalar(entries, num_entries, value, mask, i);
+}
+
+inline int
+findMaskedMatch(const uint8_t* entries, std::size_t num_entries,
+    uint32_t value, uint32_t mask)
+{
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    if (findMaskedMatchVector<AVX2Ops32>(entries, num_entries, value, mask,
+                                         i)) {
+        return i;
+    }
+#endif
+#if defined(__SSE2__)
+    if (findMaskedMatchVector<SSE2Ops32>(entries, num_entries, value, mask,
+                                         i)) {
+        return i;
+    }
+#endif
+    return findMaskedMatchScalar(entries, num_entries, value, mask, i);
+}
+
+inline int
+findMaskedMatch(const uint8_t* entries, std::size_t num_entries,
+    uint64_t value, uint64_t mask)
+{
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    if (findMaskedMatchVector<AVX2Ops64>(entries, num_entries, value, mask,
+                                         i)) {
+        return i;
+    }
+#endif
+#if defined(__SSE2__)
+    if (findMaskedMatchVector<SSE2Ops64>(entries, num_entries, value, mask,
+                                         i)) {
+        return i;
+    }
+#endif
+    return findMaskedMatchScalar(entries, num_entries, value, mask, i);
+}
+
+/**
+ * Find the first base the value is at most limit away from.
+ *
+ * @param entries The dictionary entries, i.e., the bases.
+ * @param num_entries Number of valid entries.
+ * @param value The value to be matched.
+ * @param limit The largest absolute delta.
+ * @return The index of the matching entry, or -1.
+ */
+template <class T>
+inline int
+findDeltaMatch(const uint8_t* entries, std::size_t num_entries, T value,
+    T limit)
+{
+    return findDeltaMatchScalar(entries, num_entries, value, limit);
+}
+
+inline int
+findDeltaMatch(const uint8_t* entries, std::size_t num_entries,
+    uint16_t value, uint16_t limit)
+{
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    if (findDeltaMatchVector<SSE2Ops16>(entries, num_entries, value, limit,
+                                        i)) {
+        return i;
+    }
+#endif
+    return findDeltaMatchScalar(entries, num_entries, value, limit, i);
+}
+
+inline int
+findDeltaMatch(const uint8_t* entries, std::size_t num_entries,
+    uint32_t value, uint32_t limit)
+{
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    if (findDeltaMatchVector<AVX2Ops32>(entries, num_entries, value, limit,
+                                        i)) {
+        return i;
+    }
+#endif
+#if defined(__SSE2__)
+    if (findDeltaMatchVector<SSE2Ops32>(entries, num_entries, value, limit,
+                                        i)) {
+        return i;
+    }
+#endif
+    return findDeltaMatchScalar(entries, num_entries, value, limit, i);
+}
+
+inline int
+findDeltaMatch(const uint8_t* entries, std::size_t num_entries,
+    uint64_t value, uint64_t limit)
+{
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    if (findDeltaMatchVector<AVX2Ops64>(entries, num_entries, value, limit,
+                                        i)) {
+        return i;
+    }
+#endif
+#if defined(__SSE4_2__)
+    if (findDeltaMatchVector<SSE2Ops64>(entries, num_entries, value, limit,
+                                        i)) {
+        return i;
+    }
+#endif
+    return findDeltaMatchScalar(entries, num_entries, value, limit, i);
+}
+
+} // namespace SIMD
+} // namespace Compressor
+
+#endif //__MEM_CACHE_COMPRESSORS_SIMD_HH__
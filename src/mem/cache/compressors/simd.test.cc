@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "mem/cache/compressors/simd.hh"
+
+using namespace Compressor;
+
+namespace {
+
+/**
+ * Generate values that look like the contents of memory: zeros, small
+ * signed integers, pointers into a few regions and repeated bytes.
+ */
+template <class T>
+std::vector<T>
+memoryImage(std::size_t size, std::mt19937_64 &rng)
+{
+    const uint64_t regions[] = {
+        0x00007f3a12c40000, 0x0000555d0e218000, 0xffffffff80000000 };
+    std::vector<T> values(size);
+    for (auto &value : values) {
+        switch (rng() % 5) {
+          case 0:
+            value = 0;
+            break;
+          case 1:
+            value = static_cast<int8_t>(rng());
+            break;
+          case 2:
+            value = regions[rng() % 3] + (rng() % 4096) * 8;
+            break;
+          case 3:
+            value = static_cast<T>(0x0101010101010101ULL * (rng() & 0xFF));
+            break;
+          default:
+            value = rng();
+        }
+    }
+    return values;
+}
+
+/** Dictionary entries as the compressors store them. */
+template <class T>
+std::vector<uint8_t>
+toEntries(const std::vector<T> &values)
+{
+    std::vector<uint8_t> entries;
+    for (T value : values) {
+        for (std::size_t i = 0; i < sizeof(T); i++) {
+            entries.push_back(value & 0xFF);
+            value >>= 8;
+        }
+    }
+    return entries;
+}
+
+template <class T>
+int
+referenceMaskedMatch(const std::vector<T> &dict, std::size_t num_entries,
+    T value, T mask)
+{
+    for (std::size_t i = 0; i < num_entries; i++) {
+        if ((dict[i] & mask) == (value & mask)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+template <class T>
+int
+referenceDeltaMatch(const std::vector<T> &dict, std::size_t num_entries,
+    T value, T limit)
+{
+    typedef typename std::make_signed<T>::type SignedT;
+    for (std::size_t i = 0; i < num_entries; i++) {
+        const SignedT delta = value - dict[i];
+        if (delta >= -SignedT(limit) && delta <= SignedT(limit)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+template <class T>
+void
+checkMaskedMatch(const std::vector<T> &masks)
+{
+    std::mt19937_64 rng(0);
+    for (int test = 0; test < 2000; test++) {
+        const std::vector<T> dict = memoryImage<T>(64, rng);
+        const std::vector<uint8_t> entries = toEntries(dict);
+        const std::vector<T> values = memoryImage<T>(16, rng);
+        const std::size_t num_entries = rng() % (dict.size() + 1);
+        for (T value : values) {
+            for (T mask : masks) {
+                ASSERT_EQ(SIMD::findMaskedMatch(entries.data(), num_entries,
+                              value, mask),
+                          referenceMaskedMatch(dict, num_entries, value,
+                              mask));
+            }
+        }
+    }
+}
+
+template <class T>
+void
+checkDeltaMatch(const std::vector<T> &limits)
+{
+    std::mt19937_64 rng(0);
+    for (int test = 0; test < 2000; test++) {
+        const std::vector<T> dict = memoryImage<T>(64, rng);
+        const std::vector<uint8_t> entries = toEntries(dict);
+        const std::vector<T> values = memoryImage<T>(16, rng);
+        const std::size_t num_entries = rng() % (dict.size() + 1);
+        for (T value : values) {
+            for (T limit : limits) {
+                ASSERT_EQ(SIMD::findDeltaMatch(entries.data(), num_entries,
+                              value, limit),
+                          referenceDeltaMatch(dict, num_entries, value,
+                              limit));
+            }
+        }
+    }
+}
+
+/**
+ * Search the dictionary made of each line of a memory image for the
+ * values of the next line, as the compressors do with the values they
+ * have seen, and check that the searches agree with the scalar ones.
+ */
+template <class T>
+void
+checkImageMatches(const std::vector<T> &masks, const std::vector<T> &limits)
+{
+    const std::size_t line_size = 64;
+    const std::size_t num_entries = line_size / sizeof(T);
+
+    std::mt19937_64 rng(0);
+    const std::vector<uint8_t> image =
+        toEntries(memoryImage<uint64_t>(1 << 10, rng));
+
+    for (std::size_t line = 0; line + 2 * line_size <= image.size();
+         line += line_size) {
+        const uint8_t *dict = image.data() + line;
+        for (std::size_t i = 0; i < num_entries; i++) {
+            const T value = SIMD::loadEntry<T>(
+                dict + line_size + i * sizeof(T));
+            for (T mask : masks) {
+                ASSERT_EQ(SIMD::findMaskedMatch(dict, num_entries, value,
+                              mask),
+                          SIMD::findMaskedMatchScalar(dict, num_entries,
+                              value, mask));
+            }
+            for (T limit : limits) {
+                ASSERT_EQ(SIMD::findDeltaMatch(dict, num_entries, value,
+                              limit),
+                          SIMD::findDeltaMatchScalar(dict, num_entries,
+                              value, limit));
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+TEST(CompressorSIMDTest, MaskedMatch16)
+{
+    checkMaskedMatch<uint16_t>({0xFFFF, 0xFF00, 0x00FF});
+}
+
+TEST(CompressorSIMDTest, MaskedMatch32)
+{
+    checkMaskedMatch<uint32_t>({0xFFFFFFFF, 0xFFFFFF00, 0xFFFF0000});
+}
+
+TEST(CompressorSIMDTest, MaskedMatch64)
+{
+    checkMaskedMatch<uint64_t>({0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFF0000,
+                                0xFFFFFFFF00000000});
+}
+
+TEST(CompressorSIMDTest, DeltaMatch16)
+{
+    checkDeltaMatch<uint16_t>({0, 0x7F});
+}
+
+TEST(CompressorSIMDTest, DeltaMatch32)
+{
+    checkDeltaMatch<uint32_t>({0, 0x7F, 0x7FFF});
+}
+
+TEST(CompressorSIMDTest, DeltaMatch64)
+{
+    checkDeltaMatch<uint64_t>({0, 0x7F, 0x7FFF, 0x7FFFFFFF});
+}
+
+/** The first of several matching entries is returned. */
+TEST(CompressorSIMDTest, FirstMatch)
+{
+    const std::vector<uint32_t> dict(16, 0x12345678);
+    const std::vector<uint8_t> entries = toEntries(dict);
+    for (std::size_t num_entries = 1; num_entries <= dict.size();
+         num_entries++) {
+        ASSERT_EQ(SIMD::findMaskedMatch(entries.data(), num_entries,
+                      uint32_t(0x12345600), uint32_t(0xFFFFFF00)), 0);
+        ASSERT_EQ(SIMD::findDeltaMatch(entries.data(), num_entries,
+                      uint32_t(0x12345600), uint32_t(0x7F)), 0);
+    }
+}
+
+/** Entries past the valid ones are never matched. */
+TEST(CompressorSIMDTest, NoMatchPastEnd)
+{
+    const std::vector<uint64_t> dict = {1, 2, 3, 4, 5, 6, 7, 8};
+    const std::vector<uint8_t> entries = toEntries(dict);
+    for (std::size_t num_entries = 0; num_entries < dict.size();
+         num_entries++) {
+        ASSERT_EQ(SIMD::findMaskedMatch(entries.data(), num_entries,
+                      uint64_t(8), ~uint64_t(0)), -1);
+        ASSERT_EQ(SIMD::findDeltaMatch(entries.data(), num_entries,
+                      uint64_t(8), uint64_t(0)), -1);
+    }
+}
+
+/** The searches agree with the scalar ones on the lines of an image. */
+TEST(CompressorSIMDTest, ImageMatchesScalar)
+{
+    checkImageMatches<uint16_t>({0xFFFF, 0xFF00}, {0x7F});
+    checkImageMatches<uint32_t>({0xFFFFFFFF, 0xFFFFFF00, 0xFFFF0000},
+                                {0x7F, 0x7FFF});
+    checkImageMatches<uint64_t>({0xFFFFFFFFFFFFFFFF},
+                                {0x7F, 0x7FFF, 0x7FFFFFFF});
+}
@@ -0,0 +1,11 @@
+/**
+ * @file
+ * The benchmark of the dictionary searches, built for AVX2, which also
+ * enables SSE4.2.
+ */
+
+#if !defined(__AVX2__) || !defined(__SSE4_2__)
+#error "This benchmark must be built with AVX2 enabled"
+#endif
+
+#include "mem/cache/compressors/simd.bench.cc"
@@ -0,0 +1,12 @@
+/**
+ * @file
+ * The tests of the dictionary searches, built for AVX2, which also
+ * enables SSE4.2, so that the paths a default build leaves out are
+ * tested as well.
+ */
+
+#if !defined(__AVX2__) || !defined(__SSE4_2__)
+#error "This test must be built with AVX2 enabled"
+#endif
+
+#include "mem/cache/compressors/simd.test.cc"
@@ -52,6 +52,13 @@ Zero::addToDictionary(DictionaryEntry data)
     dictionary[numEntries++] = data;
 }
 
+std::unique_ptr<DictionaryCompressor<uint64_t>::Pattern>
+Zero::findPattern(const DictionaryEntry& bytes) const
+{
+    // No pattern depends on the dictionary, so it need not be searched
+    return getPattern(bytes, toDictionaryEntry(0), -1);
+}
+
 std::unique_ptr<Base::CompressionData>
 Zero::compress(const std::vector<Chunk>& chunks, Cycles& comp_lat,
     Cycles& decomp_lat)
@@ -0,0 +1,244 @@
+#include "mem/cache/dead_block_predictor.hh"
+
+#include <algorithm>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/DeadBlock.hh"
+#include "params/DeadBlockPredictor.hh"
+
+DeadBlockPredictor::DeadBlockPredictor(const Params *p)
+    : SimObject(p), blkSize(p->block_size),
+      numSets(p->size / (p->assoc * p->block_size)),
+      samplingStride(std::max(1U, numSets / p->num_sampled_sets)),
+      tables(p->num_tables,
+             std::vector<SatCounter>(p->table_size,
+                                     SatCounter(p->counter_bits))),
+      threshold(p->threshold), bypassFills(p->bypass_fills),
+      cleanDeadBlocks(p->clean_dead_blocks),
+      bypassHistorySize(p->bypass_history),
+      bypassCount(0), deadBlocksSize(p->dead_blocks), stats(this)
+{
+    fatal_if(numSets == 0, "The cache must have at least one set.\n");
+    fatal_if(tables.empty(), "The predictor needs at least one table.\n");
+    fatal_if(!isPowerOf2(p->table_size),
+             "The table size must be a power of 2.\n");
+    fatal_if(threshold == 0 ||
+             threshold > tables.size() * ((1 << p->counter_bits) - 1),
+             "The threshold can not be reached by the counters.\n");
+
+    sampler.resize(divCeil(numSets, samplingStride),
+                   SampledSet(p->sampler_assoc));
+}
+
+unsigned
+DeadBlockPredictor::getSignature(const PacketPtr pkt) const
+{
+    uint64_t sig = pkt->req->getPC();
+
+    // Prefetches are predicted separately from demand accesses
+    if (pkt->cmd.isHWPrefetch() || pkt->req->isPrefetch()) {
+        sig = ~sig;
+    }
+
+    return (sig ^ (sig >> 15) ^ (sig >> 30)) & mask(15);
+}
+
+unsigned
+DeadBlockPredictor::tableIndex(unsigned table, unsigned signature) const
+{
+    // One odd multiplier per table spreads the signatures differently
+    const uint64_t hash =
+        (signature + 1) * (ULL(0x9E3779B97F4A7C15) + 2 * table);
+    return (hash >> 32) & (tables[table].size() - 1);
+}
+
+bool
+DeadBlockPredictor::isDead(unsigned signature) const
+{
+    unsigned confidence = 0;
+    for (unsigned table = 0; table < tables.size(); table++) {
+        confidence += tables[table][tableIndex(table, signature)];
+    }
+    return confidence >= threshold;
+}
+
+void
+DeadBlockPredictor::train(unsigned signature, bool dead)
+{
+    for (unsigned table = 0; table < tables.size(); table++) {
+        SatCounter &counter = tables[table][tableIndex(table, signature)];
+        if (dead) {
+            counter++;
+        } else {
+            counter--;
+        }
+    }
+}
+
+DeadBlockPredictor::SampledSet *
+DeadBlockPredictor::sampledSet(Addr blk_addr)
+{
+    const unsigned set = (blk_addr / blkSize) % numSets;
+    if (set % samplingStride) {
+        return nullptr;
+    }
+    return &sampler[set / samplingStride];
+}
+
+void
+DeadBlockPredictor::sample(const PacketPtr pkt, unsigned signature)
+{
+    SampledSet *sampled_set = sampledSet(pkt->getAddr());
+    if (!sampled_set) {
+        return;
+    }
+
+    const Addr tag = pkt->getAddr() / blkSize;
+    const uint64_t now = sampled_set->time++;
+
+    // Look for the block, or for the least recently used one to make
+    // room for it
+    SampledBlock *block = nullptr;
+    SampledBlock *lru = &sampled_set->blocks[0];
+    for (auto &sampled_block : sampled_set->blocks) {
+        if (sampled_block.valid && sampled_block.tag == tag) {
+            block = &sampled_block;
+            break;
+        }
+        if (lru->valid && (!sampled_block.valid ||
+                           sampled_block.lastAccess < lru->lastAccess)) {
+            lru = &sampled_block;
+        }
+    }
+
+    if (block) {
+        // The previous access was not the last one
+        train(block->signature, false);
+    } else {
+        // The last access to the evicted block left it dead
+        block = lru;
+        if (block->valid) {
+            train(block->signature, true);
+        }
+    }
+
+    block->tag = tag;
+    block->signature = signature;
+    block->lastAccess = now;
+    block->valid = true;
+}
+
+bool
+DeadBlockPredictor::access(const PacketPtr pkt, bool hit)
+{
+    const Addr blk_addr = pkt->getBlockAddr(blkSize);
+
+    // A miss to a block bypassed recently shows that it was not dead
+    if (!hit) {
+        auto it = bypassed.find(blk_addr);
+        if (it != bypassed.end()) {
+            DPRINTF(DeadBlock, "Bypassed block %#x accessed again\n",
+                    blk_addr);
+            stats.bypassMispredictions++;
+            bypassed.erase(it);
+        }
+    }
+
+    if (!pkt->req->hasPC()) {
+        return false;
+    }
+
+    const unsigned signature = getSignature(pkt);
+    sample(pkt, signature);
+
+    if (!isDead(signature)) {
+        return false;
+    }
+    stats.deadPredictions++;
+
+    if (hit && cleanDeadBlocks) {
+        deadBlocks.emplace_back(blk_addr, pkt->isSecure());
+        if (deadBlocks.size() > deadBlocksSize) {
+            deadBlocks.pop_front();
+        }
+    }
+    return true;
+}
+
+bool
+DeadBlockPredictor::bypass(const PacketPtr pkt)
+{
+    if (!bypassFills || !pkt->req->hasPC() || sampledSet(pkt->getAddr()) ||
+        !isDead(getSignature(pkt))) {
+        return false;
+    }
+
+    const Addr blk_addr = pkt->getBlockAddr(blkSize);
+    DPRINTF(DeadBlock, "Bypassing fill of %#x\n", blk_addr);
+    stats.bypasses++;
+
+    // Blocks not accessed again while in the history were dead indeed
+    const uint64_t id = bypassCount++;
+    bypassed[blk_addr] = id;
+    bypassHistory.emplace_back(blk_addr, id);
+    if (bypassHistory.size() > bypassHistorySize) {
+        const auto &oldest = bypassHistory.front();
+        auto it = bypassed.find(oldest.first);
+        if (it != bypassed.end() && it->second == oldest.second) {
+            stats.bypassCorrect++;
+            bypassed.erase(it);
+        }
+        bypassHistory.pop_front();
+    }
+
+    return true;
+}
+
+bool
+DeadBlockPredictor::nextDeadBlock(Addr &blk_addr, bool &is_secure)
+{
+    if (deadBlocks.empty()) {
+        return false;
+    }
+
+    blk_addr = deadBlocks.front().first;
+    is_secure = deadBlocks.front().second;
+    deadBlocks.pop_front();
+    return true;
+}
+
+DeadBlockPredictor::DeadBlockStats::DeadBlockStats(Stats::Group *parent)
+    : Stats::Group(parent),
+    ADD_STAT(deadPredictions, "Number of accesses predicted to leave their "
+             "block dead"),
+    ADD_STAT(bypasses, "Number of fills that bypassed the cache"),
+    ADD_STAT(bypassMispredictions, "Number of bypassed blocks accessed "
+             "again soon after"),
+    ADD_STAT(bypassCorrect, "Number of bypassed blocks not accessed again "
+             "soon after"),
+    ADD_STAT(bypassAccuracy, "Fraction of the checked bypasses that were "
+             "not accessed again soon after"),
+    ADD_STAT(deadCleanings, "Number of dirty blocks cleaned while "
+             "predicted dead")
+{
+}
+
+void
+DeadBlockPredictor::DeadBlockStats::regStats()
+{
+    using namespace Stats;
+
+    Stats::Group::regStats();
+
+    bypassAccuracy.flags(nozero | nonan);
+    bypassAccuracy = bypassCorrect / (bypassCorrect + bypassMispredictions);
+}
+
+DeadBlockPredictor*
+DeadBlockPredictorParams::create()
+{
+    return new DeadBlockPredictor(this);
+}
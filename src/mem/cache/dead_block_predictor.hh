@@ -0,0 +1,213 @@
+/**
+ * @file
+ * Declaration of a sampling dead block predictor.
+ *
+ * A block is dead between its last access and its eviction. The
+ * predictor learns which instructions make the last accesses to their
+ * blocks, from a sampler that tracks a few sets of the cache as if they
+ * were LRU caches of their own: a sampled block that is accessed again
+ * shows that the previous access was not its last, and one that is
+ * evicted from the sampler shows that it was. Each outcome trains a few
+ * tables of saturating counters indexed by different hashes of the PC
+ * signature of the access, and the sum of the counters of a signature
+ * predicts whether the blocks it touches are dead after the access.
+ *
+ * The cache uses the predictions to bypass the fills that are dead on
+ * arrival, and to clean the dirty blocks that are dead after a hit while
+ * it has nothing else to send, so that their evictions do not write
+ * back later, in a burst with the demand misses.
+ *
+ * The sampler assumes the usual modulo set indexing on blocks.
+ *
+ * @see Khan, Tian and Jimenez, "Sampling Dead Block Prediction for
+ * Last-Level Caches", MICRO 2010.
+ */
+
+#ifndef __MEM_CACHE_DEAD_BLOCK_PREDICTOR_HH__
+#define __MEM_CACHE_DEAD_BLOCK_PREDICTOR_HH__
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/sat_counter.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/packet.hh"
+#include "sim/sim_object.hh"
+
+struct DeadBlockPredictorParams;
+
+class DeadBlockPredictor : public SimObject
+{
+  protected:
+    /** A block tracked by the sampler. */
+    struct SampledBlock
+    {
+        /** Address of the block, in blocks. */
+        Addr tag = 0;
+
+        /** Signature of the last access to the block. */
+        unsigned signature = 0;
+
+        /** Time of the last access, in accesses to the set. */
+        uint64_t lastAccess = 0;
+
+        bool valid = false;
+    };
+
+    /** A sampled set, managed with LRU. */
+    struct SampledSet
+    {
+        SampledSet(unsigned assoc) : time(0), blocks(assoc) {}
+
+        /** Number of accesses to the set. */
+        uint64_t time;
+
+        std::vector<SampledBlock> blocks;
+    };
+
+    /** Block size of the cache. */
+    const unsigned blkSize;
+
+    /** Number of sets of the cache. */
+    const unsigned numSets;
+
+    /** Distance between two sampled sets. */
+    const unsigned samplingStride;
+
+    /** The sampled sets. */
+    std::vector<SampledSet> sampler;
+
+    /** The tables of counters, each indexed by its own hash. */
+    std::vector<std::vector<SatCounter>> tables;
+
+    /** Sum of the counters from which a block is predicted dead. */
+    const unsigned threshold;
+
+    /** Whether the fills predicted dead bypass the cache. */
+    const bool bypassFills;
+
+    /** Whether the dirty blocks predicted dead are cleaned. */
+    const bool cleanDeadBlocks;
+
+    /** Blocks bypassed recently, with the time they were bypassed. */
+    std::unordered_map<Addr, uint64_t> bypassed;
+
+    /** Order in which the recent bypasses leave the history. */
+    std::deque<std::pair<Addr, uint64_t>> bypassHistory;
+
+    /** Number of bypasses tracked to measure the accuracy. */
+    const unsigned bypassHistorySize;
+
+    /** Number of bypasses so far, used to tell them apart. */
+    uint64_t bypassCount;
+
+    /** Blocks predicted dead after a hit, oldest first. */
+    std::deque<std::pair<Addr, bool>> deadBlocks;
+
+    /** Maximum number of blocks waiting to be cleaned. */
+    const unsigned deadBlocksSize;
+
+    /**
+     * Get the signature of an access.
+     *
+     * @param pkt The access, which must have a PC.
+     * @return Its signature.
+     */
+    unsigned getSignature(const PacketPtr pkt) const;
+
+    /** Get the index of a signature in one of the tables. */
+    unsigned tableIndex(unsigned table, unsigned signature) const;
+
+    /** Whether the blocks accessed with a signature are then dead. */
+    bool isDead(unsigned signature) const;
+
+    /**
+     * Train a signature.
+     *
+     * @param signature The signature of the last access to a block.
+     * @param dead Whether it was the last access before the eviction.
+     */
+    void train(unsigned signature, bool dead);
+
+    /**
+     * Get the sampled set of a block.
+     *
+     * @param blk_addr Address of the block.
+     * @return The sampled set, or nullptr if its set is not sampled.
+     */
+    SampledSet *sampledSet(Addr blk_addr);
+
+    /** Simulate an access in the sampler, and learn from it. */
+    void sample(const PacketPtr pkt, unsigned signature);
+
+    struct DeadBlockStats : public Stats::Group
+    {
+        DeadBlockStats(Stats::Group *parent);
+
+        void regStats() override;
+
+        /** Number of accesses predicted to leave their block dead. */
+        Stats::Scalar deadPredictions;
+
+        /** Number of fills that did not allocate a block. */
+        Stats::Scalar bypasses;
+
+        /** Number of bypassed blocks accessed again soon after. */
+        Stats::Scalar bypassMispredictions;
+
+        /** Number of bypassed blocks not accessed again soon after. */
+        Stats::Scalar bypassCorrect;
+
+        /** Fraction of the bypasses that were not accessed again soon. */
+        Stats::Formula bypassAccuracy;
+
+        /** Number of dirty blocks cleaned while predicted dead. */
+        Stats::Scalar deadCleanings;
+    } stats;
+
+  public:
+    typedef DeadBlockPredictorParams Params;
+    DeadBlockPredictor(const Params *p);
+
+    /**
+     * Learn from a demand access to the cache, and predict whether it is
+     * the last access to its block. Blocks hit by their last access are
+     * kept to be cleaned.
+     *
+     * @param pkt The access.
+     * @param hit Whether it hit in the cache.
+     * @return Whether the block is predicted dead after the access.
+     */
+    bool access(const PacketPtr pkt, bool hit);
+
+    /**
+     * Decide whether a fill should not allocate a block, because it is
+     * predicted to be dead on arrival. The blocks of the sampled sets are
+     * always allocated, so that their predictions keep being checked.
+     *
+     * @param pkt The fill.
+     * @return Whether the fill should bypass the cache.
+     */
+    bool bypass(const PacketPtr pkt);
+
+    /**
+     * Get the next block predicted dead to be cleaned, if any.
+     *
+     * @param blk_addr Set to the address of the block.
+     * @param is_secure Set to whether the block is secure.
+     * @return Whether there was a block.
+     */
+    bool nextDeadBlock(Addr &blk_addr, bool &is_secure);
+
+    /** Whether there are blocks predicted dead waiting to be cleaned. */
+    bool hasDeadBlocks() const { return !deadBlocks.empty(); }
+
+    /** Record the cleaning of a block predicted dead. */
+    void deadBlockCleaned() { stats.deadCleanings++; }
+};
+
+#endif //__MEM_CACHE_DEAD_BLOCK_PREDICTOR_HH__
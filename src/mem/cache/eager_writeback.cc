@@ -0,0 +1,106 @@
+#include "mem/cache/eager_writeback.hh"
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/EagerWriteback.hh"
+#include "mem/cache/cache_blk.hh"
+#include "mem/cache/tags/base.hh"
+#include "mem/mem_ctrl.hh"
+#include "params/EagerWriteback.hh"
+
+EagerWriteback::EagerWriteback(const Params *p)
+    : SimObject(p), memCtrls(p->mem_ctrls), scanSets(p->scan_sets),
+      lruDepth(p->lru_depth), idleInterval(p->idle_interval), nextSet(0),
+      setsWithoutBlock(0), swept(false), stats(this)
+{
+    fatal_if(memCtrls.empty(),
+             "The eager writeback needs the memory controllers.\n");
+    fatal_if(scanSets == 0 || lruDepth == 0,
+             "The eager writeback must scan at least one block.\n");
+    fatal_if(idleInterval == 0,
+             "The eager writeback idle interval must be at least a cycle.\n");
+}
+
+bool
+EagerWriteback::writeQueuesLow() const
+{
+    for (const auto &ctrl : memCtrls) {
+        if (ctrl->isWriteQueueLow()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+EagerWriteback::canWrite(Addr addr) const
+{
+    for (const auto &ctrl : memCtrls) {
+        if (ctrl->isRowOpen(addr)) {
+            return ctrl->isWriteQueueLow();
+        }
+    }
+    return false;
+}
+
+CacheBlk *
+EagerWriteback::findBlock(const BaseTags &tags)
+{
+    const uint32_t num_sets = tags.getNumSets();
+    if (num_sets == 0) {
+        return nullptr;
+    }
+
+    for (unsigned scanned = 0; scanned < scanSets; scanned++) {
+        stats.setsScanned++;
+
+        // A set is scanned again until it has no block left to clean,
+        // as the blocks of a row are usually in consecutive sets
+        for (CacheBlk *blk : tags.getNextVictims(nextSet, lruDepth)) {
+            if (!blk->isDirty()) {
+                continue;
+            }
+            stats.dirtyFound++;
+
+            const Addr blk_addr = tags.regenerateBlkAddr(blk);
+            if (canWrite(blk_addr)) {
+                DPRINTF(EagerWriteback, "Set %d: cleaning %#x\n", nextSet,
+                        blk_addr);
+                setsWithoutBlock = 0;
+                swept = false;
+                return blk;
+            }
+            stats.notWritable++;
+        }
+
+        nextSet = (nextSet + 1) % num_sets;
+        setsWithoutBlock++;
+    }
+
+    swept = setsWithoutBlock >= num_sets;
+    return nullptr;
+}
+
+Cycles
+EagerWriteback::retryDelay() const
+{
+    return swept || !writeQueuesLow() ? idleInterval : Cycles(1);
+}
+
+EagerWriteback::EagerWritebackStats::EagerWritebackStats(
+    Stats::Group *parent)
+    : Stats::Group(parent),
+    ADD_STAT(setsScanned, "Number of sets scanned for dirty blocks"),
+    ADD_STAT(dirtyFound, "Number of dirty blocks found at the LRU end of "
+             "their set"),
+    ADD_STAT(notWritable, "Number of dirty blocks not cleaned as their row "
+             "was closed or their write queue was not low"),
+    ADD_STAT(cleanings, "Number of dirty blocks cleaned")
+{
+}
+
+EagerWriteback*
+EagerWritebackParams::create()
+{
+    return new EagerWriteback(this);
+}
@@ -0,0 +1,124 @@
+/**
+ * @file
+ * Declaration of an eager writeback engine for the last-level cache.
+ *
+ * A cache that writes back its dirty blocks only when they are evicted
+ * sends its writes in bursts with the misses that evict them, which
+ * makes the memory controller turn its bus around between reads and
+ * writes. The engine rather cleans dirty blocks ahead of their eviction,
+ * while the cache has nothing else to send, picking the ones that the
+ * DRAM can take cheaply: blocks at the LRU end of their set, which are
+ * about to be evicted anyway, whose row is open in its bank, and only
+ * while the write queue of their controller is below its low threshold,
+ * so that the writes do not force a switch to writes.
+ *
+ * The sets of the cache are scanned in turn, a few at a time, every cycle
+ * the cache is idle, and only every idle interval once a sweep of the
+ * whole cache found nothing to clean, or while the write queues are not
+ * low, so that an idle cache does not scan itself every cycle.
+ *
+ * @see Lee et al., "DRAM-Aware Last-Level Cache Writeback: Reducing
+ * Write-Caused Interference in Memory Systems", UT Austin TR 2010, and
+ * Stuecheli et al., "The Virtual Write Queue: Coordinating DRAM and
+ * Last-Level Cache Policies", ISCA 2010.
+ */
+
+#ifndef __MEM_CACHE_EAGER_WRITEBACK_HH__
+#define __MEM_CACHE_EAGER_WRITEBACK_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "sim/sim_object.hh"
+
+class BaseTags;
+class CacheBlk;
+class MemCtrl;
+struct EagerWritebackParams;
+
+class EagerWriteback : public SimObject
+{
+  protected:
+    /** The controllers of the DRAM channels below the cache. */
+    const std::vector<MemCtrl*> memCtrls;
+
+    /** Number of sets scanned each time the cache is idle. */
+    const unsigned scanSets;
+
+    /** Number of blocks of a set, from its LRU end, that are scanned. */
+    const unsigned lruDepth;
+
+    /** Number of cycles between scans while there is nothing to clean. */
+    const Cycles idleInterval;
+
+    /** The next set to scan. */
+    uint32_t nextSet;
+
+    /** Number of sets scanned since a block to clean was last found. */
+    uint32_t setsWithoutBlock;
+
+    /** Whether the whole cache was scanned without finding a block. */
+    bool swept;
+
+    /**
+     * Check whether the DRAM holding an address can take a write to it
+     * cheaply.
+     *
+     * @param addr Address of the block.
+     * @return Whether the row of the address is open, and the write
+     *         queue of its controller is below its low threshold.
+     */
+    bool canWrite(Addr addr) const;
+
+    struct EagerWritebackStats : public Stats::Group
+    {
+        EagerWritebackStats(Stats::Group *parent);
+
+        /** Number of sets scanned. */
+        Stats::Scalar setsScanned;
+
+        /** Number of dirty blocks found at the LRU end of their set. */
+        Stats::Scalar dirtyFound;
+
+        /** Number of those whose row was closed or queue was full. */
+        Stats::Scalar notWritable;
+
+        /** Number of blocks cleaned. */
+        Stats::Scalar cleanings;
+    } stats;
+
+  public:
+    typedef EagerWritebackParams Params;
+    EagerWriteback(const Params *p);
+
+    /**
+     * Whether any of the controllers can take writes without switching
+     * its bus to writes, checked before scanning the cache.
+     */
+    bool writeQueuesLow() const;
+
+    /**
+     * Scan the next sets of the cache for a dirty block to clean.
+     *
+     * @param tags The tags of the cache.
+     * @return The block, or nullptr if none was found.
+     */
+    CacheBlk *findBlock(const BaseTags &tags);
+
+    /** Record the cleaning of a block found by the engine. */
+    void blockCleaned() { stats.cleanings++; }
+
+    /**
+     * Get the number of cycles until the next scan, after one that did
+     * not clean a block.
+     *
+     * @return The next cycle, or the idle interval if the write queues
+     *         are not low, or if the whole cache was scanned without
+     *         finding a block to clean.
+     */
+    Cycles retryDelay() const;
+};
+
+#endif //__MEM_CACHE_EAGER_WRITEBACK_HH__
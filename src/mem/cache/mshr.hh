@@ -366,6 +366,12 @@ class MSHR : public QueueEntry, public Printable
      */
     Iterator allocIter;
 
+    /**
+     * Pointer to this MSHR on the list of its block address.
+     * @sa Queue::matchIndex
+     */
+    Iterator matchIter;
+
     /** List of all requests that match the address */
     TargetList targets;
 
@@ -452,6 +458,15 @@ class MSHR : public QueueEntry, public Printable
         return &targets.front();
     }
 
+    /**
+     * Whether the MSHR was allocated for a prefetch of this cache.
+     */
+    bool fromPrefetcher() const
+    {
+        return hasTargets() &&
+            targets.front().source == Target::FromPrefetcher;
+    }
+
     /**
      * Pop first target.
      */
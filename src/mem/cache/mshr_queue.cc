@@ -65,6 +65,7 @@ MSHRQueue::allocate(Addr blk_addr, unsigned blk_size, PacketPtr pkt,
 
     mshr->allocate(blk_addr, blk_size, pkt, when_ready, order, alloc_on_fill);
     mshr->allocIter = allocatedList.insert(allocatedList.end(), mshr);
+    addToMatchIndex(mshr);
     mshr->readyIter = addToReadyList(mshr);
 
     allocated += 1;
@@ -279,6 +279,7 @@ NoncoherentCache::serviceMSHRTargets(MSHR *mshr, const PacketPtr pkt,
 
             // Reset the bus additional time as it is now accounted for
             tgt_pkt->headerDelay = tgt_pkt->payloadDelay = 0;
+            completion_time += compressForLink(tgt_pkt);
             cpuSidePort.schedTimingResp(tgt_pkt, completion_time);
             break;
 
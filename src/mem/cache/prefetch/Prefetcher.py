@@ -40,6 +40,7 @@ from m5.SimObject import *
 from m5.params import *
 from m5.proxy import *
 
+from m5.objects.BloomFilters import BloomFilterBlock
 from m5.objects.ClockedObject import ClockedObject
 from m5.objects.IndexingPolicies import *
 from m5.objects.ReplacementPolicies import *
@@ -80,6 +81,39 @@ class BasePrefetcher(ClockedObject):
     use_virtual_addresses = Param.Bool(False,
         "Use virtual addresses for prefetching")
 
+    # The prefetch stats are split between the local memory and a far
+    # memory tier, e.g., CXL memory, which can be prefetched further ahead
+    far_ranges = VectorParam.AddrRange([],
+        "Physical address ranges of the far memory tier")
+    far_degree_factor = Param.Unsigned(1,
+        "Factor of the degree of the prefetches triggered by accesses to "
+        "the far memory tier")
+
+    # Feedback directed throttling: the accuracy, lateness and cache
+    # pollution of the prefetches are measured over intervals of cache
+    # evictions, and used to move the aggressiveness of the prefetcher up
+    # or down. The aggressiveness scales the degree and distance of the
+    # prefetches, the highest level being the configured ones.
+    throttling = Param.Bool(False,
+        "Adjust the aggressiveness from the feedback of the cache")
+    throttle_interval = Param.Unsigned(8192,
+        "Number of evictions from the cache in a throttling interval")
+    throttle_levels = Param.Unsigned(5, "Number of aggressiveness levels")
+    throttle_accuracy_high = Param.Float(0.75,
+        "Accuracy above which the prefetches are considered accurate")
+    throttle_accuracy_low = Param.Float(0.40,
+        "Accuracy below which the prefetches are considered inaccurate")
+    throttle_lateness = Param.Float(0.01,
+        "Fraction of late useful prefetches above which they are late")
+    throttle_pollution = Param.Float(0.005,
+        "Fraction of demand misses caused by prefetches above which the "
+        "prefetcher pollutes the cache")
+    # One bit per entry, indexed by the xor of two fields of the block
+    # address, to track the blocks evicted by prefetches
+    pollution_filter = Param.BloomFilterBase(BloomFilterBlock(size = 4096,
+        offset_bits = 6, masks_lsbs = [0, 12], masks_sizes = [12, 12]),
+        "Filter of the blocks evicted by prefetches")
+
     def __init__(self, **kwargs):
         super(BasePrefetcher, self).__init__(**kwargs)
         self._events = []
@@ -45,10 +45,12 @@
 
 #include "mem/cache/prefetch/base.hh"
 
+#include <algorithm>
 #include <cassert>
 
 #include "base/intmath.hh"
 #include "cpu/base.hh"
+#include "debug/HWPrefetch.hh"
 #include "mem/cache/base.hh"
 #include "params/BasePrefetcher.hh"
 #include "sim/system.hh"
@@ -97,9 +99,27 @@ Base::Base(const BasePrefetcherParams *p)
       pageBytes(p->sys->getPageBytes()),
       prefetchOnAccess(p->prefetch_on_access),
       useVirtualAddresses(p->use_virtual_addresses),
+      farRanges(p->far_ranges.begin(), p->far_ranges.end()),
+      farDegreeFactor(p->far_degree_factor),
+      throttling(p->throttling), throttleInterval(p->throttle_interval),
+      throttleLevels(p->throttle_levels),
+      accuracyHigh(p->throttle_accuracy_high),
+      accuracyLow(p->throttle_accuracy_low),
+      latenessThreshold(p->throttle_lateness),
+      pollutionThreshold(p->throttle_pollution),
+      pollutionFilter(p->pollution_filter), aggressiveness(throttleLevels),
+      accuracy(0), lateness(0), pollution(0),
       prefetchStats(this), issuedPrefetches(0),
       usefulPrefetches(0), tlb(nullptr)
 {
+    fatal_if(throttling && throttleLevels == 0,
+             "%s: throttling needs at least one aggressiveness level\n",
+             name());
+    fatal_if(accuracyLow > accuracyHigh,
+             "%s: the low accuracy threshold is above the high one\n",
+             name());
+    fatal_if(farDegreeFactor == 0,
+             "%s: the far tier degree factor must be at least 1\n", name());
 }
 
 void
@@ -112,12 +132,47 @@ Base::setCache(BaseCache *_cache)
     blkSize = cache->getBlockSize();
     lBlkSize = floorLog2(blkSize);
 }
+
 Base::StatGroup::StatGroup(Stats::Group *parent)
     : Stats::Group(parent),
-    ADD_STAT(pfIssued, "number of hwpf issued")
+    ADD_STAT(pfIssued, "number of hwpf issued"),
+    ADD_STAT(pfUseful, "number of hwpf hit by a demand access"),
+    ADD_STAT(pfLate, "number of hwpf hit by a demand access in flight"),
+    ADD_STAT(pfPollution, "number of demand misses caused by hwpf "
+             "evictions"),
+    ADD_STAT(throttleUp, "number of times the aggressiveness was raised"),
+    ADD_STAT(throttleDown, "number of times the aggressiveness was lowered"),
+    ADD_STAT(aggressiveness, "average aggressiveness level"),
+    ADD_STAT(pfIssuedTier, "number of hwpf issued per memory tier"),
+    ADD_STAT(pfUsefulTier, "number of hwpf hit by a demand access per "
+             "memory tier"),
+    ADD_STAT(pfLateTier, "number of hwpf hit by a demand access in flight "
+             "per memory tier"),
+    ADD_STAT(accuracyTier, "fraction of the hwpf issued that were hit by a "
+             "demand access per memory tier")
 {
 }
 
+void
+Base::StatGroup::regStats()
+{
+    using namespace Stats;
+
+    Stats::Group::regStats();
+
+    for (auto *stat : {&pfIssuedTier, &pfUsefulTier, &pfLateTier}) {
+        stat->init(NumTiers)
+            .subname(LocalTier, "local")
+            .subname(FarTier, "far")
+            .flags(nozero);
+    }
+
+    accuracyTier.flags(nozero | nonan);
+    accuracyTier = pfUsefulTier / pfIssuedTier;
+    accuracyTier.subname(LocalTier, "local");
+    accuracyTier.subname(FarTier, "far");
+}
+
 
 bool
 Base::observeAccess(const PacketPtr &pkt, bool miss) const
@@ -195,6 +250,24 @@ Base::pageIthBlockAddress(Addr page, uint32_t blockIndex) const
     return page + (blockIndex << lBlkSize);
 }
 
+Base::Tier
+Base::tierOf(Addr paddr) const
+{
+    for (const auto &range : farRanges) {
+        if (range.contains(paddr))
+            return FarTier;
+    }
+    return LocalTier;
+}
+
+unsigned
+Base::tierDegree(unsigned degree, const PrefetchInfo &pfi) const
+{
+    if (farDegreeFactor > 1 && tierOf(pfi.getPaddr()) == FarTier)
+        return degree * farDegreeFactor;
+    return degree;
+}
+
 void
 Base::probeNotify(const PacketPtr &pkt, bool miss)
 {
@@ -209,6 +282,20 @@ Base::probeNotify(const PacketPtr &pkt, bool miss)
 
     if (hasBeenPrefetched(pkt->getAddr(), pkt->isSecure())) {
         usefulPrefetches += 1;
+        interval.useful += 1;
+        prefetchStats.pfUseful++;
+        prefetchStats.pfUsefulTier[tierOf(pkt->getAddr())]++;
+    }
+
+    if (throttling && miss) {
+        interval.demandMisses += 1;
+        const Addr blk_addr = blockAddress(pkt->getAddr());
+        if (pollutionFilter->isSet(blk_addr)) {
+            // the block was evicted by a prefetch and is back
+            pollutionFilter->unset(blk_addr);
+            prefetchStats.pfPollution++;
+            interval.pollution += 1;
+        }
     }
 
     // Verify this access type is observed by prefetcher
@@ -223,6 +310,90 @@ Base::probeNotify(const PacketPtr &pkt, bool miss)
     }
 }
 
+unsigned
+Base::throttle(unsigned value) const
+{
+    if (!throttling)
+        return value;
+    return std::max(1U, divCeil(value * aggressiveness, throttleLevels));
+}
+
+void
+Base::prefetchIssued(Addr addr)
+{
+    prefetchStats.pfIssued++;
+    prefetchStats.pfIssuedTier[tierOf(addr)]++;
+    issuedPrefetches += 1;
+    interval.issued += 1;
+}
+
+void
+Base::prefetchLate(Addr addr)
+{
+    prefetchStats.pfLate++;
+    prefetchStats.pfLateTier[tierOf(addr)]++;
+    interval.late += 1;
+}
+
+void
+Base::notifyEviction(Addr addr, bool by_prefetch)
+{
+    if (!throttling)
+        return;
+
+    if (by_prefetch)
+        pollutionFilter->set(blockAddress(addr));
+
+    if (++interval.evictions == throttleInterval)
+        updateAggressiveness();
+}
+
+void
+Base::updateAggressiveness()
+{
+    auto ratio = [](uint64_t num, uint64_t den) {
+        return den ? std::min(1.0, double(num) / den) : 0.0;
+    };
+    accuracy = (accuracy + ratio(interval.useful, interval.issued)) / 2;
+    lateness = (lateness + ratio(interval.late, interval.useful)) / 2;
+    pollution = (pollution +
+                 ratio(interval.pollution, interval.demandMisses)) / 2;
+    interval = ThrottleCounts();
+
+    const bool late = lateness > latenessThreshold;
+    const bool polluting = pollution > pollutionThreshold;
+
+    // Accurate prefetches are sent earlier when late, unless they also
+    // pollute; inaccurate ones are cut down when late or polluting
+    int change = 0;
+    if (accuracy >= accuracyHigh) {
+        if (late)
+            change = 1;
+        else if (polluting)
+            change = -1;
+    } else if (accuracy >= accuracyLow) {
+        if (late && !polluting)
+            change = 1;
+        else if (polluting)
+            change = -1;
+    } else if (late || polluting) {
+        change = -1;
+    }
+
+    if (change > 0 && aggressiveness < throttleLevels) {
+        aggressiveness++;
+        prefetchStats.throttleUp++;
+    } else if (change < 0 && aggressiveness > 1) {
+        aggressiveness--;
+        prefetchStats.throttleDown++;
+    }
+    prefetchStats.aggressiveness = aggressiveness;
+
+    DPRINTF(HWPrefetch, "Throttling: accuracy %.3f lateness %.3f "
+            "pollution %.3f, aggressiveness %d/%d\n", accuracy, lateness,
+            pollution, aggressiveness, throttleLevels);
+}
+
 void
 Base::regProbeListeners()
 {
@@ -49,6 +49,8 @@
 #include <cstdint>
 
 #include "arch/generic/tlb.hh"
+#include "base/addr_range.hh"
+#include "base/filters/base.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/packet.hh"
@@ -317,10 +319,118 @@ class Base : public ClockedObject
     Addr pageOffset(Addr a) const;
     /** Build the address of the i-th block inside the page */
     Addr pageIthBlockAddress(Addr page, uint32_t i) const;
+
+    /** Address ranges of the far memory tier, e.g., CXL memory */
+    const AddrRangeList farRanges;
+
+    /** Factor of the degree of the prefetches of far tier lines */
+    const unsigned farDegreeFactor;
+
+    /** Memory tiers that the prefetch stats are split by */
+    enum Tier
+    {
+        LocalTier,
+        FarTier,
+        NumTiers
+    };
+
+    /** Determine the memory tier of a physical address */
+    Tier tierOf(Addr paddr) const;
+
+    /**
+     * Scale the degree of a prefetcher to the memory tier of the access
+     * triggering the prefetches.
+     *
+     * @param degree The configured degree
+     * @param pfi The access triggering the prefetches
+     * @return The degree to use for this access
+     */
+    unsigned tierDegree(unsigned degree, const PrefetchInfo &pfi) const;
+
+    /** Adjust the aggressiveness from the feedback of the cache */
+    const bool throttling;
+
+    /** Number of evictions from the cache in a throttling interval */
+    const unsigned throttleInterval;
+
+    /** Number of aggressiveness levels */
+    const unsigned throttleLevels;
+
+    /** Thresholds of the accuracy, lateness and pollution */
+    const double accuracyHigh;
+    const double accuracyLow;
+    const double latenessThreshold;
+    const double pollutionThreshold;
+
+    /**
+     * Blocks evicted from the cache by prefetches. A demand miss for
+     * one of them is a miss caused by the prefetcher.
+     */
+    BloomFilter::Base *pollutionFilter;
+
+    /**
+     * Current aggressiveness, from 1 to throttleLevels. The highest
+     * level uses the configured degree and distance.
+     */
+    unsigned aggressiveness;
+
+    /** Events counted over the current throttling interval */
+    struct ThrottleCounts
+    {
+        uint64_t issued = 0;
+        uint64_t useful = 0;
+        uint64_t late = 0;
+        uint64_t demandMisses = 0;
+        uint64_t pollution = 0;
+        uint64_t evictions = 0;
+    } interval;
+
+    /**
+     * Feedback of the previous intervals, each interval weighs as much
+     * as all the ones before it.
+     */
+    double accuracy;
+    double lateness;
+    double pollution;
+
+    /**
+     * Scale a degree or a distance to the current aggressiveness.
+     *
+     * @param value The configured degree or distance
+     * @return The value to use, at least 1
+     */
+    unsigned throttle(unsigned value) const;
+
+    /**
+     * Count a prefetch sent to the cache.
+     *
+     * @param addr Address of the prefetch
+     */
+    void prefetchIssued(Addr addr);
+
+    /**
+     * Update the feedback at the end of an interval, and move the
+     * aggressiveness up or down following it.
+     */
+    void updateAggressiveness();
+
     struct StatGroup : public Stats::Group
     {
         StatGroup(Stats::Group *parent);
+        void regStats() override;
         Stats::Scalar pfIssued;
+        Stats::Scalar pfUseful;
+        Stats::Scalar pfLate;
+        Stats::Scalar pfPollution;
+        Stats::Scalar throttleUp;
+        Stats::Scalar throttleDown;
+        Stats::Average aggressiveness;
+
+        /** The issued, useful and late prefetches of each memory tier */
+        Stats::Vector pfIssuedTier;
+        Stats::Vector pfUsefulTier;
+        Stats::Vector pfLateTier;
+        Stats::Formula accuracyTier;
     } prefetchStats;
 
     /** Total prefetches issued */
@@ -347,6 +457,22 @@ class Base : public ClockedObject
     virtual void notifyFill(const PacketPtr &pkt)
     {}
 
+    /**
+     * Notify prefetcher of a demand access to a block that is being
+     * prefetched, i.e. of a prefetch that was useful but late.
+     *
+     * @param addr Address of the demand access
+     */
+    void prefetchLate(Addr addr);
+
+    /**
+     * Notify prefetcher of a block evicted from the cache.
+     *
+     * @param addr Address of the evicted block
+     * @param by_prefetch Whether the block makes room for a prefetch
+     */
+    void notifyEviction(Addr addr, bool by_prefetch);
+
     virtual PacketPtr getPacket() = 0;
 
     virtual Tick nextPrefetchReadyTime() const = 0;
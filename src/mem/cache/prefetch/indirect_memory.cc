@@ -86,7 +86,10 @@ IndirectMemory::calculatePrefetch(const PrefetchInfo &pfi,
                 pt_entry->streamCounter += 1;
                 if (pt_entry->streamCounter >= streamCounterThreshold) {
                     int64_t delta = addr - pt_entry->address;
-                    for (unsigned int i = 1; i <= streamingDistance; i += 1) {
+                    const unsigned streaming_distance =
+                        throttle(streamingDistance);
+                    for (unsigned int i = 1; i <= streaming_distance;
+                         i += 1) {
                         addresses.push_back(AddrPriority(addr + delta * i, 0));
                     }
                 }
@@ -137,7 +140,8 @@ IndirectMemory::calculatePrefetch(const PrefetchInfo &pfi,
 
                         // If the counter is high enough, start prefetching
                         if (pt_entry->indirectCounter > prefetchThreshold) {
-                            unsigned distance = maxPrefetchDistance *
+                            unsigned distance =
+                                throttle(maxPrefetchDistance) *
                                 pt_entry->indirectCounter.calcSaturation();
                             for (int delta = 1; delta < distance; delta += 1) {
                                 Addr pf_addr = pt_entry->baseAddr +
@@ -152,8 +152,10 @@ IrregularStreamBuffer::calculatePrefetch(const PrefetchInfo &pfi,
                 // The entry has been evicted, can not generate prefetches
                 return;
             }
+            const unsigned pf_degree = tierDegree(degree, pfi);
             for (unsigned d = 1;
-                    d <= degree && (sp_index + d) < prefetchCandidatesPerEntry;
+                    d <= pf_degree &&
+                    (sp_index + d) < prefetchCandidatesPerEntry;
                     d += 1)
             {
                 AddressMapping &spm = sp_am->mappings[sp_index + d];
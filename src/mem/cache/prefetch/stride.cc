@@ -163,7 +163,8 @@ Stride::calculatePrefetch(const PrefetchInfo &pfi,
         }
 
         // Generate up to degree prefetches
-        for (int d = 1; d <= degree; d++) {
+        const int pf_degree = tierDegree(degree, pfi);
+        for (int d = 1; d <= pf_degree; d++) {
             // Round strides up to atleast 1 cacheline
             int prefetch_stride = new_stride;
             if (abs(new_stride) < blkSize) {
@@ -49,7 +49,8 @@ Tagged::calculatePrefetch(const PrefetchInfo &pfi,
 {
     Addr blkAddr = blockAddress(pfi.getAddr());
 
-    for (int d = 1; d <= degree; d++) {
+    const int pf_degree = tierDegree(degree, pfi);
+    for (int d = 1; d <= pf_degree; d++) {
         Addr newAddr = blkAddr + d*(blkSize);
         addresses.push_back(AddrPriority(newAddr,0));
     }
@@ -48,6 +48,7 @@
 #include <cassert>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 
 #include "base/logging.hh"
 #include "base/trace.hh"
@@ -97,6 +98,32 @@ class Queue : public Drainable
     /** Holds non allocated entries. */
     typename Entry::List freeList;
 
+    /**
+     * Allocated entries hashed by their block address, each list in
+     * allocation order. Lookups only have to look at the entries of a
+     * single block instead of walking the whole allocated list.
+     */
+    std::unordered_map<Addr, typename Entry::List> matchIndex;
+
+    /**
+     * Add a newly allocated entry to the index, has to be called
+     * once its block address is set.
+     */
+    void addToMatchIndex(Entry* entry)
+    {
+        auto &matches = matchIndex[entry->blkAddr];
+        entry->matchIter = matches.insert(matches.end(), entry);
+    }
+
+    void removeFromMatchIndex(Entry* entry)
+    {
+        auto it = matchIndex.find(entry->blkAddr);
+        assert(it != matchIndex.end());
+        it->second.erase(entry->matchIter);
+        if (it->second.empty())
+            matchIndex.erase(it);
+    }
+
     typename Entry::Iterator addToReadyList(Entry* entry)
     {
         if (readyList.empty() ||
@@ -134,6 +161,7 @@ class Queue : public Drainable
         for (int i = 0; i < numEntries; ++i) {
             freeList.push_back(&entries[i]);
         }
+        matchIndex.reserve(numEntries);
     }
 
     bool isEmpty() const
@@ -162,7 +190,11 @@ class Queue : public Drainable
     Entry* findMatch(Addr blk_addr, bool is_secure,
                      bool ignore_uncacheable = true) const
     {
-        for (const auto& entry : allocatedList) {
+        auto it = matchIndex.find(blk_addr);
+        if (it == matchIndex.end())
+            return nullptr;
+
+        for (const auto& entry : it->second) {
             // we ignore any entries allocated for uncacheable
             // accesses and simply ignore them when matching, in the
             // cache we never check for matches when adding new
@@ -179,8 +211,17 @@ class Queue : public Drainable
 
     bool trySatisfyFunctional(PacketPtr pkt)
     {
+        if (allocatedList.empty())
+            return false;
+
+        // all the entries are for blocks of the same size
+        auto it = matchIndex.find(
+            pkt->getBlockAddr(allocatedList.front()->blkSize));
+        if (it == matchIndex.end())
+            return false;
+
         pkt->pushLabel(label);
-        for (const auto& entry : allocatedList) {
+        for (const auto& entry : it->second) {
             if (entry->matchBlockAddr(pkt) &&
                 entry->trySatisfyFunctional(pkt)) {
                 pkt->popLabel();
@@ -200,12 +241,26 @@ class Queue : public Drainable
      */
     Entry* findPending(const QueueEntry* entry) const
     {
-        for (const auto& ready_entry : readyList) {
-            if (ready_entry->conflictAddr(entry)) {
-                return ready_entry;
+        auto it = matchIndex.find(entry->blkAddr);
+        if (it == matchIndex.end())
+            return nullptr;
+
+        Entry* pending = nullptr;
+        for (const auto& match : it->second) {
+            if (!match->inService && match->conflictAddr(entry)) {
+                if (pending) {
+                    // more than one, only the ready list knows which
+                    // one is the earliest
+                    for (const auto& ready_entry : readyList) {
+                        if (ready_entry->conflictAddr(entry)) {
+                            return ready_entry;
+                        }
+                    }
+                }
+                pending = match;
             }
         }
-        return nullptr;
+        return pending;
     }
 
     /**
@@ -234,6 +289,7 @@ class Queue : public Drainable
     void deallocate(Entry *entry)
     {
         allocatedList.erase(entry->allocIter);
+        removeFromMatchIndex(entry);
         freeList.push_front(entry);
         allocated--;
         if (entry->inService) {
@@ -89,6 +89,33 @@ class NRURP(BRRIPRP):
     btp = 100
     num_bits = 1
 
+class SHiPRP(BRRIPRP):
+    type = 'SHiPRP'
+    cxx_class = 'SHiPRP'
+    cxx_header = "mem/cache/replacement_policies/ship_rp.hh"
+    num_bits = 2
+    hit_priority = True
+    shct_size = Param.Unsigned(16384, "Number of SHCT entries")
+    shct_bits = Param.Unsigned(3, "Number of bits per SHCT counter")
+
+class HawkeyeRP(BaseReplacementPolicy):
+    type = 'HawkeyeRP'
+    cxx_class = 'HawkeyeRP'
+    cxx_header = "mem/cache/replacement_policies/hawkeye_rp.hh"
+    num_bits = Param.Int(3, "Number of bits per RRPV")
+    predictor_size = Param.Unsigned(8192, "Number of predictor entries")
+    predictor_bits = Param.Unsigned(3, "Number of bits per predictor counter")
+    num_sampled_sets = Param.Unsigned(64, "Number of sets sampled by OPTgen")
+    history_factor = Param.Unsigned(8,
+        "Length of the OPTgen history, in multiples of the associativity")
+
+    # Geometry of the cache, for the sampler to find the set of a line
+    size = Param.MemorySize(Parent.size, "Capacity of the cache")
+    assoc = Param.Int(Parent.assoc, "Associativity of the cache")
+    entry_size = Param.Int(Parent.cache_line_size,
+        "Size of the entries of the cache, i.e. of the sectors with "
+        "sector tags")
+
 class TreePLRURP(BaseReplacementPolicy):
     type = 'TreePLRURP'
     cxx_class = 'TreePLRURP'
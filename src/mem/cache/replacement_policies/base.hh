@@ -32,6 +32,7 @@
 #include <memory>
 
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "mem/packet.hh"
 #include "params/BaseReplacementPolicy.hh"
 #include "sim/sim_object.hh"
 
@@ -77,6 +78,20 @@ class BaseReplacementPolicy : public SimObject
     virtual void touch(const std::shared_ptr<ReplacementData>&
                                                 replacement_data) const = 0;
 
+    /**
+     * Update replacement data with the access causing the update, for
+     * the policies that learn from the accesses, e.g. from their PC.
+     * By default the access is ignored.
+     *
+     * @param replacement_data Replacement data to be touched.
+     * @param pkt Packet of the access.
+     */
+    virtual void touch(const std::shared_ptr<ReplacementData>&
+                       replacement_data, const PacketPtr pkt) const
+    {
+        touch(replacement_data);
+    }
+
     /**
      * Reset replacement data. Used when it's holder is inserted/validated.
      *
@@ -85,6 +100,19 @@ class BaseReplacementPolicy : public SimObject
     virtual void reset(const std::shared_ptr<ReplacementData>&
                                                 replacement_data) const = 0;
 
+    /**
+     * Reset replacement data with the access that caused the insertion.
+     * By default the access is ignored.
+     *
+     * @param replacement_data Replacement data to be reset.
+     * @param pkt Packet of the access.
+     */
+    virtual void reset(const std::shared_ptr<ReplacementData>&
+                       replacement_data, const PacketPtr pkt) const
+    {
+        reset(replacement_data);
+    }
+
     /**
      * Find replacement victim among candidates.
      *
@@ -94,6 +122,21 @@ class BaseReplacementPolicy : public SimObject
     virtual ReplaceableEntry* getVictim(
                            const ReplacementCandidates& candidates) const = 0;
 
+    /**
+     * Find the entry that getVictim() would pick among candidates,
+     * without updating any replacement state, e.g. to rank the entries
+     * of a set ahead of their eviction. Policies whose getVictim() has
+     * side effects must override it.
+     *
+     * @param candidates Replacement candidates, selected by indexing policy.
+     * @return Replacement entry that would be replaced.
+     */
+    virtual ReplaceableEntry* peekVictim(
+                           const ReplacementCandidates& candidates) const
+    {
+        return getVictim(candidates);
+    }
+
     /**
      * Instantiate a replacement data entry.
      *
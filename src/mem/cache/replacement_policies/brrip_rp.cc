@@ -88,7 +88,7 @@ BRRIPRP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 }
 
 ReplaceableEntry*
-BRRIPRP::getVictim(const ReplacementCandidates& candidates) const
+BRRIPRP::peekVictim(const ReplacementCandidates& candidates) const
 {
     // There must be at least one replacement candidate
     assert(candidates.size() > 0);
@@ -119,6 +119,20 @@ BRRIPRP::getVictim(const ReplacementCandidates& candidates) const
         }
     }
 
+    return victim;
+}
+
+ReplaceableEntry*
+BRRIPRP::getVictim(const ReplacementCandidates& candidates) const
+{
+    ReplaceableEntry* victim = peekVictim(candidates);
+
+    // An invalid entry is replaced as is
+    if (!std::static_pointer_cast<BRRIPReplData>(
+            victim->replacementData)->valid) {
+        return victim;
+    }
+
     // Get difference of victim's RRPV to the highest possible RRPV in
     // order to update the RRPV of all the other entries accordingly
     int diff = std::static_pointer_cast<BRRIPReplData>(
@@ -154,6 +154,16 @@ class BRRIPRP : public BaseReplacementPolicy
     ReplaceableEntry* getVictim(const ReplacementCandidates& candidates) const
                                                                      override;
 
+    /**
+     * Find replacement victim using rrpv, without aging the other
+     * candidates.
+     *
+     * @param candidates Replacement candidates, selected by indexing policy.
+     * @return Replacement entry that would be replaced.
+     */
+    ReplaceableEntry* peekVictim(const ReplacementCandidates& candidates) const
+                                                                     override;
+
     /**
      * Instantiate a replacement data entry.
      *
@@ -0,0 +1,258 @@
+#include "mem/cache/replacement_policies/hawkeye_rp.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+#include "base/intmath.hh"
+#include "base/logging.hh" // For fatal_if
+#include "params/HawkeyeRP.hh"
+
+HawkeyeRP::HawkeyeRP(const Params *p)
+    : BaseReplacementPolicy(p), numRRPVBits(p->num_bits), assoc(p->assoc),
+      numSets(p->size / (p->assoc * p->entry_size)),
+      entrySize(p->entry_size), historyLength(p->history_factor * assoc),
+      samplingStride(std::max(1U, numSets / p->num_sampled_sets)),
+      predictor(p->predictor_size,
+                SatCounter(p->predictor_bits, 1 << (p->predictor_bits - 1)))
+{
+    fatal_if(numRRPVBits < 2, "Hawkeye needs at least two bits per RRPV.\n");
+    fatal_if(numSets == 0, "The cache must have at least one set.\n");
+    fatal_if(!isPowerOf2(p->predictor_size),
+             "The predictor size must be a power of 2.\n");
+
+    sampler.resize(divCeil(numSets, samplingStride),
+                   SampledSet(historyLength));
+}
+
+unsigned
+HawkeyeRP::getSignature(const PacketPtr pkt) const
+{
+    uint64_t sig = pkt->req->hasPC() ? pkt->req->getPC() :
+                                       pkt->getAddr() >> 14;
+
+    // Prefetches are predicted separately from demand accesses
+    if (pkt->cmd.isHWPrefetch() || pkt->req->isPrefetch()) {
+        sig = ~sig;
+    }
+
+    sig *= ULL(0x9E3779B97F4A7C15);
+    return (sig >> 32) & (predictor.size() - 1);
+}
+
+bool
+HawkeyeRP::isFriendly(unsigned signature) const
+{
+    // The most significant bit of the counter
+    return predictor[signature].calcSaturation() >= 0.5;
+}
+
+void
+HawkeyeRP::sample(const PacketPtr pkt, unsigned signature) const
+{
+    const Addr tag = pkt->getAddr() / entrySize;
+    const unsigned set = tag % numSets;
+    if (set % samplingStride) {
+        return;
+    }
+
+    SampledSet &sampled_set = sampler[set / samplingStride];
+    const uint64_t now = sampled_set.time++;
+    sampled_set.occupancy[now % historyLength] = 0;
+
+    // Look for the previous access to the line, or for the oldest line
+    // to make room for it
+    SampledLine *line = nullptr;
+    SampledLine *oldest = &sampled_set.lines[0];
+    for (auto &sampled_line : sampled_set.lines) {
+        if (sampled_line.valid && sampled_line.tag == tag) {
+            line = &sampled_line;
+            break;
+        }
+        if (oldest->valid &&
+            (!sampled_line.valid || sampled_line.time < oldest->time)) {
+            oldest = &sampled_line;
+        }
+    }
+
+    if (line) {
+        // OPT keeps the line since its previous access if the cache had
+        // room for it over the whole interval
+        bool opt_hit = now - line->time < historyLength;
+        for (uint64_t t = line->time; opt_hit && t < now; t++) {
+            opt_hit = sampled_set.occupancy[t % historyLength] < assoc;
+        }
+
+        if (opt_hit) {
+            for (uint64_t t = line->time; t < now; t++) {
+                sampled_set.occupancy[t % historyLength]++;
+            }
+            predictor[line->signature]++;
+        } else {
+            predictor[line->signature]--;
+        }
+    } else {
+        // A line leaving the history was not reused within it
+        line = oldest;
+        if (line->valid) {
+            predictor[line->signature]--;
+        }
+    }
+
+    line->tag = tag;
+    line->time = now;
+    line->signature = signature;
+    line->valid = true;
+}
+
+void
+HawkeyeRP::access(const std::shared_ptr<ReplacementData>& data,
+                  const PacketPtr pkt) const
+{
+    std::shared_ptr<HawkeyeReplData> casted_replacement_data =
+        std::static_pointer_cast<HawkeyeReplData>(data);
+
+    const unsigned signature = getSignature(pkt);
+    sample(pkt, signature);
+
+    casted_replacement_data->signature = signature;
+    casted_replacement_data->trains = true;
+    casted_replacement_data->valid = true;
+    if (isFriendly(signature)) {
+        casted_replacement_data->rrpv.reset();
+    } else {
+        casted_replacement_data->rrpv.saturate();
+    }
+}
+
+void
+HawkeyeRP::invalidate(const std::shared_ptr<ReplacementData>&
+                      replacement_data) const
+{
+    std::static_pointer_cast<HawkeyeReplData>(
+        replacement_data)->valid = false;
+}
+
+void
+HawkeyeRP::touch(const std::shared_ptr<ReplacementData>& replacement_data)
+const
+{
+    std::static_pointer_cast<HawkeyeReplData>(
+        replacement_data)->rrpv.reset();
+}
+
+void
+HawkeyeRP::touch(const std::shared_ptr<ReplacementData>& replacement_data,
+                 const PacketPtr pkt) const
+{
+    // Writebacks hitting in the cache say nothing about the reuse of
+    // the line by the program
+    if (pkt->isWriteback()) {
+        return;
+    }
+
+    access(replacement_data, pkt);
+}
+
+void
+HawkeyeRP::reset(const std::shared_ptr<ReplacementData>& replacement_data)
+const
+{
+    std::shared_ptr<HawkeyeReplData> casted_replacement_data =
+        std::static_pointer_cast<HawkeyeReplData>(replacement_data);
+
+    casted_replacement_data->rrpv.reset();
+    casted_replacement_data->trains = false;
+    casted_replacement_data->valid = true;
+}
+
+void
+HawkeyeRP::reset(const std::shared_ptr<ReplacementData>& replacement_data,
+                 const PacketPtr pkt) const
+{
+    // Writebacks are inserted as averse, without training
+    if (pkt->isWriteback()) {
+        std::shared_ptr<HawkeyeReplData> casted_replacement_data =
+            std::static_pointer_cast<HawkeyeReplData>(replacement_data);
+        casted_replacement_data->rrpv.saturate();
+        casted_replacement_data->trains = false;
+        casted_replacement_data->valid = true;
+        return;
+    }
+
+    access(replacement_data, pkt);
+}
+
+ReplaceableEntry*
+HawkeyeRP::peekVictim(const ReplacementCandidates& candidates) const
+{
+    // There must be at least one replacement candidate
+    assert(candidates.size() > 0);
+
+    // Pick the entry with the most distant re-reference
+    ReplaceableEntry* victim = candidates[0];
+    int victim_RRPV = -1;
+    for (const auto& candidate : candidates) {
+        std::shared_ptr<HawkeyeReplData> candidate_repl_data =
+            std::static_pointer_cast<HawkeyeReplData>(
+                candidate->replacementData);
+
+        // Stop searching for victims if an invalid entry is found
+        if (!candidate_repl_data->valid) {
+            return candidate;
+        }
+
+        int candidate_RRPV = candidate_repl_data->rrpv;
+        if (candidate_RRPV > victim_RRPV) {
+            victim = candidate;
+            victim_RRPV = candidate_RRPV;
+        }
+    }
+
+    return victim;
+}
+
+ReplaceableEntry*
+HawkeyeRP::getVictim(const ReplacementCandidates& candidates) const
+{
+    ReplaceableEntry* victim = peekVictim(candidates);
+
+    // An invalid entry is replaced as is
+    std::shared_ptr<HawkeyeReplData> victim_repl_data =
+        std::static_pointer_cast<HawkeyeReplData>(victim->replacementData);
+    if (!victim_repl_data->valid) {
+        return victim;
+    }
+
+    // Evicting a friendly entry means that its signature was wrong
+    if (!victim_repl_data->rrpv.isSaturated() && victim_repl_data->trains) {
+        predictor[victim_repl_data->signature]--;
+    }
+
+    // Age the other friendly entries, which never become averse
+    const int max_friendly_RRPV = (1 << numRRPVBits) - 2;
+    for (const auto& candidate : candidates) {
+        std::shared_ptr<HawkeyeReplData> candidate_repl_data =
+            std::static_pointer_cast<HawkeyeReplData>(
+                candidate->replacementData);
+        if (candidate != victim &&
+            candidate_repl_data->rrpv < max_friendly_RRPV) {
+            candidate_repl_data->rrpv++;
+        }
+    }
+
+    return victim;
+}
+
+std::shared_ptr<ReplacementData>
+HawkeyeRP::instantiateEntry()
+{
+    return std::shared_ptr<ReplacementData>(
+        new HawkeyeReplData(numRRPVBits));
+}
+
+HawkeyeRP*
+HawkeyeRPParams::create()
+{
+    return new HawkeyeRP(this);
+}
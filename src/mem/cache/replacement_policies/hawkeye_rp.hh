@@ -0,0 +1,242 @@
+/**
+ * @file
+ * Declaration of the Hawkeye replacement policy.
+ *
+ * Hawkeye learns from Belady's optimal policy applied to past accesses.
+ * A few sampled sets keep a history of their recent accesses, and
+ * OPTgen replays it to find out whether OPT would have kept a line
+ * between two consecutive accesses to it. The outcome trains a table
+ * of saturating counters indexed by a signature of the PC of the
+ * earlier access, which then predicts whether the lines brought in or
+ * hit by an access are cache-friendly or cache-averse.
+ *
+ * Averse lines are inserted with the most distant RRPV, so they are the
+ * first victims. Friendly lines are inserted and promoted to RRPV 0 and
+ * age while the set sees misses; evicting a friendly line detrains its
+ * signature, as it was wrongly predicted to be reused.
+ *
+ * The sampler assumes the usual modulo set indexing on entries of
+ * entry_size bytes, i.e. the sector size when used with sector tags.
+ *
+ * @see Jain and Lin, "Back to the Future: Leveraging Belady's Algorithm
+ * for Improved Cache Replacement", ISCA 2016.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_HAWKEYE_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_HAWKEYE_RP_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/sat_counter.hh"
+#include "base/types.hh"
+#include "mem/cache/replacement_policies/base.hh"
+
+struct HawkeyeRPParams;
+
+class HawkeyeRP : public BaseReplacementPolicy
+{
+  protected:
+    /** Hawkeye-specific implementation of replacement data. */
+    struct HawkeyeReplData : ReplacementData
+    {
+        /** Re-Reference Interval Prediction Value. */
+        SatCounter rrpv;
+
+        /** Signature of the last access to the entry. */
+        unsigned signature;
+
+        /** Whether the signature is used to detrain on eviction. */
+        bool trains;
+
+        /** Whether the entry is valid. */
+        bool valid;
+
+        HawkeyeReplData(const int num_bits)
+            : rrpv(num_bits), signature(0), trains(false), valid(false)
+        {
+        }
+    };
+
+    /** A line of the access history of a sampled set. */
+    struct SampledLine
+    {
+        /** Address of the line, in entries. */
+        Addr tag = 0;
+
+        /** Time of the last access, in accesses to the set. */
+        uint64_t time = 0;
+
+        /** Signature of the last access. */
+        unsigned signature = 0;
+
+        bool valid = false;
+    };
+
+    /** A sampled set and its OPTgen. */
+    struct SampledSet
+    {
+        SampledSet(unsigned history)
+            : time(0), occupancy(history, 0), lines(history)
+        {
+        }
+
+        /** Number of accesses to the set so far. */
+        uint64_t time;
+
+        /**
+         * Number of lines OPT keeps in the cache over each of the last
+         * accesses, indexed by time modulo the history length.
+         */
+        std::vector<unsigned> occupancy;
+
+        /** The lines accessed during the history. */
+        std::vector<SampledLine> lines;
+    };
+
+    /** Number of RRPV bits. */
+    const unsigned numRRPVBits;
+
+    /** Associativity of the cache. */
+    const unsigned assoc;
+
+    /** Number of sets of the cache. */
+    const unsigned numSets;
+
+    /** Size of the entries of the cache. */
+    const unsigned entrySize;
+
+    /** Number of accesses of a set OPTgen looks back over. */
+    const unsigned historyLength;
+
+    /** One in every samplingStride sets is sampled. */
+    const unsigned samplingStride;
+
+    /** The signature counters predicting if accesses are friendly. */
+    mutable std::vector<SatCounter> predictor;
+
+    /** The sampled sets. */
+    mutable std::vector<SampledSet> sampler;
+
+    /**
+     * Get the predictor index of an access.
+     *
+     * @param pkt Packet of the access.
+     * @return The signature of the access.
+     */
+    unsigned getSignature(const PacketPtr pkt) const;
+
+    /**
+     * Whether the lines of the signature are predicted to be reused
+     * before OPT would evict them.
+     */
+    bool isFriendly(unsigned signature) const;
+
+    /**
+     * Record an access in the sampler if its set is sampled, and train
+     * the predictor with what OPT did with the previous access to the
+     * same line.
+     *
+     * @param pkt Packet of the access.
+     * @param signature Signature of the access.
+     */
+    void sample(const PacketPtr pkt, unsigned signature) const;
+
+    /**
+     * Update an entry on an access that hits or inserts it.
+     *
+     * @param data Replacement data of the entry.
+     * @param pkt Packet of the access.
+     */
+    void access(const std::shared_ptr<ReplacementData>& data,
+                const PacketPtr pkt) const;
+
+  public:
+    /** Convenience typedef. */
+    typedef HawkeyeRPParams Params;
+
+    /**
+     * Construct and initiliaze this replacement policy.
+     */
+    HawkeyeRP(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~HawkeyeRP() {}
+
+    /**
+     * Invalidate replacement data to set it as the next probable victim.
+     *
+     * @param replacement_data Replacement data to be invalidated.
+     */
+    void invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+                                                              const override;
+
+    /**
+     * Touch an entry without knowing the access. It is handled as a
+     * friendly access that does not train.
+     *
+     * @param replacement_data Replacement data to be touched.
+     */
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data) const
+                                                                     override;
+
+    /**
+     * Touch an entry, which is given the RRPV predicted for the access.
+     *
+     * @param replacement_data Replacement data to be touched.
+     * @param pkt Packet of the access.
+     */
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt) const override;
+
+    /**
+     * Reset replacement data without knowing the access. It is handled
+     * as a friendly access that does not train.
+     *
+     * @param replacement_data Replacement data to be reset.
+     */
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data) const
+                                                                     override;
+
+    /**
+     * Reset replacement data, which is given the RRPV predicted for the
+     * access.
+     *
+     * @param replacement_data Replacement data to be reset.
+     * @param pkt Packet of the access.
+     */
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt) const override;
+
+    /**
+     * Find replacement victim. Averse entries go first, otherwise the
+     * oldest friendly entry is evicted and its signature detrained.
+     * The other friendly entries age.
+     *
+     * @param candidates Replacement candidates, selected by indexing policy.
+     * @return Replacement entry to be replaced.
+     */
+    ReplaceableEntry* getVictim(const ReplacementCandidates& candidates) const
+                                                                     override;
+
+    /**
+     * Find replacement victim with the most distant re-reference,
+     * without detraining its signature or aging the other entries.
+     *
+     * @param candidates Replacement candidates, selected by indexing policy.
+     * @return Replacement entry that would be replaced.
+     */
+    ReplaceableEntry* peekVictim(const ReplacementCandidates& candidates) const
+                                                                     override;
+
+    /**
+     * Instantiate a replacement data entry.
+     *
+     * @return A shared pointer to the new replacement data.
+     */
+    std::shared_ptr<ReplacementData> instantiateEntry() override;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_HAWKEYE_RP_HH__
@@ -84,6 +84,24 @@ RandomRP::getVictim(const ReplacementCandidates& candidates) const
     return victim;
 }
 
+ReplaceableEntry*
+RandomRP::peekVictim(const ReplacementCandidates& candidates) const
+{
+    // There must be at least one replacement candidate
+    assert(candidates.size() > 0);
+
+    // Invalid entries have the eviction priority, otherwise pick the
+    // first candidate
+    for (const auto& candidate : candidates) {
+        if (!std::static_pointer_cast<RandomReplData>(
+                    candidate->replacementData)->valid) {
+            return candidate;
+        }
+    }
+
+    return candidates[0];
+}
+
 std::shared_ptr<ReplacementData>
 RandomRP::instantiateEntry()
 {
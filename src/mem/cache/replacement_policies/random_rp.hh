@@ -107,6 +107,16 @@ class RandomRP : public BaseReplacementPolicy
     ReplaceableEntry* getVictim(const ReplacementCandidates& candidates) const
                                                                      override;
 
+    /**
+     * Find a replacement victim without drawing a random number, as
+     * any valid candidate is as likely to be replaced as another.
+     *
+     * @param candidates Replacement candidates, selected by indexing policy.
+     * @return Replacement entry that would be replaced.
+     */
+    ReplaceableEntry* peekVictim(const ReplacementCandidates& candidates) const
+                                                                     override;
+
     /**
      * Instantiate a replacement data entry.
      *
@@ -125,6 +125,38 @@ SecondChanceRP::getVictim(const ReplacementCandidates& candidates) const
     return victim;
 }
 
+ReplaceableEntry*
+SecondChanceRP::peekVictim(const ReplacementCandidates& candidates) const
+{
+    // There must be at least one replacement candidate
+    assert(candidates.size() > 0);
+
+    // The FIFO search re-inserts the entries with a second chance, so
+    // the victim is the oldest entry without one. If they all have
+    // one, they are all re-inserted, and the first candidate goes
+    ReplaceableEntry* victim = nullptr;
+    for (const auto& candidate : candidates) {
+        std::shared_ptr<SecondChanceReplData> candidate_replacement_data =
+            std::static_pointer_cast<SecondChanceReplData>(
+                candidate->replacementData);
+
+        // Invalid entries have the eviction priority
+        if ((candidate_replacement_data->tickInserted == Tick(0)) &&
+            !candidate_replacement_data->hasSecondChance) {
+            return candidate;
+        }
+
+        if (!candidate_replacement_data->hasSecondChance &&
+            (!victim || candidate_replacement_data->tickInserted <
+             std::static_pointer_cast<SecondChanceReplData>(
+                 victim->replacementData)->tickInserted)) {
+            victim = candidate;
+        }
+    }
+
+    return victim ? victim : candidates[0];
+}
+
 std::shared_ptr<ReplacementData>
 SecondChanceRP::instantiateEntry()
 {
@@ -122,6 +122,16 @@ class SecondChanceRP : public FIFORP
     ReplaceableEntry* getVictim(const ReplacementCandidates& candidates) const
                                                                      override;
 
+    /**
+     * Find replacement victim using insertion timestamps and second chance
+     * bit, without using up any second chance.
+     *
+     * @param candidates Replacement candidates, selected by indexing policy.
+     * @return Replacement entry that would be replaced.
+     */
+    ReplaceableEntry* peekVictim(const ReplacementCandidates& candidates) const
+                                                                     override;
+
     /**
      * Instantiate a replacement data entry.
      *
@@ -0,0 +1,138 @@
+#include "mem/cache/replacement_policies/ship_rp.hh"
+
+#include <cassert>
+#include <memory>
+
+#include "base/intmath.hh"
+#include "base/logging.hh" // For fatal_if
+#include "params/SHiPRP.hh"
+
+SHiPRP::SHiPRP(const Params *p)
+    : BRRIPRP(p), SHCT(p->shct_size, SatCounter(p->shct_bits, 1))
+{
+    fatal_if(!isPowerOf2(p->shct_size),
+             "The SHCT size must be a power of 2.\n");
+}
+
+unsigned
+SHiPRP::getSignature(const PacketPtr pkt) const
+{
+    // Accesses without a PC use the 16kB region of their address, as in
+    // the memory region signatures of SHiP
+    uint64_t sig = pkt->req->hasPC() ? pkt->req->getPC() :
+                                       pkt->getAddr() >> 14;
+
+    // Prefetches train their own counters
+    if (pkt->cmd.isHWPrefetch() || pkt->req->isPrefetch()) {
+        sig = ~sig;
+    }
+
+    // Fold the signature with a multiplicative hash
+    sig *= ULL(0x9E3779B97F4A7C15);
+    return (sig >> 32) & (SHCT.size() - 1);
+}
+
+void
+SHiPRP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+const
+{
+    std::shared_ptr<SHiPReplData> casted_replacement_data =
+        std::static_pointer_cast<SHiPReplData>(replacement_data);
+
+    // An entry that leaves without being re-referenced was dead on
+    // insertion
+    if (casted_replacement_data->valid && casted_replacement_data->trains &&
+        !casted_replacement_data->outcome) {
+        SHCT[casted_replacement_data->signature]--;
+    }
+
+    BRRIPRP::invalidate(replacement_data);
+}
+
+void
+SHiPRP::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
+{
+    BRRIPRP::touch(replacement_data);
+}
+
+void
+SHiPRP::touch(const std::shared_ptr<ReplacementData>& replacement_data,
+              const PacketPtr pkt) const
+{
+    std::shared_ptr<SHiPReplData> casted_replacement_data =
+        std::static_pointer_cast<SHiPReplData>(replacement_data);
+
+    // Prefetches hitting in the cache do not make the entry any more
+    // likely to be used by a demand access
+    if (pkt->cmd.isHWPrefetch() || pkt->req->isPrefetch()) {
+        return;
+    }
+
+    // Only the first re-reference trains, so that a few very hot
+    // entries do not saturate the counter of their signature
+    if (!casted_replacement_data->outcome) {
+        casted_replacement_data->outcome = true;
+        if (casted_replacement_data->trains) {
+            SHCT[casted_replacement_data->signature]++;
+        }
+    }
+
+    casted_replacement_data->rrpv.reset();
+}
+
+void
+SHiPRP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
+{
+    std::shared_ptr<SHiPReplData> casted_replacement_data =
+        std::static_pointer_cast<SHiPReplData>(replacement_data);
+
+    casted_replacement_data->rrpv.saturate();
+    casted_replacement_data->rrpv--;
+    casted_replacement_data->outcome = false;
+    casted_replacement_data->trains = false;
+    casted_replacement_data->valid = true;
+}
+
+void
+SHiPRP::reset(const std::shared_ptr<ReplacementData>& replacement_data,
+              const PacketPtr pkt) const
+{
+    std::shared_ptr<SHiPReplData> casted_replacement_data =
+        std::static_pointer_cast<SHiPReplData>(replacement_data);
+
+    casted_replacement_data->outcome = false;
+    casted_replacement_data->valid = true;
+    casted_replacement_data->rrpv.saturate();
+
+    // Writebacks are inserted with a distant re-reference, and are not
+    // used to learn about the signatures
+    if (pkt->isWriteback()) {
+        casted_replacement_data->trains = false;
+        return;
+    }
+
+    const unsigned signature = getSignature(pkt);
+    casted_replacement_data->signature = signature;
+    casted_replacement_data->trains = true;
+
+    // Entries of signatures that never get re-referenced stay distant,
+    // the ones of signatures that always do are near-immediate, and
+    // everything else is long
+    if (SHCT[signature].isSaturated()) {
+        casted_replacement_data->rrpv.reset();
+    } else if (SHCT[signature] != 0) {
+        casted_replacement_data->rrpv--;
+    }
+}
+
+std::shared_ptr<ReplacementData>
+SHiPRP::instantiateEntry()
+{
+    return std::shared_ptr<ReplacementData>(new SHiPReplData(numRRPVBits));
+}
+
+SHiPRP*
+SHiPRPParams::create()
+{
+    return new SHiPRP(this);
+}
@@ -0,0 +1,135 @@
+/**
+ * @file
+ * Declaration of a Signature-based Hit Predictor replacement policy.
+ *
+ * SHiP extends RRIP by predicting the re-reference interval of an entry
+ * at insertion from a signature of the access that brought it in, here
+ * a hash of its PC. A table of saturating counters, the Signature
+ * History Counter Table (SHCT), learns whether the entries inserted by
+ * each signature get re-referenced before they are evicted.
+ *
+ * This implements the SHiP++ refinements: the SHCT is only trained by
+ * the first re-reference of an entry, entries of highly reusable
+ * signatures are inserted with a near-immediate re-reference interval,
+ * writebacks are inserted with a distant one and do not train, and
+ * prefetches use signatures of their own.
+ *
+ * @see Wu et al., "SHiP: Signature-based Hit Predictor for High
+ * Performance Caching", MICRO 2011, and Young et al., "SHiP++: Enhancing
+ * Signature-Based Hit Predictor for Improved Cache Performance", CRC2
+ * 2017.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_SHIP_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_SHIP_RP_HH__
+
+#include <vector>
+
+#include "base/sat_counter.hh"
+#include "mem/cache/replacement_policies/brrip_rp.hh"
+
+struct SHiPRPParams;
+
+class SHiPRP : public BRRIPRP
+{
+  protected:
+    /** SHiP-specific implementation of replacement data. */
+    struct SHiPReplData : BRRIPReplData
+    {
+        /** Signature of the access that inserted the entry. */
+        unsigned signature;
+
+        /** Whether the entry has been re-referenced since insertion. */
+        bool outcome;
+
+        /** Whether the entry trains the SHCT. */
+        bool trains;
+
+        SHiPReplData(const int num_bits)
+            : BRRIPReplData(num_bits), signature(0), outcome(false),
+              trains(false)
+        {
+        }
+    };
+
+    /** The Signature History Counter Table. */
+    mutable std::vector<SatCounter> SHCT;
+
+    /**
+     * Get the SHCT index of an access.
+     *
+     * @param pkt Packet of the access.
+     * @return The signature of the access.
+     */
+    unsigned getSignature(const PacketPtr pkt) const;
+
+  public:
+    /** Convenience typedef. */
+    typedef SHiPRPParams Params;
+
+    /**
+     * Construct and initiliaze this replacement policy.
+     */
+    SHiPRP(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~SHiPRP() {}
+
+    /**
+     * Invalidate replacement data. An entry that has not been
+     * re-referenced since its insertion lowers the counter of its
+     * signature.
+     *
+     * @param replacement_data Replacement data to be invalidated.
+     */
+    void invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+                                                              const override;
+
+    /**
+     * Touch an entry without knowing the access, as RRIP does.
+     *
+     * @param replacement_data Replacement data to be touched.
+     */
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data) const
+                                                                     override;
+
+    /**
+     * Touch an entry. The first demand re-reference of an entry raises
+     * the counter of its signature.
+     *
+     * @param replacement_data Replacement data to be touched.
+     * @param pkt Packet of the access.
+     */
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt) const override;
+
+    /**
+     * Reset replacement data without knowing the access. The entry is
+     * inserted with a long re-reference interval and does not train.
+     *
+     * @param replacement_data Replacement data to be reset.
+     */
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data) const
+                                                                     override;
+
+    /**
+     * Reset replacement data. The RRPV of the entry is predicted from
+     * the counter of the signature of the access.
+     *
+     * @param replacement_data Replacement data to be reset.
+     * @param pkt Packet of the access.
+     */
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt) const override;
+
+    /**
+     * Instantiate a replacement data entry.
+     *
+     * @return A shared pointer to the new replacement data.
+     */
+    std::shared_ptr<ReplacementData> instantiateEntry() override;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_SHIP_RP_HH__
@@ -38,6 +38,17 @@ from m5.proxy import *
 from m5.objects.ClockedObject import ClockedObject
 from m5.objects.IndexingPolicies import *
 
+# Which way is probed first on a lookup: none probes all of them at once,
+# mru the last one hit or filled in the set, and pc the last one hit or
+# filled by the instruction, falling back to mru without a PC
+class WayPrediction(ScopedEnum): vals = ['none', 'mru', 'pc']
+
+# How the cache is divided between partitions of requestors, as with
+# Intel CAT: none shares all of it, and way gives each partition a mask of
+# the ways it can allocate in. The sets are rather partitioned by colouring
+# the pages of each partition, as the set of a block is given by its address
+class CachePartitioning(ScopedEnum): vals = ['none', 'way']
+
 class BaseTags(ClockedObject):
     type = 'BaseTags'
     abstract = True
@@ -63,6 +74,21 @@ class BaseTags(ClockedObject):
     sequential_access = Param.Bool(Parent.sequential_access,
         "Whether to access tags and data sequentially")
 
+    # Get the access energies from the parent (cache)
+    tag_access_energy = Param.Float(Parent.tag_access_energy,
+        "Dynamic energy of reading one tag, in pJ")
+    data_access_energy = Param.Float(Parent.data_access_energy,
+        "Dynamic energy of reading one data block, in pJ")
+
+    # Get the partitioning from the parent (cache)
+    partitioning = Param.CachePartitioning(Parent.partitioning,
+        "Whether the partitions are given ways")
+    partition_masks = VectorParam.UInt64(Parent.partition_masks,
+        "Ways each partition can allocate in")
+    partition_requestors = VectorParam.String(Parent.partition_requestors,
+        "Space separated name prefixes of the requestors of each "
+        "partition; the other requestors are in partition 0")
+
     # Get indexing policy
     indexing_policy = Param.BaseIndexingPolicy(SetAssociative(),
         "Indexing policy")
@@ -82,6 +108,14 @@ class BaseSetAssoc(BaseTags):
     replacement_policy = Param.BaseReplacementPolicy(
         Parent.replacement_policy, "Replacement policy")
 
+    # Get the way predictor from the parent (cache)
+    way_prediction = Param.WayPrediction(Parent.way_prediction,
+        "Way predictor used to probe a single way first")
+    way_mispredict_penalty = Param.Cycles(Parent.way_mispredict_penalty,
+        "Extra lookup latency when the predicted way does not hit")
+    way_predictor_entries = Param.Unsigned(256,
+        "Number of entries of the PC-indexed way predictor")
+
 class SectorTags(BaseTags):
     type = 'SectorTags'
     cxx_header = "mem/cache/tags/sector_tags.hh"
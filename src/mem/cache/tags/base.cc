@@ -45,26 +45,102 @@
 
 #include "mem/cache/tags/base.hh"
 
+#include <algorithm>
 #include <cassert>
 
+#include "base/bitfield.hh"
+#include "base/str.hh"
 #include "base/types.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
 #include "mem/request.hh"
 #include "sim/core.hh"
 #include "sim/sim_exit.hh"
+#include "sim/stat_control.hh"
 #include "sim/system.hh"
 
 BaseTags::BaseTags(const Params *p)
     : ClockedObject(p), blkSize(p->block_size), blkMask(blkSize - 1),
       size(p->size), lookupLatency(p->tag_latency),
+      tagAccessEnergy(p->tag_access_energy),
+      dataAccessEnergy(p->data_access_energy),
       system(p->system), indexingPolicy(p->indexing_policy),
       warmupBound((p->warmup_percentage/100.0) * (p->size / p->block_size)),
       warmedUp(false), numBlocks(p->size / p->block_size),
       dataBlks(new uint8_t[p->size]), // Allocate data storage in one big chunk
+      partitioning(p->partitioning), partitionMasks(p->partition_masks),
+      partitionRequestors(p->partition_requestors),
+      numPartitions(std::max<std::size_t>(1, partitionRequestors.size())),
       stats(*this)
 {
     registerExitCallback([this]() { cleanupRefs(); });
+
+    fatal_if(partitioning != CachePartitioning::none &&
+             partitionMasks.size() != numPartitions,
+             "%s: each of the %d partitions needs a mask", name(),
+             numPartitions);
+}
+
+void
+BaseTags::init()
+{
+    ClockedObject::init();
+
+    // A requestor belongs to the first partition listing a prefix of its
+    // name, and to partition 0 if none does
+    requestorPartitions.assign(system->maxRequestors(), 0);
+    for (RequestorID id = 0; id < system->maxRequestors(); id++) {
+        const std::string requestor = system->getRequestorName(id);
+        for (unsigned partition = 0; partition < partitionRequestors.size();
+             partition++) {
+            std::vector<std::string> prefixes;
+            tokenize(prefixes, partitionRequestors[partition], ' ');
+            const bool found = std::any_of(prefixes.begin(), prefixes.end(),
+                [&requestor](const std::string &prefix) {
+                    return startswith(requestor, prefix);
+                });
+            if (found) {
+                requestorPartitions[id] = partition;
+                break;
+            }
+        }
+    }
+}
+
+unsigned
+BaseTags::partitionOf(const PacketPtr pkt) const
+{
+    const RequestorID id = pkt->req->requestorId();
+    return id < requestorPartitions.size() ? requestorPartitions[id] : 0;
+}
+
+void
+BaseTags::recordPartitionAccess(const PacketPtr pkt, bool hit)
+{
+    // Only the demand accesses are monitored, as CMT and MBM do
+    if (pkt->isEviction() || pkt->cmd.isHWPrefetch())
+        return;
+
+    const unsigned partition_id = partitionOf(pkt);
+    stats.partitionAccesses[partition_id]++;
+    if (!hit)
+        stats.partitionMisses[partition_id]++;
+}
+
+std::vector<ReplaceableEntry*>
+BaseTags::partitionEntries(const std::vector<ReplaceableEntry*> &entries,
+                           unsigned partition_id) const
+{
+    if (partitioning == CachePartitioning::none)
+        return entries;
+
+    const uint64_t mask = partitionMasks[partition_id];
+    std::vector<ReplaceableEntry*> candidates;
+    for (const auto& entry : entries) {
+        if (bits(mask, entry->getWay() % 64))
+            candidates.push_back(entry);
+    }
+    return candidates;
 }
 
 ReplaceableEntry*
@@ -167,6 +243,10 @@ BaseTags::computeStatsVisitor(CacheBlk &blk)
             age_index = 4; // >10ms
 
         stats.ageTaskId[blk.task_id][age_index]++;
+
+        const RequestorID id = blk.srcRequestorId;
+        stats.partitionOccupancy[id < requestorPartitions.size() ?
+                                 requestorPartitions[id] : 0]++;
     }
 }
 
@@ -179,6 +259,9 @@ BaseTags::computeStats()
             stats.ageTaskId[i][j] = 0;
         }
     }
+    for (unsigned i = 0; i < numPartitions; ++i) {
+        stats.partitionOccupancy[i] = 0;
+    }
 
     forEachBlk([this](CacheBlk &blk) { computeStatsVisitor(blk); });
 }
@@ -224,7 +307,28 @@ BaseTags::BaseTagStats::BaseTagStats(BaseTags &_tags)
     percentOccsTaskId(this, "occ_task_id_percent",
                       "Percentage of cache occupancy per task id"),
     tagAccesses(this, "tag_accesses", "Number of tag accesses"),
-    dataAccesses(this, "data_accesses", "Number of data accesses")
+    dataAccesses(this, "data_accesses", "Number of data accesses"),
+    wayPredHits(this, "way_pred_hits",
+                "Number of hits in the predicted way"),
+    wayPredMisses(this, "way_pred_misses",
+                  "Number of hits in another way than the predicted one"),
+    wayPredAccuracy(this, "way_pred_accuracy",
+                    "Fraction of hits in the predicted way"),
+    tagEnergy(this, "tag_energy", "Dynamic energy of tag reads (pJ)"),
+    dataEnergy(this, "data_energy", "Dynamic energy of data reads (pJ)"),
+    dynamicEnergy(this, "dynamic_energy",
+                  "Dynamic energy of tag and data reads (pJ)"),
+    partitionOccupancy(this, "partition_occ_blocks",
+                       "Occupied blocks per partition"),
+    partitionAccesses(this, "partition_accesses",
+                      "Number of demand accesses per partition"),
+    partitionMisses(this, "partition_misses",
+                    "Number of demand misses per partition"),
+    partitionMissRate(this, "partition_miss_rate",
+                      "Demand miss rate per partition"),
+    partitionMissBandwidth(this, "partition_miss_bandwidth",
+                           "Bandwidth of the demand misses per partition "
+                           "(bytes/s)")
 {
 }
 
@@ -267,6 +371,22 @@ BaseTags::BaseTagStats::regStats()
     percentOccsTaskId.flags(nozero);
 
     percentOccsTaskId = occupanciesTaskId / Stats::constant(tags.numBlocks);
+
+    wayPredHits.flags(nozero);
+    wayPredMisses.flags(nozero);
+    wayPredAccuracy.flags(nozero | nonan);
+    wayPredAccuracy = wayPredHits / (wayPredHits + wayPredMisses);
+
+    tagEnergy = tagAccesses * tags.tagAccessEnergy;
+    dataEnergy = dataAccesses * tags.dataAccessEnergy;
+    dynamicEnergy = tagEnergy + dataEnergy;
+
+    partitionOccupancy.init(tags.numPartitions);
+    partitionAccesses.init(tags.numPartitions);
+    partitionMisses.init(tags.numPartitions);
+    partitionMissRate.flags(nonan);
+    partitionMissRate = partitionMisses / partitionAccesses;
+    partitionMissBandwidth = partitionMisses * tags.blkSize / simSeconds;
 }
 
 void
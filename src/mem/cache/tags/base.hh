@@ -50,11 +50,13 @@
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <vector>
 
 #include "base/callback.hh"
 #include "base/logging.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
+#include "enums/CachePartitioning.hh"
 #include "mem/cache/cache_blk.hh"
 #include "mem/packet.hh"
 #include "params/BaseTags.hh"
@@ -79,6 +81,11 @@ class BaseTags : public ClockedObject
     /** The tag lookup latency of the cache. */
     const Cycles lookupLatency;
 
+    /** Dynamic energy of reading a tag, in pJ. */
+    const double tagAccessEnergy;
+    /** Dynamic energy of reading a data block, in pJ. */
+    const double dataAccessEnergy;
+
     /** System we are currently operating in. */
     System *system;
 
@@ -99,6 +106,32 @@ class BaseTags : public ClockedObject
     /** The data blocks, 1 per cache block. */
     std::unique_ptr<uint8_t[]> dataBlks;
 
+    /** Whether the partitions are given ways. */
+    const CachePartitioning partitioning;
+
+    /** Ways each partition can allocate in, way w being bit w % 64. */
+    const std::vector<uint64_t> partitionMasks;
+
+    /** Patterns of the names of the requestors of each partition. */
+    const std::vector<std::string> partitionRequestors;
+
+    /** Number of partitions, at least one. */
+    const unsigned numPartitions;
+
+    /** Partition of each requestor, filled at init. */
+    std::vector<unsigned> requestorPartitions;
+
+    /**
+     * Keep the replacement candidates a partition can allocate in.
+     *
+     * @param entries The replacement candidates.
+     * @param partition_id The partition allocating a block.
+     * @return The candidates in the ways of the partition.
+     */
+    std::vector<ReplaceableEntry*> partitionEntries(
+        const std::vector<ReplaceableEntry*> &entries,
+        unsigned partition_id) const;
+
     /**
      * TODO: It would be good if these stats were acquired after warmup.
      */
@@ -152,6 +185,30 @@ class BaseTags : public ClockedObject
         Stats::Scalar tagAccesses;
         /** Number of data blocks consulted over all accesses. */
         Stats::Scalar dataAccesses;
+
+        /** Number of hits in the predicted way. */
+        Stats::Scalar wayPredHits;
+        /** Number of hits in another way than the predicted one. */
+        Stats::Scalar wayPredMisses;
+        /** Fraction of hits in the predicted way. */
+        Stats::Formula wayPredAccuracy;
+
+        /** Dynamic energy of the tag reads, in pJ. */
+        Stats::Formula tagEnergy;
+        /** Dynamic energy of the data reads, in pJ. */
+        Stats::Formula dataEnergy;
+        /** Dynamic energy of the tag and data reads, in pJ. */
+        Stats::Formula dynamicEnergy;
+
+        /** Blocks held by each partition. */
+        Stats::Vector partitionOccupancy;
+        /** Demand accesses and misses of each partition. */
+        Stats::Vector partitionAccesses;
+        Stats::Vector partitionMisses;
+        /** Miss rate of each partition. */
+        Stats::Formula partitionMissRate;
+        /** Bandwidth of the misses of each partition (bytes/s). */
+        Stats::Formula partitionMissBandwidth;
     } stats;
 
   public:
@@ -170,6 +227,30 @@ class BaseTags : public ClockedObject
      */
     virtual void tagsInit() = 0;
 
+    /**
+     * Map the requestors to their partitions, once they have all been
+     * registered.
+     */
+    void init() override;
+
+    /**
+     * Get the partition of the requestor of an access. Writebacks from a
+     * partitioned cache above are made for the requestor that brought
+     * the line in it, the others for the writebacks requestor.
+     *
+     * @param pkt The access.
+     * @return The partition of its requestor.
+     */
+    unsigned partitionOf(const PacketPtr pkt) const;
+
+    /**
+     * Record a demand access in the stats of its partition.
+     *
+     * @param pkt The access.
+     * @param hit Whether it hit in the cache.
+     */
+    void recordPartitionAccess(const PacketPtr pkt, bool hit);
+
     /**
      * Average in the reference count for valid blocks when the simulation
      * exits.
@@ -204,6 +285,27 @@ class BaseTags : public ClockedObject
      */
     virtual ReplaceableEntry* findBlockBySetAndWay(int set, int way) const;
 
+    /**
+     * Get the number of sets walked by getNextVictims().
+     *
+     * @return The number of sets, 0 if the blocks are not kept in sets.
+     */
+    virtual uint32_t getNumSets() const { return 0; }
+
+    /**
+     * Get the valid blocks of a set in the order the replacement policy
+     * would evict them, without touching their replacement data.
+     *
+     * @param set The set of the blocks.
+     * @param depth The maximum number of blocks to get.
+     * @return The next victims of the set, the first victim first.
+     */
+    virtual std::vector<CacheBlk*>
+    getNextVictims(uint32_t set, unsigned depth) const
+    {
+        return std::vector<CacheBlk*>();
+    }
+
     /**
      * Align an address to the block size.
      * @param addr the address to align.
@@ -273,11 +375,14 @@ class BaseTags : public ClockedObject
      * @param is_secure True if the target memory space is secure.
      * @param size Size, in bits, of new block to allocate.
      * @param evict_blks Cache blocks to be evicted.
-     * @return Cache block to be replaced.
+     * @param partition_id Partition allocating the block.
+     * @return Cache block to be replaced, or nullptr if the partition can
+     *         not allocate it.
      */
     virtual CacheBlk* findVictim(Addr addr, const bool is_secure,
                                  const std::size_t size,
-                                 std::vector<CacheBlk*>& evict_blks) = 0;
+                                 std::vector<CacheBlk*>& evict_blks,
+                                 unsigned partition_id) = 0;
 
     /**
      * Access block and update replacement data. May not succeed, in which case
@@ -285,12 +390,11 @@ class BaseTags : public ClockedObject
      * should only be used as such. Returns the tag lookup latency as a side
      * effect.
      *
-     * @param addr The address to find.
-     * @param is_secure True if the target memory space is secure.
+     * @param pkt The packet holding the address to find.
      * @param lat The latency of the tag lookup.
      * @return Pointer to the cache block if found.
      */
-    virtual CacheBlk* accessBlock(Addr addr, bool is_secure, Cycles &lat) = 0;
+    virtual CacheBlk* accessBlock(const PacketPtr pkt, Cycles &lat) = 0;
 
     /**
      * Generate the tag from the given address.
@@ -45,6 +45,7 @@
 
 #include "mem/cache/tags/base_set_assoc.hh"
 
+#include <algorithm>
 #include <string>
 
 #include "base/intmath.hh"
@@ -52,12 +53,65 @@
 BaseSetAssoc::BaseSetAssoc(const Params *p)
     :BaseTags(p), allocAssoc(p->assoc), blks(p->size / p->block_size),
      sequentialAccess(p->sequential_access),
-     replacementPolicy(p->replacement_policy)
+     replacementPolicy(p->replacement_policy),
+     wayPrediction(p->way_prediction),
+     wayMispredictPenalty(p->way_mispredict_penalty),
+     mruWays(p->size / (p->block_size * p->assoc), 0),
+     pcWays(p->way_predictor_entries, 0)
 {
     // Check parameters
     if (blkSize < 4 || !isPowerOf2(blkSize)) {
         fatal("Block size must be at least 4 and a power of 2");
     }
+    fatal_if(wayPrediction == WayPrediction::pc && pcWays.empty(),
+             "The PC-indexed way predictor needs at least one entry");
+}
+
+uint32_t&
+BaseSetAssoc::wayPredictorEntry(const PacketPtr pkt, bool use_pc)
+{
+    if (use_pc && pkt->req->hasPC()) {
+        const Addr pc = pkt->req->getPC();
+        return pcWays[(pc ^ (pc >> 8)) % pcWays.size()];
+    }
+    return mruWays[(pkt->getAddr() / blkSize) % mruWays.size()];
+}
+
+void
+BaseSetAssoc::lookupPredictedWay(const PacketPtr pkt, const CacheBlk *blk,
+                                 Cycles &lat)
+{
+    const uint32_t predicted_way =
+        wayPredictorEntry(pkt, wayPrediction == WayPrediction::pc);
+    const bool predicted = (blk != nullptr) &&
+        (blk->getWay() == predicted_way);
+
+    stats.tagAccesses += 1;
+    if (!sequentialAccess || predicted) {
+        stats.dataAccesses += 1;
+    }
+
+    if (predicted) {
+        stats.wayPredHits++;
+        return;
+    }
+
+    // A miss can only be told after checking all the ways
+    stats.tagAccesses += allocAssoc - 1;
+    if (blk != nullptr) {
+        stats.wayPredMisses++;
+        stats.dataAccesses += 1;
+    }
+    lat += wayMispredictPenalty;
+}
+
+void
+BaseSetAssoc::trainWayPredictor(const PacketPtr pkt, const CacheBlk *blk)
+{
+    wayPredictorEntry(pkt, false) = blk->getWay();
+    if (wayPrediction == WayPrediction::pc) {
+        wayPredictorEntry(pkt, true) = blk->getWay();
+    }
 }
 
 void
@@ -91,6 +145,32 @@ BaseSetAssoc::invalidate(CacheBlk *blk)
     replacementPolicy->invalidate(blk->replacementData);
 }
 
+std::vector<CacheBlk*>
+BaseSetAssoc::getNextVictims(uint32_t set, unsigned depth) const
+{
+    std::vector<ReplaceableEntry*> candidates;
+    for (uint32_t way = 0; way < indexingPolicy->getAssoc(); way++) {
+        CacheBlk *blk = static_cast<CacheBlk*>(
+            indexingPolicy->getEntry(set, way));
+        if (blk->isValid()) {
+            candidates.push_back(blk);
+        }
+    }
+
+    // Ask the replacement policy for the victim among the remaining
+    // blocks, over and over, peeking so that the ranking leaves the
+    // replacement state as it is
+    std::vector<CacheBlk*> victims;
+    while (victims.size() < depth && !candidates.empty()) {
+        ReplaceableEntry *victim = replacementPolicy->peekVictim(candidates);
+        victims.push_back(static_cast<CacheBlk*>(victim));
+        candidates.erase(std::find(candidates.begin(), candidates.end(),
+                                   victim));
+    }
+
+    return victims;
+}
+
 BaseSetAssoc *
 BaseSetAssocParams::create()
 {
@@ -53,6 +53,7 @@
 
 #include "base/logging.hh"
 #include "base/types.hh"
+#include "enums/WayPrediction.hh"
 #include "mem/cache/base.hh"
 #include "mem/cache/cache_blk.hh"
 #include "mem/cache/replacement_policies/base.hh"
@@ -84,6 +85,49 @@ class BaseSetAssoc : public BaseTags
     /** Replacement policy */
     BaseReplacementPolicy *replacementPolicy;
 
+    /** Way predictor used to probe a single way first. */
+    const WayPrediction wayPrediction;
+
+    /** Extra lookup latency when the predicted way does not hit. */
+    const Cycles wayMispredictPenalty;
+
+    /** The most recently hit or filled way of each set. */
+    std::vector<uint32_t> mruWays;
+
+    /** The most recently hit or filled way of each PC-indexed entry. */
+    std::vector<uint32_t> pcWays;
+
+    /**
+     * Get the way predictor entry of an access.
+     *
+     * @param pkt The access.
+     * @param use_pc Whether to use the PC-indexed entry, if there is a PC.
+     * @return The predicted way of the access.
+     */
+    uint32_t& wayPredictorEntry(const PacketPtr pkt, bool use_pc);
+
+    /**
+     * Account for a lookup that probes the predicted way first. Only its
+     * tag is read first, along with its data in a parallel access. If the
+     * block is not there, the other tags are read too, with the data of
+     * the block on a hit, and the lookup is slower.
+     *
+     * @param pkt The access.
+     * @param blk The block found by the lookup, if any.
+     * @param lat The lookup latency, to which the penalty is added.
+     */
+    void lookupPredictedWay(const PacketPtr pkt, const CacheBlk *blk,
+                            Cycles &lat);
+
+    /**
+     * Make the way of a block the prediction of the next accesses to its
+     * set and by its PC.
+     *
+     * @param pkt The access that hit or filled the block.
+     * @param blk The block.
+     */
+    void trainWayPredictor(const PacketPtr pkt, const CacheBlk *blk);
+
   public:
     /** Convenience typedef. */
      typedef BaseSetAssocParams Params;
@@ -117,25 +161,33 @@ class BaseSetAssoc : public BaseTags
      * should only be used as such. Returns the tag lookup latency as a side
      * effect.
      *
-     * @param addr The address to find.
-     * @param is_secure True if the target memory space is secure.
+     * @param pkt The packet holding the address to find.
      * @param lat The latency of the tag lookup.
      * @return Pointer to the cache block if found.
      */
-    CacheBlk* accessBlock(Addr addr, bool is_secure, Cycles &lat) override
+    CacheBlk* accessBlock(const PacketPtr pkt, Cycles &lat) override
     {
-        CacheBlk *blk = findBlock(addr, is_secure);
-
-        // Access all tags in parallel, hence one in each way.  The data side
-        // either accesses all blocks in parallel, or one block sequentially on
-        // a hit.  Sequential access with a miss doesn't access data.
-        stats.tagAccesses += allocAssoc;
-        if (sequentialAccess) {
-            if (blk != nullptr) {
-                stats.dataAccesses += 1;
-            }
+        CacheBlk *blk = findBlock(pkt->getAddr(), pkt->isSecure());
+
+        // The tag lookup latency is the same for a hit or a miss, unless
+        // a way is predicted
+        lat = lookupLatency;
+
+        if (wayPrediction != WayPrediction::none) {
+            lookupPredictedWay(pkt, blk, lat);
         } else {
-            stats.dataAccesses += allocAssoc;
+            // Access all tags in parallel, hence one in each way. The data
+            // side either accesses all blocks in parallel, or one block
+            // sequentially on a hit. Sequential access with a miss doesn't
+            // access data.
+            stats.tagAccesses += allocAssoc;
+            if (sequentialAccess) {
+                if (blk != nullptr) {
+                    stats.dataAccesses += 1;
+                }
+            } else {
+                stats.dataAccesses += allocAssoc;
+            }
         }
 
         // If a cache hit
@@ -144,11 +196,12 @@ class BaseSetAssoc : public BaseTags
             blk->refCount++;
 
             // Update replacement data of accessed block
-            replacementPolicy->touch(blk->replacementData);
-        }
+            replacementPolicy->touch(blk->replacementData, pkt);
 
-        // The tag lookup latency is the same for a hit or a miss
-        lat = lookupLatency;
+            if (wayPrediction != WayPrediction::none) {
+                trainWayPredictor(pkt, blk);
+            }
+        }
 
         return blk;
     }
@@ -161,15 +214,20 @@ class BaseSetAssoc : public BaseTags
      * @param is_secure True if the target memory space is secure.
      * @param size Size, in bits, of new block to allocate.
      * @param evict_blks Cache blocks to be evicted.
+     * @param partition_id Partition allocating the block.
      * @return Cache block to be replaced.
      */
     CacheBlk* findVictim(Addr addr, const bool is_secure,
                          const std::size_t size,
-                         std::vector<CacheBlk*>& evict_blks) override
+                         std::vector<CacheBlk*>& evict_blks,
+                         unsigned partition_id) override
     {
-        // Get possible entries to be victimized
-        const std::vector<ReplaceableEntry*> entries =
-            indexingPolicy->getPossibleEntries(addr);
+        // Get possible entries to be victimized, in the partition
+        const std::vector<ReplaceableEntry*> entries = partitionEntries(
+            indexingPolicy->getPossibleEntries(addr), partition_id);
+        if (entries.empty()) {
+            return nullptr;
+        }
 
         // Choose replacement victim from replacement candidates
         CacheBlk* victim = static_cast<CacheBlk*>(replacementPolicy->getVictim(
@@ -196,7 +254,11 @@ class BaseSetAssoc : public BaseTags
         stats.tagsInUse++;
 
         // Update replacement policy
-        replacementPolicy->reset(blk->replacementData);
+        replacementPolicy->reset(blk->replacementData, pkt);
+
+        if (wayPrediction != WayPrediction::none) {
+            trainWayPredictor(pkt, blk);
+        }
     }
 
     /**
@@ -243,6 +305,14 @@ class BaseSetAssoc : public BaseTags
         }
         return false;
     }
+
+    uint32_t getNumSets() const override
+    {
+        return indexingPolicy->getNumSets();
+    }
+
+    std::vector<CacheBlk*> getNextVictims(uint32_t set,
+                                          unsigned depth) const override;
 };
 
 #endif //__MEM_CACHE_TAGS_BASE_SET_ASSOC_HH__
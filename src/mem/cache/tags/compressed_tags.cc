@@ -101,7 +101,8 @@ CompressedTags::tagsInit()
 CacheBlk*
 CompressedTags::findVictim(Addr addr, const bool is_secure,
                            const std::size_t compressed_size,
-                           std::vector<CacheBlk*>& evict_blks)
+                           std::vector<CacheBlk*>& evict_blks,
+                           unsigned partition_id)
 {
     // Get all possible locations of this superblock
     const std::vector<ReplaceableEntry*> superblock_entries =
@@ -130,9 +131,14 @@ CompressedTags::findVictim(Addr addr, const bool is_secure,
     // If the superblock is not present or cannot be co-allocated a
     // superblock must be replaced
     if (victim_superblock == nullptr){
-        // Choose replacement victim from replacement candidates
+        // Choose replacement victim from the candidates of the partition
+        const std::vector<ReplaceableEntry*> candidates =
+            partitionEntries(superblock_entries, partition_id);
+        if (candidates.empty()) {
+            return nullptr;
+        }
         victim_superblock = static_cast<SuperBlk*>(
-            replacementPolicy->getVictim(superblock_entries));
+            replacementPolicy->getVictim(candidates));
 
         // The whole superblock must be evicted to make room for the new one
         for (const auto& blk : victim_superblock->blks){
@@ -70,6 +70,8 @@ FALRU::FALRU(const Params *p)
               blkSize);
     if (!isPowerOf2(size))
         fatal("Cache Size must be power of 2 for now");
+    fatal_if(partitioning != CachePartitioning::none,
+             "A fully associative cache can not be partitioned");
 
     blks = new FALRUBlk[numBlocks];
 }
@@ -134,9 +136,9 @@ FALRU::invalidate(CacheBlk *blk)
 }
 
 CacheBlk*
-FALRU::accessBlock(Addr addr, bool is_secure, Cycles &lat)
+FALRU::accessBlock(const PacketPtr pkt, Cycles &lat)
 {
-    return accessBlock(addr, is_secure, lat, 0);
+    return accessBlock(pkt->getAddr(), pkt->isSecure(), lat, 0);
 }
 
 CacheBlk*
@@ -193,7 +195,7 @@ FALRU::findBlockBySetAndWay(int set, int way) const
 
 CacheBlk*
 FALRU::findVictim(Addr addr, const bool is_secure, const std::size_t size,
-                  std::vector<CacheBlk*>& evict_blks)
+                  std::vector<CacheBlk*>& evict_blks, unsigned partition_id)
 {
     // The victim is always stored on the tail for the FALRU
     FALRUBlk* victim = tail;
@@ -127,6 +127,20 @@ class BaseIndexingPolicy : public SimObject
      */
     ReplaceableEntry* getEntry(const uint32_t set, const uint32_t way) const;
 
+    /**
+     * Get the number of sets.
+     *
+     * @return The number of sets.
+     */
+    uint32_t getNumSets() const { return numSets; }
+
+    /**
+     * Get the associativity.
+     *
+     * @return The number of ways of a set.
+     */
+    unsigned getAssoc() const { return assoc; }
+
     /**
      * Generate the tag from the given address.
      *
@@ -105,6 +105,12 @@ class WriteQueueEntry : public QueueEntry, public Printable
      */
     Iterator allocIter;
 
+    /**
+     * Pointer to this entry on the list of its block address.
+     * @sa Queue::matchIndex
+     */
+    Iterator matchIter;
+
     /** List of all requests that match the address */
     TargetList targets;
 
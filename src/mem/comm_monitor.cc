@@ -129,6 +129,10 @@ CommMonitor::MonitorStats::MonitorStats(Stats::Group *parent,
       disableLatencyHists(params->disable_latency_hists),
       ADD_STAT(readLatencyHist, "Read request-response latency"),
       ADD_STAT(writeLatencyHist, "Write request-response latency"),
+      ADD_STAT(readLatencyQuantiles,
+               "Read request-response latency quantiles"),
+      ADD_STAT(writeLatencyQuantiles,
+               "Write request-response latency quantiles"),
 
       disableITTDists(params->disable_itt_dists),
       ADD_STAT(ittReadRead, "Read-to-read inter transaction time"),
@@ -197,6 +201,14 @@ CommMonitor::MonitorStats::MonitorStats(Stats::Group *parent,
         .init(params->latency_bins)
         .flags(disableLatencyHists ? nozero : pdf);
 
+    readLatencyQuantiles
+        .init(params->latency_quantiles, params->latency_quantile_accuracy)
+        .flags(disableLatencyHists ? nozero : none);
+
+    writeLatencyQuantiles
+        .init(params->latency_quantiles, params->latency_quantile_accuracy)
+        .flags(disableLatencyHists ? nozero : none);
+
     ittReadRead
         .init(1, params->itt_max_bin, params->itt_max_bin /
               params->itt_bins)
@@ -315,8 +327,10 @@ CommMonitor::MonitorStats::updateRespStats(
             --outstandingReadReqs;
         }
 
-        if (!disableLatencyHists)
+        if (!disableLatencyHists) {
             readLatencyHist.sample(latency);
+            readLatencyQuantiles.sample(latency);
+        }
 
         // Update the bandwidth stats based on responses for reads
         if (!disableBandwidthHists) {
@@ -331,8 +345,10 @@ CommMonitor::MonitorStats::updateRespStats(
             --outstandingWriteReqs;
         }
 
-        if (!disableLatencyHists)
+        if (!disableLatencyHists) {
             writeLatencyHist.sample(latency);
+            writeLatencyQuantiles.sample(latency);
+        }
     }
 }
 
@@ -310,6 +310,12 @@ class CommMonitor : public SimObject
         /** Histogram of write request-to-response latencies */
         Stats::Histogram writeLatencyHist;
 
+        /** Quantiles of the read request-to-response latencies */
+        Stats::QuantileSketch readLatencyQuantiles;
+
+        /** Quantiles of the write request-to-response latencies */
+        Stats::QuantileSketch writeLatencyQuantiles;
+
         /** Disable flag for ITT distributions. */
         bool disableITTDists;
 
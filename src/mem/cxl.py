@@ -5,10 +5,25 @@ class CXLController(BaseXBar):
         type = 'CXLController'
         cxx_header = "mem/cxl_controller.hh"
 
+        resp_queue_limit = Param.Unsigned(128, "Responses queued towards "
+                                          "a CPU-side port before further "
+                                          "responses are refused "
+                                          "(0 is unbounded)")
+
 class CXLDevice(BaseXBar):
         type = 'CXLDevice'
         cxx_header = "mem/cxl_device.hh"
 
+        resp_queue_limit = Param.Unsigned(128, "Responses queued towards "
+                                          "a CPU-side port before further "
+                                          "responses are refused "
+                                          "(0 is unbounded)")
+
 class CXLXBar(BaseXBar):
         type = 'CXLXBar'
-        cxx_header = "mem/cxlxbar.hh"
\ No newline at end of file
+        cxx_header = "mem/cxlxbar.hh"
+
+        resp_queue_limit = Param.Unsigned(128, "Responses queued towards "
+                                          "a CPU-side port before further "
+                                          "responses are refused "
+                                          "(0 is unbounded)")
@@ -9,6 +9,9 @@
 #include "debug/CXLPerf.hh"
 #include "mem/cxl_protocol.hh"
 
+using ProbePoints::CXLChannel;
+using ProbePoints::CXLFlitInfo;
+
 CXLController::CXLController(const CXLControllerParams* p) :
     BaseXBar(p)
 {
@@ -47,6 +50,10 @@ CXLController::CXLController(const CXLControllerParams* p) :
                                            csprintf("respLayer%d", i)));
     }
 
+    // refuse responses rather than letting the response queues grow
+    // without bounds when the CPU side is not accepting them
+    limitRespQueues(p->resp_queue_limit);
+
     DPRINTF(CXLController, "hello world from cxl controller!\n");
     for (int i = 0; i < 2; i++)
     {
@@ -119,7 +126,7 @@ bool CXLController::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id){
 
     if (pkt->isRead())
         mkReadPkt(pkt, mem_side_port_id);
-    else if (pkt->isWriteback())
+    else if (pkt->isWrite())
         mkWritePkt(pkt, mem_side_port_id);
 
     // store size and command as they might be modified when
@@ -147,6 +154,8 @@ bool CXLController::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id){
     //In this way, we do not need to update other Classes.
     pkt->update_size(pkt->cxl_size);
     pkt->cxl_size = pkt_size;
+    pkt->cxl_compressed_size = pkt->getCompressedSize();
+    pkt->setCompressedSize(0);
     pkt->cmd = pkt->cxl_comm;
     pkt->cxl_comm = MemCmd::Command(pkt_cmd);
 
@@ -165,6 +174,10 @@ bool CXLController::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id){
         //pktSize[cpu_side_port_id][mem_side_port_id] += (pkt->getSize());
         //transDist[(int)(MemCmd::Command::DataFlit)]++;
     }
+    ppFlit->notify(CXLFlitInfo(
+        pkt->hasData() ? CXLChannel::M2SRwD : CXLChannel::M2SReq, pkt,
+        pkt->cxl_comm, pkt->cxl_size,
+        pkt->ReqCrd, pkt->ResCrd, pkt->DataCrd));
     ((CXLControllerRequestPort*)memSidePorts[mem_side_port_id])
                             ->schedTimingReq(pkt, curTick() + latency);
 
@@ -172,10 +185,8 @@ bool CXLController::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id){
     // remember if we are expecting a response
     const bool expect_response = pkt->needsResponse();
     // remember where to route the response to
-    if (expect_response) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = cpu_side_port_id;
-    }
+    if (expect_response)
+        pkt->pushRoute(cpu_side_port_id);
 
     reqLayers[mem_side_port_id]->succeededTiming(packetFinishTime);
 
@@ -192,12 +203,17 @@ bool CXLController::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id){
     RequestPort *src_port = memSidePorts[mem_side_port_id];
 
     // determine the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID cpu_side_port_id = route_lookup->second;
+    const PortID cpu_side_port_id = pkt->routeTop();
     assert(cpu_side_port_id != InvalidPortID);
     assert(cpu_side_port_id < respLayers.size());
 
+    // push back on the memory side if the response queue is full
+    if (!respQueueHasSpace(cpu_side_port_id, mem_side_port_id)) {
+        DPRINTF(CXLController, "recvTimingResp: src %s %s 0x%x QUEUE FULL\n",
+                src_port->name(), pkt->cmdString(), pkt->getAddr());
+        return false;
+    }
+
     // test if the layer should be considered occupied for the current
     // port
     if (!respLayers[cpu_side_port_id]->tryTiming(src_port)) {
@@ -225,20 +241,37 @@ bool CXLController::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id){
 
     // send the packet through the destination CPU-side port, and pay for
     // any outstanding latency
-    //Drop CMP command.
-    if (pkt->cmd != MemCmd::Command::Cmp) {
+    //Record the flit before it is unpacked, the response credits
+    //of the unused slots come back with it.
+    const MemCmd orig_cmd(pkt->cxl_comm);
+    const int rsp_crd = 5 - pkt->reserved_for_more_DRS -
+                        pkt->reserved_for_more_NDR;
+    ppFlit->notify(CXLFlitInfo(
+        pkt->cmd == MemCmd::Command::Cmp ?
+            CXLChannel::S2MNDR : CXLChannel::S2MDRS, pkt,
+        orig_cmd, pkt->req->getSize(), 0, rsp_crd, 0));
+
+    //Drop CMP command, unless the original request is waiting for it,
+    //e.g. a WriteReq issued by a Ruby directory controller.
+    if (pkt->cmd != MemCmd::Command::Cmp || orig_cmd.needsResponse()) {
         Tick latency = pkt->headerDelay;
         pkt->headerDelay = 0;
-        //restore old size
-        pkt->update_size(pkt->cxl_size);
-        pkt->cmd = MemCmd::Command::ReadResp;
+        //restore old size, Cmp carries no data so the original size
+        //is only kept by the request
+        if (pkt->cmd == MemCmd::Command::Cmp)
+            pkt->update_size(pkt->req->getSize());
+        else
+            pkt->update_size(pkt->cxl_size);
+        pkt->setCompressedSize(pkt->cxl_compressed_size);
+        //restore the response of the original command
+        pkt->cmd = orig_cmd.responseCommand();
         DPRINTF(CXLController, "recvTimingResp: send to cache %s 0x%x %d\n",
              pkt->cmdString(), pkt->getAddr(), pkt->getSize());
         cpuSidePorts[cpu_side_port_id]->schedTimingResp(pkt,
                                             curTick() + latency);
     }
-    // remove the request from the routing table
-    routeTo.erase(route_lookup);
+    // the response has left, remove its route
+    pkt->popRoute();
     //port needs to receive all data, even for cmp command.
     respLayers[cpu_side_port_id]->succeededTiming(packetFinishTime);
     // stats updates
@@ -257,8 +290,7 @@ bool CXLController::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id){
     //    reqLayers[mem_side_port_id]->CreditRelease(ResCrd.begin() + 2, 1);
     //} else{
     reqLayers[mem_side_port_id]->CreditRelease(ResCrd.begin() + 2,
-                    5 - pkt->reserved_for_more_DRS -
-                    pkt->reserved_for_more_NDR);
+                                               rsp_crd);
     //}
 
     //ResCrd[2] ++;
@@ -321,6 +353,11 @@ void CXLController::recvFunctional(PacketPtr pkt, PortID cpu_side_port_id){
     memSidePorts[dest_id]->sendFunctional(pkt);
 };
 
+void CXLController::regProbePoints(){
+    BaseXBar::regProbePoints();
+    ppFlit.reset(new ProbePoints::CXLFlit(getProbeManager(), "CXLFlit"));
+};
+
 void CXLController::mkReadPkt(PacketPtr pkt, PortID port_id){
     //we can recieve no more than 64 response.
     ResCrd[2] -- ;
@@ -339,23 +376,23 @@ void CXLController::mkReadPkt(PacketPtr pkt, PortID port_id){
 
 void CXLController::mkWritePkt(PacketPtr pkt, PortID port_id){
     //generate MemWrPtl or MemWr instruction
-    //currently, we do not see any write partial
-    if (pkt->isWriteback()){
-        //we can recieve no more than 64 response.
-        ResCrd[2] -- ;
-
-        pkt->cxl_comm = MemCmd::Command::MemWr;
-        //Currently, we think the device has infinite queue
-        pkt->ReqCrd = 64;
-        pkt->ResCrd = 64;
-        pkt->DataCrd = 64;
-        pkt->cxl_size = FLIT_SIZE;
-        //check rollover for the write instruction
-        pkt->rollover = (last_rollover + 4) - 3;
-        last_rollover = pkt->rollover;
-    }else{
+    //currently, we do not see any write partial.
+    //Writebacks from the classic caches and WriteReqs from a Ruby
+    //directory controller are both sent as MemWr.
+    //we can recieve no more than 64 response.
+    ResCrd[2] -- ;
 
-    }
+    pkt->cxl_comm = MemCmd::Command::MemWr;
+    //Currently, we think the device has infinite queue
+    pkt->ReqCrd = 64;
+    pkt->ResCrd = 64;
+    pkt->DataCrd = 64;
+    pkt->cxl_size = FLIT_SIZE;
+    //check rollover for the write instruction, the data of a
+    //compressed line takes fewer slots
+    pkt->rollover = next_rollover(last_rollover,
+                                  pkt->getCompressedSize());
+    last_rollover = pkt->rollover;
 };
 
 bool CXLController::QueuedReqLayer::TestOutstanding(ResponsePort* src_port){
@@ -1,6 +1,7 @@
 #ifndef __CXL_CONTROLLER_HH__
 #define __CXL_CONTROLLER_HH__
 
+#include "mem/cxl_probe.hh"
 #include "mem/xbar.hh"
 #include "params/CXLController.hh"
 
@@ -14,6 +15,9 @@ public:
     CXLController(const CXLControllerParams *p);
     virtual ~CXLController();
 
+    /** Register the CXLFlit probe point */
+    void regProbePoints() override;
+
 protected:
     /**
      * Declaration of the non-coherent crossbar CPU-side port type, one
@@ -152,6 +156,10 @@ private:
     std::vector<int> DataCrd;
     std::vector<AddrRange *> addr;
     unsigned last_rollover;
+
+    /** Notified for every flit sent to or received from the link */
+    ProbePoints::CXLFlitUPtr ppFlit;
+
     void mkReadPkt(PacketPtr pkt, PortID port_id);
     void mkWritePkt(PacketPtr pkt, PortID port_id);
 };
@@ -46,6 +46,10 @@ CXLDevice::CXLDevice(const CXLDeviceParams* p) :
                                            csprintf("respLayer%d", i)));
     }
 
+    // refuse responses rather than letting the response queues grow
+    // without bounds when the CPU side is not accepting them
+    limitRespQueues(p->resp_queue_limit);
+
     DPRINTF(CXLDevice, "hello world from cxl device!\n");
     for (int i = 0; i < 2; i++)
     {
@@ -149,15 +153,14 @@ bool CXLDevice::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id){
     //No need to restore command
     pkt->update_size(pkt->cxl_size);
     pkt->cxl_size = pkt_size;
+    pkt->setCompressedSize(pkt->cxl_compressed_size);
     Tick latency = pkt->headerDelay;
     pkt->headerDelay = 0;
     ((CXLDeviceRequestPort*)memSidePorts[mem_side_port_id])
                             ->schedTimingReq(pkt, curTick() + latency);
     // remember where to route the response to
-    if (expect_response) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = cpu_side_port_id;
-    }
+    if (expect_response)
+        pkt->pushRoute(cpu_side_port_id);
 
     reqLayers[mem_side_port_id]->succeededTiming(packetFinishTime);
 
@@ -174,12 +177,17 @@ bool CXLDevice::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id){
     RequestPort *src_port = memSidePorts[mem_side_port_id];
 
     // determine the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID cpu_side_port_id = route_lookup->second;
+    const PortID cpu_side_port_id = pkt->routeTop();
     assert(cpu_side_port_id != InvalidPortID);
     assert(cpu_side_port_id < respLayers.size());
 
+    // push back on the memory side if the response queue is full
+    if (!respQueueHasSpace(cpu_side_port_id, mem_side_port_id)) {
+        DPRINTF(CXLDevice, "recvTimingResp: src %s %s 0x%x QUEUE FULL\n",
+                src_port->name(), pkt->cmdString(), pkt->getAddr());
+        return false;
+    }
+
     // test if the layer should be considered occupied for the current
     // port
     if (!respLayers[cpu_side_port_id]->tryTiming(src_port)) {
@@ -233,12 +241,14 @@ bool CXLDevice::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id){
     //other Classes.
     pkt->update_size(pkt->cxl_size);
     pkt->cxl_size = pkt_size;
+    pkt->cxl_compressed_size = pkt->getCompressedSize();
+    pkt->setCompressedSize(0);
     cpuSidePorts[cpu_side_port_id]->schedTimingResp(pkt,
                                         curTick() + latency);
     //}
 
-    // remove the request from the routing table
-    routeTo.erase(route_lookup);
+    // the response has left, remove its route
+    pkt->popRoute();
 
     respLayers[cpu_side_port_id]->succeededTiming(packetFinishTime);
 
@@ -308,23 +318,21 @@ void CXLDevice::recvFunctional(PacketPtr pkt, PortID cpu_side_port_id){
 bool CXLDevice::CXLDeviceResponsePort::combine_command(PacketPtr pkt){
     //return false;
     if (pkt->cmd == MemCmd::Command::Cmp){
-        queue.resetQueuePtr();
-        PacketPtr tmp = queue.workAroundQueue();
-        while (tmp != NULL){
-            if (tmp->reserved_for_more_NDR > 0){
-                tmp->reserved_for_more_NDR--;
+        for (const auto &dp : queue.deferredPackets()) {
+            if (dp.pkt->reserved_for_more_NDR > 0){
+                dp.pkt->reserved_for_more_NDR--;
                 pkt->is_combined = true;
                 return true;
             }
-            tmp = queue.workAroundQueue();
-        };
-    } else if (pkt->cmd == MemCmd::Command::MemData){
+        }
+    } else if (pkt->cmd == MemCmd::Command::MemData &&
+               queue.size() != 0){
         //we can only combine MemData command with the latest packet.
-        PacketPtr tmp = queue.LastPkt();
+        PacketPtr tmp = queue.deferredPackets().back().pkt;
         if (tmp->reserved_for_more_DRS > 0){
             if (tmp->cmd == MemCmd::Command::Cmp){
                 //remove cmp commands
-                queue.pop_back();
+                queue.removeLast();
 
             }
             pkt->reserved_for_more_DRS = tmp->reserved_for_more_DRS - 1;
@@ -350,7 +358,8 @@ void CXLDevice::generate_cxl_rep(PacketPtr pkt){
     //Consider rollover if this is RWD
     if (pkt->cmd == MemCmd::Command::MemData){
         pkt->reserved_for_more_DRS--;
-        pkt->rollover = (last_rollover + 4) - 3;
+        pkt->rollover = next_rollover(last_rollover,
+                                      pkt->getCompressedSize());
         last_rollover = pkt->rollover;
     } else {
         pkt->reserved_for_more_NDR--;
@@ -409,9 +418,10 @@ void CXLRespPacketQueue::sendDeferredPacket(){
     // next send
     if (!waitingOnRetry) {
         schedSendEvent(deferredPacketReadyTime());
+        notifySpace();
     } else {
         // put the packet back at the front of the list
-        transmitList.emplace_front(dp);
+        transmitList.push_front(dp);
     }
 }
 
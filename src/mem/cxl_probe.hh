@@ -0,0 +1,85 @@
+#ifndef __CXL_PROBE_HH__
+#define __CXL_PROBE_HH__
+
+#include <memory>
+
+#include "mem/packet.hh"
+#include "sim/probe/probe.hh"
+
+namespace ProbePoints {
+
+/**
+ * The CXL.mem channel a flit travels on. Requests and requests with
+ * data go from the host to the device (M2S), responses without and
+ * with data come back from the device (S2M).
+ */
+enum class CXLChannel : uint8_t {
+    M2SReq,
+    M2SRwD,
+    S2MNDR,
+    S2MDRS
+};
+
+/**
+ * The essential fields of a flit sent on a CXL link. The host fields
+ * keep the request the flit was packed from, so that a recorded host
+ * request stream can be replayed without the rest of the system.
+ */
+struct CXLFlitInfo {
+    CXLChannel channel;
+    /** CXL command in the header slot, e.g. MemRd or Cmp */
+    MemCmd cxlCmd;
+    /** Command of the host request the flit belongs to */
+    MemCmd hostCmd;
+    Addr addr;
+    /** Size of the host request */
+    uint32_t size;
+    /** Bytes sent on the link, including any all-data flit */
+    uint32_t flitSize;
+    unsigned rollover;
+    /** Generic slots still free for more NDR/DRS messages */
+    unsigned freeNDRSlots;
+    unsigned freeDRSSlots;
+    /** Credits returned to the sender with this flit */
+    unsigned reqCrd;
+    unsigned rspCrd;
+    unsigned dataCrd;
+    Request::FlagsType flags;
+    RequestorID id;
+
+    CXLFlitInfo(CXLChannel _channel, const PacketPtr& pkt,
+                MemCmd host_cmd, uint32_t host_size,
+                unsigned req_crd, unsigned rsp_crd, unsigned data_crd) :
+        channel(_channel),
+        cxlCmd(pkt->cmd),
+        hostCmd(host_cmd),
+        addr(pkt->getAddr()),
+        size(host_size),
+        flitSize(pkt->getSize()),
+        rollover(pkt->rollover),
+        // only the device packs more messages into a flit
+        freeNDRSlots(isS2M() ? pkt->reserved_for_more_NDR : 0),
+        freeDRSSlots(isS2M() ? pkt->reserved_for_more_DRS : 0),
+        reqCrd(req_crd),
+        rspCrd(rsp_crd),
+        dataCrd(data_crd),
+        flags(pkt->req->getFlags()),
+        id(pkt->req->requestorId())  { }
+
+    bool isS2M() const
+    {
+        return channel == CXLChannel::S2MNDR ||
+            channel == CXLChannel::S2MDRS;
+    }
+};
+
+/**
+ * CXL flit probe point, notified for every flit the CXL controller
+ * sends to or receives from the link.
+ */
+typedef ProbePointArg<CXLFlitInfo> CXLFlit;
+typedef std::unique_ptr<CXLFlit> CXLFlitUPtr;
+
+}
+
+#endif //__CXL_PROBE_HH__
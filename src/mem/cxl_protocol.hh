@@ -1,10 +1,30 @@
 #ifndef __CXL_PROTOCOL_HH__
 #define __CXL_PROTOCOL_HH__
 
+#include "base/intmath.hh"
 #include "base/types.hh"
 
 #define FLIT_SIZE (528 / 8)
 #define DATA_FLIT   65
+#define DATA_SLOT   16
+
+//Number of 16B slots taken by the data of a line, the 4 slots
+//of a data transfer unless the line is sent compressed, 0 for
+//an uncompressed line.
+inline unsigned
+data_slots(unsigned compressed_size)
+{
+    return compressed_size ? divCeil(compressed_size, DATA_SLOT) : 4;
+}
+
+//Rollover after the data of a line is packed in a flit that has
+//3 free slots.
+inline unsigned
+next_rollover(unsigned last_rollover, unsigned compressed_size)
+{
+    const unsigned slots = last_rollover + data_slots(compressed_size);
+    return slots > 3 ? slots - 3 : 0;
+}
 struct M2SReq
 {
     unsigned val:1;
@@ -85,6 +85,10 @@ CXLXBar::CXLXBar(const CXLXBarParams *p)
         respLayers.push_back(new RespLayer(*bp, *this,
                                            csprintf("respLayer%d", i)));
     }
+
+    // refuse responses rather than letting the response queues grow
+    // without bounds when the CPU side is not accepting them
+    limitRespQueues(p->resp_queue_limit);
 }
 
 CXLXBar::~CXLXBar()
@@ -140,10 +144,19 @@ CXLXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
     const bool expect_response = pkt->needsResponse() &&
         !pkt->cacheResponding();
 
+    // remember where to route the response to, this has to be done
+    // before sending as the crossbars further down push their route
+    // when the packet is sent
+    if (expect_response)
+        pkt->pushRoute(cpu_side_port_id);
+
     // since it is a normal request, attempt to send the packet
     bool success = memSidePorts[mem_side_port_id]->sendTimingReq(pkt);
 
     if (!success)  {
+        if (expect_response)
+            pkt->popRoute();
+
         DPRINTF(CXLXBar, "recvTimingReq: src %s %s 0x%x RETRY\n",
                 src_port->name(), pkt->cmdString(), pkt->getAddr());
 
@@ -157,12 +170,6 @@ CXLXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
         return false;
     }
 
-    // remember where to route the response to
-    if (expect_response) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = cpu_side_port_id;
-    }
-
     reqLayers[mem_side_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
@@ -180,12 +187,17 @@ CXLXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     RequestPort *src_port = memSidePorts[mem_side_port_id];
 
     // determine the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID cpu_side_port_id = route_lookup->second;
+    const PortID cpu_side_port_id = pkt->routeTop();
     assert(cpu_side_port_id != InvalidPortID);
     assert(cpu_side_port_id < respLayers.size());
 
+    // push back on the memory side if the response queue is full
+    if (!respQueueHasSpace(cpu_side_port_id, mem_side_port_id)) {
+        DPRINTF(CXLXBar, "recvTimingResp: src %s %s 0x%x QUEUE FULL\n",
+                src_port->name(), pkt->cmdString(), pkt->getAddr());
+        return false;
+    }
+
     // test if the layer should be considered occupied for the current
     // port
     if (!respLayers[cpu_side_port_id]->tryTiming(src_port)) {
@@ -218,8 +230,8 @@ CXLXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     cpuSidePorts[cpu_side_port_id]->schedTimingResp(pkt,
                                         curTick() + latency);
 
-    // remove the request from the routing table
-    routeTo.erase(route_lookup);
+    // the response has left, remove its route
+    pkt->popRoute();
 
     respLayers[cpu_side_port_id]->succeededTiming(packetFinishTime);
 
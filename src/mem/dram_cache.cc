@@ -0,0 +1,738 @@
+#include "mem/dram_cache.hh"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/bitfield.hh"
+#include "base/cast.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/DRAMCache.hh"
+#include "params/DRAMCache.hh"
+#include "sim/system.hh"
+
+DRAMCache::CPUSidePort::CPUSidePort(const std::string &_name,
+                                    DRAMCache &_cache)
+    : QueuedResponsePort(_name, &_cache, queue),
+      queue(_cache, *this), cache(_cache)
+{
+}
+
+bool
+DRAMCache::CPUSidePort::recvTimingReq(PacketPtr pkt)
+{
+    return cache.recvTimingReq(pkt);
+}
+
+Tick
+DRAMCache::CPUSidePort::recvAtomic(PacketPtr pkt)
+{
+    return cache.recvAtomic(pkt);
+}
+
+void
+DRAMCache::CPUSidePort::recvFunctional(PacketPtr pkt)
+{
+    cache.recvFunctional(pkt);
+}
+
+AddrRangeList
+DRAMCache::CPUSidePort::getAddrRanges() const
+{
+    return cache.memSidePort.getAddrRanges();
+}
+
+DRAMCache::MemSidePort::MemSidePort(const std::string &_name,
+                                    DRAMCache &_cache, bool cache_side)
+    : QueuedRequestPort(_name, &_cache, queue, snoopRespQueue),
+      queue(_cache, *this), snoopRespQueue(_cache, *this), cache(_cache),
+      cacheSide(cache_side)
+{
+    // Evicting a block of many dirty lines queues a burst of packets
+    queue.disableSanityCheck();
+}
+
+bool
+DRAMCache::MemSidePort::recvTimingResp(PacketPtr pkt)
+{
+    cache.recvTimingResp(pkt, cacheSide);
+    return true;
+}
+
+void
+DRAMCache::MemSidePort::recvRangeChange()
+{
+    if (!cacheSide) {
+        cache.cpuSidePort.sendRangeChange();
+    }
+}
+
+DRAMCache::DRAMCache(const DRAMCacheParams *p)
+    : ClockedObject(p),
+      cpuSidePort(name() + ".cpu_side_port", *this),
+      memSidePort(name() + ".mem_side_port", *this, false),
+      cacheSidePort(name() + ".cache_side_port", *this, true),
+      requestorId(p->system->getRequestorId(this)),
+      blockSize(p->block_size), lineSize(p->line_size),
+      linesPerBlock(blockSize / lineSize),
+      responseLatency(p->response_latency),
+      maxOutstanding(p->max_outstanding), data(nullptr),
+      missPredictor(p->miss_predictor_entries,
+                    SatCounter(p->miss_predictor_bits)),
+      outstanding(0), retryReq(false), stats(*this)
+{
+    fatal_if(!isPowerOf2(lineSize) || !isPowerOf2(blockSize) ||
+             blockSize < lineSize,
+             "The block size of %s must be a power of 2 multiple of the "
+             "line size.\n", name());
+    fatal_if(linesPerBlock > 64,
+             "%s can not have more than 64 lines per block.\n", name());
+    fatal_if(maxOutstanding == 0,
+             "%s must handle at least one access.\n", name());
+}
+
+DRAMCache::~DRAMCache()
+{
+    if (data) {
+        munmap(data, frames.size() * blockSize);
+    }
+}
+
+void
+DRAMCache::init()
+{
+    fatal_if(!cpuSidePort.isConnected() || !memSidePort.isConnected() ||
+             !cacheSidePort.isConnected(),
+             "DRAM cache %s is not connected on all sides.\n", name());
+
+    // The ranges of interleaved cache channels are merged into one
+    const AddrRangeList ranges = cacheSidePort.getAddrRanges();
+    fatal_if(ranges.empty(), "The cache side of %s has no range.\n", name());
+    cacheRange = AddrRange(std::vector<AddrRange>(ranges.begin(),
+                                                  ranges.end()));
+    fatal_if(cacheRange.interleaved() || cacheRange.size() < blockSize,
+             "The cache side of %s must be a range of at least a block.\n",
+             name());
+    frames.resize(cacheRange.size() / blockSize);
+
+    // The pages of the data are only backed once they hold lines
+    void *map = mmap(NULL, frames.size() * blockSize,
+                     PROT_READ | PROT_WRITE,
+                     MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE, -1, 0);
+    fatal_if(map == MAP_FAILED, "Could not mmap %d bytes for %s.\n",
+             frames.size() * blockSize, name());
+    data = static_cast<uint8_t*>(map);
+
+    cpuSidePort.sendRangeChange();
+}
+
+Port &
+DRAMCache::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "cpu_side_port") {
+        return cpuSidePort;
+    } else if (if_name == "mem_side_port") {
+        return memSidePort;
+    } else if (if_name == "cache_side_port") {
+        return cacheSidePort;
+    } else {
+        return ClockedObject::getPort(if_name, idx);
+    }
+}
+
+bool
+DRAMCache::isCached(Addr addr) const
+{
+    const Frame &frame = frames[frameOf(addr)];
+    return (frame.tag == addr / blockSize) &&
+        bits(frame.valid, lineOf(addr));
+}
+
+bool
+DRAMCache::predictMiss(const PacketPtr pkt)
+{
+    if (missPredictor.empty() || !pkt->isRead()) {
+        return false;
+    }
+
+    // Accesses without a PC are told apart by their requestor
+    const Addr key = pkt->req->hasPC() ? pkt->req->getPC() :
+                                         pkt->req->requestorId();
+    SatCounter &counter =
+        missPredictor[(key ^ (key >> 8)) % missPredictor.size()];
+    return counter.calcSaturation() >= 0.5;
+}
+
+void
+DRAMCache::recordLookup(const PacketPtr pkt, bool hit, bool predicted_miss)
+{
+    stats.tagReads++;
+
+    if (pkt->isRead()) {
+        if (hit) {
+            stats.readHits++;
+        } else {
+            stats.readMisses++;
+        }
+    } else {
+        if (hit) {
+            stats.writeHits++;
+        } else {
+            stats.writeMisses++;
+        }
+    }
+
+    if (predicted_miss) {
+        stats.predictedMisses++;
+        if (hit) {
+            stats.wastedBackingReads++;
+        }
+    }
+
+    // Train the predictor of the reads with their outcome
+    if (!missPredictor.empty() && pkt->isRead()) {
+        const Addr key = pkt->req->hasPC() ? pkt->req->getPC() :
+                                             pkt->req->requestorId();
+        SatCounter &counter =
+            missPredictor[(key ^ (key >> 8)) % missPredictor.size()];
+        if (hit) {
+            counter--;
+        } else {
+            counter++;
+        }
+    }
+}
+
+PacketPtr
+DRAMCache::createPacket(Addr addr, MemCmd cmd, const uint8_t *src) const
+{
+    RequestPtr req = makeRequest(addr, lineSize, 0, requestorId);
+    PacketPtr pkt = new Packet(req, cmd);
+    pkt->allocate();
+    if (src) {
+        pkt->setData(src);
+    }
+    return pkt;
+}
+
+Tick
+DRAMCache::send(PacketPtr pkt, Transaction *txn, bool cache_side)
+{
+    MemSidePort &port = cache_side ? cacheSidePort : memSidePort;
+
+    if (txn == nullptr) {
+        return port.sendAtomic(pkt);
+    }
+
+    // Packets without a response are deleted by their receiver
+    if (pkt->needsResponse()) {
+        pkt->pushSenderState(new SenderState(txn));
+        txn->outstanding++;
+    }
+    port.schedTimingReq(pkt, std::max(clockEdge(), txn->entryTime));
+    return 0;
+}
+
+void
+DRAMCache::writeLine(Addr frame, unsigned line, Transaction *txn)
+{
+    stats.lineWrites++;
+
+    PacketPtr pkt = createPacket(cacheAddr(frame, line),
+                                 MemCmd::WritebackDirty,
+                                 lineData(frame, line));
+    send(pkt, txn, true);
+    if (txn == nullptr) {
+        delete pkt;
+    }
+}
+
+void
+DRAMCache::allocate(Addr addr, Transaction *txn)
+{
+    const Addr frame_index = frameOf(addr);
+    Frame &frame = frames[frame_index];
+    if (frame.tag == addr / blockSize) {
+        return;
+    }
+
+    // Write back the dirty lines of the block being replaced. The lookup
+    // read the line of the access along with the tag, but the other lines
+    // have to be read from the cache array
+    for (unsigned line = 0; line < linesPerBlock; line++) {
+        if (!bits(frame.dirty, line)) {
+            continue;
+        }
+
+        stats.writebacks++;
+        const Addr victim = frame.tag * blockSize + line * lineSize;
+        DPRINTF(DRAMCache, "Writing back %#x from frame %d\n", victim,
+                frame_index);
+        PacketPtr writeback = createPacket(victim, MemCmd::WriteReq,
+                                           lineData(frame_index, line));
+
+        if (line != lineOf(addr)) {
+            stats.evictionReads++;
+            PacketPtr read = createPacket(cacheAddr(frame_index, line),
+                                          MemCmd::ReadReq, nullptr);
+            send(read, txn, true);
+            if (txn == nullptr) {
+                delete read;
+            } else {
+                // The data only leaves once it is read
+                safe_cast<SenderState*>(read->senderState)->writeback =
+                    writeback;
+                pendingWritebacks.insert(writeback);
+                continue;
+            }
+        }
+
+        send(writeback, txn, false);
+        if (txn == nullptr) {
+            delete writeback;
+        }
+    }
+
+    frame.tag = addr / blockSize;
+    frame.valid = 0;
+    frame.dirty = 0;
+}
+
+void
+DRAMCache::applyWrite(PacketPtr pkt, Transaction *txn)
+{
+    const Addr frame_index = frameOf(pkt->getAddr());
+    const unsigned line = lineOf(pkt->getAddr());
+    Frame &frame = frames[frame_index];
+    assert(frame.tag == pkt->getAddr() / blockSize);
+
+    pkt->writeDataToBlock(lineData(frame_index, line), lineSize);
+    frame.valid |= ULL(1) << line;
+    if (pkt->cmd != MemCmd::WritebackClean) {
+        frame.dirty |= ULL(1) << line;
+    }
+
+    writeLine(frame_index, line, txn);
+}
+
+void
+DRAMCache::installFill(PacketPtr pkt, const uint8_t *fill_data,
+                       Transaction *txn)
+{
+    const Addr frame_index = frameOf(pkt->getAddr());
+    const unsigned line = lineOf(pkt->getAddr());
+
+    allocate(pkt->getAddr(), txn);
+    std::memcpy(lineData(frame_index, line), fill_data, lineSize);
+    frames[frame_index].valid |= ULL(1) << line;
+
+    // A partial write is merged into the line it fetched
+    if (pkt->isWrite()) {
+        applyWrite(pkt, txn);
+    } else {
+        writeLine(frame_index, line, txn);
+    }
+}
+
+void
+DRAMCache::fetch(Transaction *txn)
+{
+    stats.backingReads++;
+    txn->fetched = true;
+    send(createPacket(txn->pkt->getAddr() & ~(lineSize - 1),
+                      MemCmd::ReadReq, nullptr), txn, false);
+}
+
+bool
+DRAMCache::recvTimingReq(PacketPtr pkt)
+{
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    // Uncacheable accesses bypass the cache
+    if (pkt->req->isUncacheable()) {
+        if (pkt->needsResponse()) {
+            pkt->pushSenderState(new SenderState(nullptr));
+        }
+        memSidePort.schedTimingReq(pkt, clockEdge());
+        return true;
+    }
+
+    // Requests that neither read nor write data, e.g., clean evictions,
+    // do not affect the cache
+    if (!pkt->isRead() && !pkt->isWrite()) {
+        if (pkt->needsResponse()) {
+            pkt->makeResponse();
+            cpuSidePort.schedTimingResp(pkt, clockEdge(responseLatency));
+        } else {
+            pendingDelete.reset(pkt);
+        }
+        return true;
+    }
+
+    panic_if(lineOf(pkt->getAddr()) !=
+             lineOf(pkt->getAddr() + pkt->getSize() - 1),
+             "%s does not support accesses across lines, got %s\n", name(),
+             pkt->print());
+
+    if (outstanding >= maxOutstanding) {
+        retryReq = true;
+        return false;
+    }
+    outstanding++;
+
+    // The request reaches the cache after its header and payload delays
+    const Tick receive_delay = pkt->headerDelay + pkt->payloadDelay;
+    pkt->headerDelay = pkt->payloadDelay = 0;
+
+    Transaction *txn = new Transaction(pkt, frameOf(pkt->getAddr()),
+                                       lineOf(pkt->getAddr()),
+                                       curTick() + receive_delay);
+    if (busyFrames.count(txn->frame)) {
+        DPRINTF(DRAMCache, "%s waits for frame %d\n", pkt->print(),
+                txn->frame);
+        waiting[txn->frame].push_back(txn);
+    } else {
+        startAccess(txn);
+    }
+    return true;
+}
+
+void
+DRAMCache::startAccess(Transaction *txn)
+{
+    busyFrames.insert(txn->frame);
+
+    // The frame belongs to the access until it completes, so the outcome
+    // of its lookup is already known, although the access only learns it
+    // once it has read the tag
+    txn->hit = isCached(txn->pkt->getAddr());
+    txn->predictedMiss = predictMiss(txn->pkt);
+
+    DPRINTF(DRAMCache, "%s %s in frame %d%s\n", txn->pkt->print(),
+            txn->hit ? "hits" : "misses", txn->frame,
+            txn->predictedMiss ? ", predicted miss" : "");
+
+    send(createPacket(cacheAddr(txn->frame, txn->line), MemCmd::ReadReq,
+                      nullptr), txn, true);
+
+    // The backing memory is read in parallel with the tag when a miss is
+    // predicted
+    if (txn->predictedMiss) {
+        fetch(txn);
+    }
+}
+
+void
+DRAMCache::recvTimingResp(PacketPtr pkt, bool cache_side)
+{
+    SenderState *state = safe_cast<SenderState*>(pkt->popSenderState());
+    Transaction *txn = state->txn;
+    PacketPtr writeback = state->writeback;
+    delete state;
+
+    // Responses to uncacheable accesses are forwarded
+    if (txn == nullptr) {
+        const Tick receive_delay = pkt->headerDelay + pkt->payloadDelay;
+        pkt->headerDelay = pkt->payloadDelay = 0;
+        cpuSidePort.schedTimingResp(pkt, clockEdge() + receive_delay);
+        return;
+    }
+
+    assert(txn->outstanding > 0);
+    txn->outstanding--;
+
+    if (cache_side) {
+        // The first read of the cache array is the one of the tag, as the
+        // other ones are only sent once the tag has been checked
+        if (!txn->tagChecked) {
+            txn->tagChecked = true;
+            recordLookup(txn->pkt, txn->hit, txn->predictedMiss);
+        }
+        delete pkt;
+
+        // The line read for an eviction goes on to the backing memory
+        if (writeback != nullptr) {
+            pendingWritebacks.erase(writeback);
+            send(writeback, txn, false);
+        }
+    } else if (pkt->isRead()) {
+        txn->fill = pkt;
+    } else {
+        delete pkt;
+    }
+
+    advance(txn);
+}
+
+void
+DRAMCache::advance(Transaction *txn)
+{
+    if (!txn->tagChecked) {
+        return;
+    }
+
+    PacketPtr pkt = txn->pkt;
+    if (pkt != nullptr) {
+        if (txn->hit) {
+            if (pkt->isWrite()) {
+                applyWrite(pkt, txn);
+            }
+            respond(txn);
+        } else if (isFullLineWrite(pkt)) {
+            // A whole line is written without being read
+            allocate(pkt->getAddr(), txn);
+            applyWrite(pkt, txn);
+            respond(txn);
+        } else if (!txn->fetched) {
+            // The miss was not predicted, so it pays for the tag read
+            stats.serialMisses++;
+            fetch(txn);
+        } else if (txn->fill != nullptr) {
+            installFill(pkt, txn->fill->getConstPtr<uint8_t>(), txn);
+            respond(txn);
+        }
+    }
+
+    // The line read in parallel with the tag of a hit is not needed
+    if (txn->fill != nullptr && txn->pkt == nullptr) {
+        delete txn->fill;
+        txn->fill = nullptr;
+    }
+
+    if (txn->pkt == nullptr && txn->outstanding == 0) {
+        finish(txn);
+    }
+}
+
+void
+DRAMCache::respond(Transaction *txn)
+{
+    PacketPtr pkt = txn->pkt;
+    txn->pkt = nullptr;
+
+    if (!pkt->needsResponse()) {
+        delete pkt;
+        return;
+    }
+
+    const Tick when = clockEdge(responseLatency);
+    if (pkt->isRead()) {
+        pkt->setDataFromBlock(lineData(txn->frame, txn->line), lineSize);
+        stats.totalReadLatency += when - txn->entryTime;
+    }
+    pkt->makeResponse();
+    cpuSidePort.schedTimingResp(pkt, when);
+}
+
+void
+DRAMCache::finish(Transaction *txn)
+{
+    const Addr frame = txn->frame;
+    delete txn;
+    outstanding--;
+
+    busyFrames.erase(frame);
+    auto it = waiting.find(frame);
+    if (it != waiting.end()) {
+        Transaction *next = it->second.front();
+        it->second.pop_front();
+        if (it->second.empty()) {
+            waiting.erase(it);
+        }
+        startAccess(next);
+    }
+
+    if (retryReq) {
+        retryReq = false;
+        cpuSidePort.sendRetryReq();
+    }
+
+    if (outstanding == 0 && drainState() == DrainState::Draining) {
+        signalDrainDone();
+    }
+}
+
+Tick
+DRAMCache::recvAtomic(PacketPtr pkt)
+{
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    if (pkt->req->isUncacheable()) {
+        return memSidePort.sendAtomic(pkt);
+    }
+
+    if (!pkt->isRead() && !pkt->isWrite()) {
+        if (pkt->needsResponse()) {
+            pkt->makeResponse();
+        }
+        return 0;
+    }
+
+    const Addr addr = pkt->getAddr();
+    panic_if(lineOf(addr) != lineOf(addr + pkt->getSize() - 1),
+             "%s does not support accesses across lines, got %s\n", name(),
+             pkt->print());
+
+    const bool hit = isCached(addr);
+    const bool predicted_miss = predictMiss(pkt);
+    recordLookup(pkt, hit, predicted_miss);
+
+    PacketPtr tag_read = createPacket(cacheAddr(frameOf(addr), lineOf(addr)),
+                                      MemCmd::ReadReq, nullptr);
+    Tick latency = send(tag_read, nullptr, true);
+    delete tag_read;
+
+    if (hit) {
+        if (pkt->isWrite()) {
+            applyWrite(pkt, nullptr);
+        }
+    } else if (isFullLineWrite(pkt)) {
+        allocate(addr, nullptr);
+        applyWrite(pkt, nullptr);
+    } else {
+        if (!predicted_miss) {
+            stats.serialMisses++;
+        }
+        stats.backingReads++;
+        PacketPtr fill = createPacket(addr & ~(lineSize - 1),
+                                      MemCmd::ReadReq, nullptr);
+        const Tick fetch_latency = send(fill, nullptr, false);
+        latency = predicted_miss ? std::max(latency, fetch_latency) :
+                                   latency + fetch_latency;
+        installFill(pkt, fill->getConstPtr<uint8_t>(), nullptr);
+        delete fill;
+    }
+
+    if (pkt->needsResponse()) {
+        if (pkt->isRead()) {
+            pkt->setDataFromBlock(lineData(frameOf(addr), lineOf(addr)),
+                                  lineSize);
+        }
+        pkt->makeResponse();
+    }
+
+    return latency + cyclesToTicks(responseLatency);
+}
+
+void
+DRAMCache::recvFunctional(PacketPtr pkt)
+{
+    // Responses on their way hold the latest data of their lines
+    if (cpuSidePort.trySatisfyFunctional(pkt)) {
+        return;
+    }
+
+    const Addr addr = pkt->getAddr();
+    if (!pkt->req->isUncacheable() && isCached(addr)) {
+        uint8_t *line_data = lineData(frameOf(addr), lineOf(addr));
+        if (pkt->isRead()) {
+            pkt->setDataFromBlock(line_data, lineSize);
+            pkt->makeResponse();
+            return;
+        }
+
+        // Writes also update the backing memory, in case the line is
+        // clean and dropped later
+        pkt->writeDataToBlock(line_data, lineSize);
+    }
+
+    // Lines being written back are not in the backing memory yet. The
+    // ones waiting for their eviction read are also updated by writes
+    for (PacketPtr writeback : pendingWritebacks) {
+        if (pkt->trySatisfyFunctional(writeback)) {
+            pkt->makeResponse();
+            return;
+        }
+    }
+
+    if (pkt->isRead() && memSidePort.trySatisfyFunctional(pkt)) {
+        pkt->makeResponse();
+        return;
+    }
+
+    memSidePort.sendFunctional(pkt);
+}
+
+DrainState
+DRAMCache::drain()
+{
+    return outstanding == 0 ? DrainState::Drained : DrainState::Draining;
+}
+
+void
+DRAMCache::memWriteback()
+{
+    for (Addr frame_index = 0; frame_index < frames.size(); frame_index++) {
+        Frame &frame = frames[frame_index];
+        for (unsigned line = 0; line < linesPerBlock; line++) {
+            if (bits(frame.dirty, line)) {
+                PacketPtr pkt = createPacket(
+                    frame.tag * blockSize + line * lineSize,
+                    MemCmd::WriteReq, lineData(frame_index, line));
+                memSidePort.sendFunctional(pkt);
+                delete pkt;
+            }
+        }
+        frame.dirty = 0;
+    }
+}
+
+void
+DRAMCache::memInvalidate()
+{
+    for (auto &frame : frames) {
+        frame.valid = 0;
+        frame.dirty = 0;
+    }
+}
+
+DRAMCache::DRAMCacheStats::DRAMCacheStats(DRAMCache &cache)
+    : Stats::Group(&cache),
+    ADD_STAT(readHits, "Number of reads that hit in the cache"),
+    ADD_STAT(readMisses, "Number of reads that missed in the cache"),
+    ADD_STAT(writeHits, "Number of writes that hit in the cache"),
+    ADD_STAT(writeMisses, "Number of writes that missed in the cache"),
+    ADD_STAT(hitRate, "Fraction of the accesses that hit"),
+    ADD_STAT(tagReads, "Number of TAD reads of the cache array to check "
+             "tags"),
+    ADD_STAT(lineWrites, "Number of TAD writes of the cache array to fill "
+             "or update lines"),
+    ADD_STAT(evictionReads, "Number of reads of the cache array to write "
+             "back lines"),
+    ADD_STAT(writebacks, "Number of lines written back"),
+    ADD_STAT(backingReads, "Number of lines read from the backing memory"),
+    ADD_STAT(predictedMisses, "Number of reads predicted to miss"),
+    ADD_STAT(wastedBackingReads, "Number of backing reads of predicted "
+             "misses that hit"),
+    ADD_STAT(serialMisses, "Number of misses that read the backing memory "
+             "after the tag"),
+    ADD_STAT(totalReadLatency, "Total latency of the reads (ticks)"),
+    ADD_STAT(avgReadLatency, "Average latency of the reads (ticks)")
+{
+}
+
+void
+DRAMCache::DRAMCacheStats::regStats()
+{
+    using namespace Stats;
+
+    Stats::Group::regStats();
+
+    hitRate.flags(nozero | nonan);
+    hitRate = (readHits + writeHits) /
+        (readHits + readMisses + writeHits + writeMisses);
+
+    avgReadLatency.flags(nozero | nonan);
+    avgReadLatency = totalReadLatency / (readHits + readMisses);
+}
+
+DRAMCache*
+DRAMCacheParams::create()
+{
+    return new DRAMCache(this);
+}
@@ -0,0 +1,362 @@
+/**
+ * @file
+ * A hardware-managed DRAM cache of a slower memory, e.g., local DRAM or
+ * HBM caching CXL memory.
+ *
+ * The tags are stored in DRAM along with the data (tag-and-data, TAD),
+ * so every lookup is a read of the cache-side memory controller, and
+ * every fill or update of a line is a write to it. This is what sets a
+ * DRAM cache apart from a cache with SRAM tags: the tag reads consume
+ * the bandwidth of the cache memory, on hits and misses alike.
+ *
+ * The cache is direct-mapped. Its blocks are either lines, as in the
+ * Alloy cache, or pages of lines that are filled on demand, as in the
+ * footprint caches like Unison. A lookup reads the TAD unit of the
+ * requested line. A MAP-I miss predictor, indexed by the PC of the
+ * access, decides whether the backing memory is read in parallel with
+ * the lookup, which hides the lookup latency of misses at the cost of
+ * wasted backing reads on mispredicted hits.
+ *
+ * The memory controller of the cache side is only used for its timing,
+ * and should be a null memory outside of the address map; its range
+ * sets the size of the cache. The data of the cache is kept in this
+ * object. Accesses to a block are serialized, so each of them completes
+ * its tag check, fill and eviction before the next one starts.
+ *
+ * @see Qureshi and Loh, "Fundamental Latency Trade-offs in Architecting
+ * DRAM Caches", MICRO 2012, and Jevdjic et al., "Unison Cache: A
+ * Scalable and Effective Die-Stacked DRAM Cache", MICRO 2014.
+ */
+
+#ifndef __MEM_DRAM_CACHE_HH__
+#define __MEM_DRAM_CACHE_HH__
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/sat_counter.hh"
+#include "base/statistics.hh"
+#include "mem/packet.hh"
+#include "mem/qport.hh"
+#include "sim/clocked_object.hh"
+
+struct DRAMCacheParams;
+
+class DRAMCache : public ClockedObject
+{
+  protected:
+    class CPUSidePort : public QueuedResponsePort
+    {
+      public:
+        CPUSidePort(const std::string &_name, DRAMCache &_cache);
+
+      protected:
+        bool recvTimingReq(PacketPtr pkt) override;
+        Tick recvAtomic(PacketPtr pkt) override;
+        void recvFunctional(PacketPtr pkt) override;
+        AddrRangeList getAddrRanges() const override;
+
+      private:
+        RespPacketQueue queue;
+        DRAMCache &cache;
+    };
+
+    /** The ports towards the cache array and towards the backing memory. */
+    class MemSidePort : public QueuedRequestPort
+    {
+      public:
+        MemSidePort(const std::string &_name, DRAMCache &_cache,
+                    bool cache_side);
+
+      protected:
+        bool recvTimingResp(PacketPtr pkt) override;
+        void recvRangeChange() override;
+
+      private:
+        ReqPacketQueue queue;
+        SnoopRespPacketQueue snoopRespQueue;
+        DRAMCache &cache;
+
+        /** Whether the port is connected to the cache array. */
+        const bool cacheSide;
+    };
+
+    /** A block of the cache. */
+    struct Frame
+    {
+        /** Block number of the cached block. */
+        Addr tag = 0;
+
+        /** Lines of the block that hold data, one bit each. */
+        uint64_t valid = 0;
+
+        /** Lines of the block that are dirty, one bit each. */
+        uint64_t dirty = 0;
+    };
+
+    /** An access being handled. It owns its frame until it completes. */
+    struct Transaction
+    {
+        Transaction(PacketPtr _pkt, Addr _frame, unsigned _line,
+                    Tick entry_time)
+            : pkt(_pkt), frame(_frame), line(_line), entryTime(entry_time)
+        {
+        }
+
+        /** The request, until it is responded to or sunk. */
+        PacketPtr pkt;
+
+        /** Frame the request maps to. */
+        const Addr frame;
+
+        /** Line of the block that is accessed. */
+        const unsigned line;
+
+        /** Tick at which the request reached the cache. */
+        const Tick entryTime;
+
+        /** Whether the line was in the cache, known at the tag read. */
+        bool hit = false;
+
+        /** Whether the miss predictor expected a miss. */
+        bool predictedMiss = false;
+
+        /** Whether the TAD read has completed. */
+        bool tagChecked = false;
+
+        /** Whether the line was read from the backing memory. */
+        bool fetched = false;
+
+        /** The response of the backing read of the line, until used. */
+        PacketPtr fill = nullptr;
+
+        /** Packets sent for this access that have not returned. */
+        unsigned outstanding = 0;
+    };
+
+    /** Links the packets sent for an access to it. */
+    struct SenderState : public Packet::SenderState
+    {
+        SenderState(Transaction *_txn) : txn(_txn) {}
+
+        /** The access, or nullptr for uncacheable accesses. */
+        Transaction *txn;
+
+        /**
+         * The writeback of the line read by an eviction read, which is
+         * sent to the backing memory once the read returns.
+         */
+        PacketPtr writeback = nullptr;
+    };
+
+    CPUSidePort cpuSidePort;
+    MemSidePort memSidePort;
+    MemSidePort cacheSidePort;
+
+    /** Requestor id of the packets sent by the cache. */
+    const RequestorID requestorId;
+
+    /** Size of the blocks of the cache. */
+    const Addr blockSize;
+
+    /** Size of a line, and of the accesses to the cache array. */
+    const Addr lineSize;
+
+    /** Number of lines per block. */
+    const unsigned linesPerBlock;
+
+    /** Latency of the tag check and of sending a response. */
+    const Cycles responseLatency;
+
+    /** Maximum number of accesses handled at once. */
+    const unsigned maxOutstanding;
+
+    /** Range of the cache array in the cache-side memory. */
+    AddrRange cacheRange;
+
+    /** The blocks of the cache. */
+    std::vector<Frame> frames;
+
+    /** The data of the cache. */
+    uint8_t *data;
+
+    /** The MAP-I counters. A counter past its midpoint predicts a miss. */
+    std::vector<SatCounter> missPredictor;
+
+    /** Accesses waiting for their frame, by frame. */
+    std::unordered_map<Addr, std::deque<Transaction*>> waiting;
+
+    /** Frames that are owned by an access. */
+    std::unordered_set<Addr> busyFrames;
+
+    /** Number of accesses being handled, including waiting ones. */
+    unsigned outstanding;
+
+    /** Whether a request was refused and needs a retry. */
+    bool retryReq;
+
+    /** Requests that are sunk once the current event completes. */
+    std::unique_ptr<Packet> pendingDelete;
+
+    /**
+     * Writebacks waiting for the eviction read of their line, which
+     * hold the only up to date copy of the line meanwhile.
+     */
+    std::unordered_set<PacketPtr> pendingWritebacks;
+
+    /** Address of a line of a frame in the cache array. */
+    Addr
+    cacheAddr(Addr frame, unsigned line) const
+    {
+        return cacheRange.start() + frame * blockSize + line * lineSize;
+    }
+
+    /** Data of a line of a frame. */
+    uint8_t *
+    lineData(Addr frame, unsigned line) const
+    {
+        return data + frame * blockSize + line * lineSize;
+    }
+
+    /** Frame an address maps to. */
+    Addr
+    frameOf(Addr addr) const
+    {
+        return (addr / blockSize) % frames.size();
+    }
+
+    /** Line of its block an address is in. */
+    unsigned
+    lineOf(Addr addr) const
+    {
+        return (addr % blockSize) / lineSize;
+    }
+
+    /** Whether the line of an address is in the cache. */
+    bool isCached(Addr addr) const;
+
+    /** Whether the MAP-I predictor expects a request to miss. */
+    bool predictMiss(const PacketPtr pkt);
+
+    /** Record the outcome of a lookup, and train the predictor with it. */
+    void recordLookup(const PacketPtr pkt, bool hit, bool predicted_miss);
+
+    /**
+     * Send a packet to the cache array or to the backing memory. In
+     * timing mode it is linked to its access and queued, in atomic mode
+     * it is sent right away and the caller keeps ownership of it.
+     *
+     * @param pkt The packet.
+     * @param txn The access in timing mode, nullptr in atomic mode.
+     * @param cache_side Whether to send it to the cache array.
+     * @return The latency of the packet in atomic mode.
+     */
+    Tick send(PacketPtr pkt, Transaction *txn, bool cache_side);
+
+    /** Create a packet of a line for the cache array or backing memory. */
+    PacketPtr createPacket(Addr addr, MemCmd cmd, const uint8_t *src) const;
+
+    /**
+     * Make a frame hold the block of an address, writing back the dirty
+     * lines of the block it held, which have to be read from the cache
+     * array unless they are the one the lookup already read. In timing
+     * mode, the writeback of a line that is read is only sent once the
+     * read returns.
+     *
+     * @param addr Address being allocated.
+     * @param txn The access in timing mode, nullptr in atomic mode.
+     */
+    void allocate(Addr addr, Transaction *txn);
+
+    /**
+     * Write a line into the cache array, including its tag. The data of
+     * the line must be up to date.
+     */
+    void writeLine(Addr frame, unsigned line, Transaction *txn);
+
+    /**
+     * Apply a write request to a cached line.
+     *
+     * @param pkt The write.
+     * @param txn The access in timing mode, nullptr in atomic mode.
+     */
+    void applyWrite(PacketPtr pkt, Transaction *txn);
+
+    /** Install a line read from the backing memory. */
+    void installFill(PacketPtr pkt, const uint8_t *fill_data,
+                     Transaction *txn);
+
+    /** Whether a write covers its whole line, which then is not read. */
+    bool
+    isFullLineWrite(const PacketPtr pkt) const
+    {
+        return pkt->isWrite() && pkt->getSize() == lineSize;
+    }
+
+    bool recvTimingReq(PacketPtr pkt);
+    Tick recvAtomic(PacketPtr pkt);
+    void recvFunctional(PacketPtr pkt);
+    void recvTimingResp(PacketPtr pkt, bool cache_side);
+
+    /** Read the line of an access from the backing memory. */
+    void fetch(Transaction *txn);
+
+    /** Start an access that owns its frame, by reading its TAD unit. */
+    void startAccess(Transaction *txn);
+
+    /** Move an access forward after one of its packets returned. */
+    void advance(Transaction *txn);
+
+    /** Respond to a request, or sink it if it needs no response. */
+    void respond(Transaction *txn);
+
+    /** Complete an access, and start the next one of its frame. */
+    void finish(Transaction *txn);
+
+    struct DRAMCacheStats : public Stats::Group
+    {
+        DRAMCacheStats(DRAMCache &cache);
+
+        void regStats() override;
+
+        Stats::Scalar readHits;
+        Stats::Scalar readMisses;
+        Stats::Scalar writeHits;
+        Stats::Scalar writeMisses;
+        Stats::Formula hitRate;
+
+        Stats::Scalar tagReads;
+        Stats::Scalar lineWrites;
+        Stats::Scalar evictionReads;
+        Stats::Scalar writebacks;
+        Stats::Scalar backingReads;
+
+        Stats::Scalar predictedMisses;
+        Stats::Scalar wastedBackingReads;
+        Stats::Scalar serialMisses;
+
+        Stats::Scalar totalReadLatency;
+        Stats::Formula avgReadLatency;
+    } stats;
+
+  public:
+    DRAMCache(const DRAMCacheParams *p);
+    ~DRAMCache();
+
+    void init() override;
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+
+    DrainState drain() override;
+
+    void memWriteback() override;
+    void memInvalidate() override;
+};
+
+#endif //__MEM_DRAM_CACHE_HH__
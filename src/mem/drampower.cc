@@ -80,6 +80,8 @@ DRAMPower::getTimingParams(const DRAMInterfaceParams* p)
     timingSpec.RL = divCeil(p->tCL, p->tCK);
     timingSpec.RP = divCeil(p->tRP, p->tCK);
     timingSpec.RFC = divCeil(p->tRFC, p->tCK);
+    // Bank refresh cycle, approximated by DRAMPower when not set
+    timingSpec.REFB = divCeil(p->tRFCsb, p->tCK);
     timingSpec.RAS = divCeil(p->tRAS, p->tCK);
     // Write latency is read latency - 1 cycle
     // Source: B.Jacob Memory Systems Cache, DRAM, Disk
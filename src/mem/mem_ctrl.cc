@@ -40,6 +40,9 @@
 
 #include "mem/mem_ctrl.hh"
 
+#include <algorithm>
+
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
 #include "debug/Drain.hh"
@@ -51,6 +54,93 @@
 
 using namespace std;
 
+void
+MemPacketIndex::init(unsigned num_banks)
+{
+    banks.assign(num_banks, std::vector<RowList>());
+    waitingBanks.assign(divCeil(num_banks, 64), 0);
+}
+
+void
+MemPacketIndex::insert(MemPacketQueue::iterator it)
+{
+    const MemPacket *pkt = *it;
+    if (!pkt->isDram())
+        return;
+
+    auto &rows = banks[pkt->bankId];
+    auto row = std::find_if(rows.begin(), rows.end(),
+                            [pkt](const RowList &r)
+                            { return r.row == pkt->row; });
+    if (row == rows.end()) {
+        rows.push_back(RowList());
+        row = std::prev(rows.end());
+        row->row = pkt->row;
+    }
+
+    row->entries.push_back({it, nextSeq++});
+    waitingBanks[pkt->bankId / 64] |= ULL(1) << (pkt->bankId % 64);
+}
+
+void
+MemPacketIndex::remove(const MemPacket *pkt)
+{
+    if (!pkt->isDram())
+        return;
+
+    auto &rows = banks[pkt->bankId];
+    auto row = std::find_if(rows.begin(), rows.end(),
+                            [pkt](const RowList &r)
+                            { return r.row == pkt->row; });
+    assert(row != rows.end());
+
+    // the scheduler mostly picks the oldest packet of a row, so this
+    // is normally found straight away
+    auto entry = std::find_if(row->entries.begin(), row->entries.end(),
+                              [pkt](const Entry &e)
+                              { return *e.it == pkt; });
+    assert(entry != row->entries.end());
+    row->entries.erase(entry);
+
+    if (row->entries.empty()) {
+        rows.erase(row);
+        if (rows.empty())
+            waitingBanks[pkt->bankId / 64] &=
+                ~(ULL(1) << (pkt->bankId % 64));
+    }
+}
+
+void
+MemPacketIndex::rebuild(MemPacketQueue &queue)
+{
+    init(banks.size());
+    for (auto it = queue.begin(); it != queue.end(); ++it)
+        insert(it);
+}
+
+const MemPacketIndex::Entry *
+MemPacketIndex::firstHit(unsigned bank_id, uint32_t row) const
+{
+    for (const auto &r : banks[bank_id]) {
+        if (r.row == row)
+            return &r.entries.front();
+    }
+    return nullptr;
+}
+
+const MemPacketIndex::Entry *
+MemPacketIndex::firstMiss(unsigned bank_id, uint32_t row) const
+{
+    const Entry *first = nullptr;
+    for (const auto &r : banks[bank_id]) {
+        if (r.row != row &&
+            (!first || r.entries.front().seq < first->seq)) {
+            first = &r.entries.front();
+        }
+    }
+    return first;
+}
+
 MemCtrl::MemCtrl(const MemCtrlParams* p) :
     QoS::MemCtrl(p),
     port(name() + ".port", *this), isTimingMode(false),
@@ -67,6 +157,9 @@ MemCtrl::MemCtrl(const MemCtrlParams* p) :
     minWritesPerSwitch(p->min_writes_per_switch),
     writesThisTime(0), readsThisTime(0),
     memSchedPolicy(p->mem_sched_policy),
+    indexedSched(p->indexed_sched && dram &&
+                 memSchedPolicy == Enums::frfcfs),
+    checkSchedIndex(p->check_sched_index),
     frontendLatency(p->static_frontend_latency),
     backendLatency(p->static_backend_latency),
     commandWindow(p->command_window),
@@ -78,6 +171,15 @@ MemCtrl::MemCtrl(const MemCtrlParams* p) :
     readQueue.resize(p->qos_priorities);
     writeQueue.resize(p->qos_priorities);
 
+    if (indexedSched) {
+        readIndex.resize(p->qos_priorities);
+        writeIndex.resize(p->qos_priorities);
+        for (auto &index : readIndex)
+            index.init(dram->numBanks());
+        for (auto &index : writeIndex)
+            index.init(dram->numBanks());
+    }
+
     // Hook up interfaces to the controller
     if (dram)
         dram->setCtrl(this, commandWindow);
@@ -265,6 +367,10 @@ MemCtrl::addToReadQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram)
             DPRINTF(MemCtrl, "Adding to read queue\n");
 
             readQueue[mem_pkt->qosValue()].push_back(mem_pkt);
+            if (indexedSched) {
+                readIndex[mem_pkt->qosValue()].insert(
+                    std::prev(readQueue[mem_pkt->qosValue()].end()));
+            }
 
             // log packet
             logRequest(MemCtrl::READ, pkt->requestorId(), pkt->qosValue(),
@@ -338,6 +444,10 @@ MemCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram)
             DPRINTF(MemCtrl, "Adding to write queue\n");
 
             writeQueue[mem_pkt->qosValue()].push_back(mem_pkt);
+            if (indexedSched) {
+                writeIndex[mem_pkt->qosValue()].insert(
+                    std::prev(writeQueue[mem_pkt->qosValue()].end()));
+            }
             isInWriteQueue.insert(burstAlign(addr, is_dram));
 
             // log packet
@@ -446,6 +556,14 @@ MemCtrl::recvTimingReq(PacketPtr pkt)
     // run the QoS scheduler and assign a QoS priority value to the packet
     qosSchedule( { &readQueue, &writeQueue }, burst_size, pkt);
 
+    // escalation may have moved queued packets to other priorities
+    if (indexedSched && qosPriorityEscalation) {
+        for (uint8_t i = 0; i < numPriorities(); ++i) {
+            readIndex[i].rebuild(readQueue[i]);
+            writeIndex[i].rebuild(writeQueue[i]);
+        }
+    }
+
     // check local buffers and do not accept if full
     if (pkt->isWrite()) {
         assert(size != 0);
@@ -594,7 +712,7 @@ MemCtrl::chooseNextFRFCFS(MemPacketQueue& queue, Tick extra_col_delay)
         // Select packet by default to give priority if both
         // can issue at the same time or seamlessly
         std::tie(selected_pkt_it, col_allowed_at) =
-                 dram->chooseNextFRFCFS(queue, min_col_at);
+                 chooseNextDRAM(queue, min_col_at);
         std::tie(nvm_pkt_it, nvm_col_at) =
                  nvm->chooseNextFRFCFS(queue, min_col_at);
 
@@ -605,7 +723,7 @@ MemCtrl::chooseNextFRFCFS(MemPacketQueue& queue, Tick extra_col_delay)
         }
     } else if (dram) {
         std::tie(selected_pkt_it, col_allowed_at) =
-                 dram->chooseNextFRFCFS(queue, min_col_at);
+                 chooseNextDRAM(queue, min_col_at);
     } else if (nvm) {
         std::tie(selected_pkt_it, col_allowed_at) =
                  nvm->chooseNextFRFCFS(queue, min_col_at);
@@ -618,6 +736,44 @@ MemCtrl::chooseNextFRFCFS(MemPacketQueue& queue, Tick extra_col_delay)
     return selected_pkt_it;
 }
 
+pair<MemPacketQueue::iterator, Tick>
+MemCtrl::chooseNextDRAM(MemPacketQueue& queue, Tick min_col_at)
+{
+    if (!indexedSched)
+        return dram->chooseNextFRFCFS(queue, min_col_at);
+
+    auto selected = dram->chooseNextFRFCFS(queue, queueIndex(queue),
+                                           min_col_at);
+
+    if (checkSchedIndex) {
+        auto expected = dram->chooseNextFRFCFS(queue, min_col_at);
+        panic_if(selected.first != expected.first ||
+                 (selected.first != queue.end() &&
+                  selected.second != expected.second),
+                 "Indexed FR-FCFS chose %s instead of %s\n",
+                 selected.first == queue.end() ? "nothing" :
+                 csprintf("%#x", (*selected.first)->getAddr()),
+                 expected.first == queue.end() ? "nothing" :
+                 csprintf("%#x", (*expected.first)->getAddr()));
+    }
+
+    return selected;
+}
+
+const MemPacketIndex&
+MemCtrl::queueIndex(const MemPacketQueue& queue) const
+{
+    // the queue is one of the read or write queues, and its index is
+    // at the same position in the corresponding vector of indexes
+    if (&queue >= readQueue.data() &&
+        &queue < readQueue.data() + readQueue.size()) {
+        return readIndex[&queue - readQueue.data()];
+    }
+    assert(&queue >= writeQueue.data() &&
+           &queue < writeQueue.data() + writeQueue.size());
+    return writeIndex[&queue - writeQueue.data()];
+}
+
 void
 MemCtrl::accessAndRespond(PacketPtr pkt, Tick static_latency)
 {
@@ -625,11 +781,15 @@ MemCtrl::accessAndRespond(PacketPtr pkt, Tick static_latency)
 
     bool needsResponse = pkt->needsResponse();
     // do the actual memory access which also turns the packet into a
-    // response
+    // response, and compress the data of the response if the interface
+    // does link compression
+    Tick compression_delay = 0;
     if (dram && dram->getAddrRange().contains(pkt->getAddr())) {
         dram->access(pkt);
+        compression_delay = dram->compressForLink(pkt);
     } else if (nvm && nvm->getAddrRange().contains(pkt->getAddr())) {
         nvm->access(pkt);
+        compression_delay = nvm->compressForLink(pkt);
     } else {
         panic("Can't handle address range for packet %s\n",
               pkt->print());
@@ -644,7 +804,7 @@ MemCtrl::accessAndRespond(PacketPtr pkt, Tick static_latency)
         // the xbar and also the payloadDelay that takes into account the
         // number of data beats.
         Tick response_time = curTick() + static_latency + pkt->headerDelay +
-                             pkt->payloadDelay;
+                             pkt->payloadDelay + compression_delay;
         // Here we reset the timing of the packet before sending it out.
         pkt->headerDelay = pkt->payloadDelay = 0;
 
@@ -662,6 +822,13 @@ MemCtrl::accessAndRespond(PacketPtr pkt, Tick static_latency)
     return;
 }
 
+bool
+MemCtrl::isRowOpen(Addr addr) const
+{
+    return dram && dram->getAddrRange().contains(addr) &&
+        dram->isRowOpen(addr);
+}
+
 void
 MemCtrl::pruneBurstTick()
 {
@@ -844,12 +1011,16 @@ MemCtrl::doBurstAccess(MemPacket* mem_pkt)
         // Update latency stats
         stats.requestorReadTotalLat[mem_pkt->requestorId()] +=
             mem_pkt->readyTime - mem_pkt->entryTime;
+        stats.requestorReadLatQuantiles[mem_pkt->requestorId()].sample(
+            mem_pkt->readyTime - mem_pkt->entryTime);
         stats.requestorReadBytes[mem_pkt->requestorId()] += mem_pkt->size;
     } else {
         ++writesThisTime;
         stats.requestorWriteBytes[mem_pkt->requestorId()] += mem_pkt->size;
         stats.requestorWriteTotalLat[mem_pkt->requestorId()] +=
             mem_pkt->readyTime - mem_pkt->entryTime;
+        stats.requestorWriteLatQuantiles[mem_pkt->requestorId()].sample(
+            mem_pkt->readyTime - mem_pkt->entryTime);
     }
 }
 
@@ -1032,6 +1203,8 @@ MemCtrl::processNextReqEvent()
 
             // remove the request from the queue
             // the iterator is no longer valid .
+            if (indexedSched)
+                readIndex[mem_pkt->qosValue()].remove(mem_pkt);
             readQueue[mem_pkt->qosValue()].erase(to_read);
         }
 
@@ -1096,6 +1269,8 @@ MemCtrl::processNextReqEvent()
 
 
         // remove the request from the queue - the iterator is no longer valid
+        if (indexedSched)
+            writeIndex[mem_pkt->qosValue()].remove(mem_pkt);
         writeQueue[mem_pkt->qosValue()].erase(to_write);
 
         delete mem_pkt;
@@ -1237,7 +1412,11 @@ MemCtrl::CtrlStats::CtrlStats(MemCtrl &_ctrl)
     ADD_STAT(requestorReadAvgLat,
              "Per-requestor read average memory access latency"),
     ADD_STAT(requestorWriteAvgLat,
-             "Per-requestor write average memory access latency")
+             "Per-requestor write average memory access latency"),
+    ADD_STAT(requestorReadLatQuantiles,
+             "Per-requestor read memory access latency quantiles"),
+    ADD_STAT(requestorWriteLatQuantiles,
+             "Per-requestor write memory access latency quantiles")
 
 {
 }
@@ -1312,6 +1491,14 @@ MemCtrl::CtrlStats::regStats()
         .flags(nonan)
         .precision(2);
 
+    requestorReadLatQuantiles
+        .init(max_requestors)
+        .flags(nozero);
+
+    requestorWriteLatQuantiles
+        .init(max_requestors)
+        .flags(nozero);
+
     for (int i = 0; i < max_requestors; i++) {
         const std::string requestor = ctrl.system()->getRequestorName(i);
         requestorReadBytes.subname(i, requestor);
@@ -1324,6 +1511,8 @@ MemCtrl::CtrlStats::regStats()
         requestorReadAvgLat.subname(i, requestor);
         requestorWriteTotalLat.subname(i, requestor);
         requestorWriteAvgLat.subname(i, requestor);
+        requestorReadLatQuantiles.subname(i, requestor);
+        requestorWriteLatQuantiles.subname(i, requestor);
     }
 
     // Formula stats
@@ -47,11 +47,13 @@
 #define __MEM_CTRL_HH__
 
 #include <deque>
+#include <list>
 #include <string>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "base/bitfield.hh"
 #include "base/callback.hh"
 #include "base/statistics.hh"
 #include "enums/MemSched.hh"
@@ -205,9 +207,90 @@ class MemPacket
 
 };
 
-// The memory packets are store in a multiple dequeue structure,
-// based on their QoS priority
-typedef std::deque<MemPacket*> MemPacketQueue;
+// The memory packets are store in a multiple list structure,
+// based on their QoS priority. A list is used so that the scheduler
+// index can hold on to the position of a packet in its queue.
+typedef std::list<MemPacket*> MemPacketQueue;
+
+/**
+ * Index of the DRAM packets in one of the read or write queues of the
+ * controller, letting the FR-FCFS scheduler find the oldest row hit or
+ * bank conflict of a bank without looking at every queued packet. The
+ * packets of each bank are kept in per-row lists, in the order they
+ * were queued, and a bitmap records which banks have packets waiting.
+ * A sequence number per packet preserves the order of the queue
+ * across banks and rows.
+ */
+class MemPacketIndex
+{
+  public:
+
+    struct Entry
+    {
+        MemPacketQueue::iterator it;
+        uint64_t seq;
+    };
+
+    MemPacketIndex() : nextSeq(0) {}
+
+    /**
+     * Size the index for the given number of banks, any packets in
+     * the index are dropped.
+     */
+    void init(unsigned num_banks);
+
+    /**
+     * Add the packet at the given position, which has to be the back
+     * of the queue, to the index. Non-DRAM packets are not indexed.
+     */
+    void insert(MemPacketQueue::iterator it);
+
+    /** Remove a packet that is about to leave the queue */
+    void remove(const MemPacket *pkt);
+
+    /** Rebuild the index from all the packets in a queue */
+    void rebuild(MemPacketQueue &queue);
+
+    /** Check if any packets to the bank are indexed */
+    bool
+    waiting(unsigned bank_id) const
+    {
+        return bits(waitingBanks[bank_id / 64], bank_id % 64);
+    }
+
+    /** One bit per bank, set when packets to the bank are waiting */
+    const std::vector<uint64_t> &waitingBankMask() const
+    { return waitingBanks; }
+
+    /**
+     * Oldest packet to the given row of a bank.
+     *
+     * @return the entry, or nullptr if there is none
+     */
+    const Entry *firstHit(unsigned bank_id, uint32_t row) const;
+
+    /**
+     * Oldest packet to any other than the given row of a bank.
+     *
+     * @return the entry, or nullptr if there is none
+     */
+    const Entry *firstMiss(unsigned bank_id, uint32_t row) const;
+
+  private:
+
+    struct RowList
+    {
+        uint32_t row;
+        std::deque<Entry> entries;
+    };
+
+    /** Per bank, the rows with packets waiting */
+    std::vector<std::vector<RowList>> banks;
+
+    std::vector<uint64_t> waitingBanks;
+
+    uint64_t nextSeq;
+};
 
 
 /**
@@ -402,6 +485,23 @@ class MemCtrl : public QoS::MemCtrl
     MemPacketQueue::iterator chooseNextFRFCFS(MemPacketQueue& queue,
             Tick extra_col_delay);
 
+    /**
+     * Find the first DRAM command that can issue with FR-FCFS, using
+     * the index of the queue if enabled.
+     *
+     * @param queue Queued requests to consider
+     * @param min_col_at Minimum tick for 'seamless' issue
+     * @return an iterator to the selected packet, else queue.end()
+     * @return the tick when the packet selected will issue
+     */
+    std::pair<MemPacketQueue::iterator, Tick>
+    chooseNextDRAM(MemPacketQueue& queue, Tick min_col_at);
+
+    /**
+     * Get the index of one of the read or write queues.
+     */
+    const MemPacketIndex& queueIndex(const MemPacketQueue& queue) const;
+
     /**
      * Calculate burst window aligned tick
      *
@@ -432,6 +532,13 @@ class MemCtrl : public QoS::MemCtrl
     std::vector<MemPacketQueue> readQueue;
     std::vector<MemPacketQueue> writeQueue;
 
+    /**
+     * Indexes of the DRAM packets in the read and write queues, one
+     * per QoS priority, only maintained when indexedSched is set
+     */
+    std::vector<MemPacketIndex> readIndex;
+    std::vector<MemPacketIndex> writeIndex;
+
     /**
      * To avoid iterating over the write queue to check for
      * overlapping transactions, maintain a set of burst addresses
@@ -488,6 +595,14 @@ class MemCtrl : public QoS::MemCtrl
      */
     Enums::MemSched memSchedPolicy;
 
+    /**
+     * Use the indexes of the queues to schedule DRAM packets with
+     * FR-FCFS, and optionally check each decision against a scan of
+     * the queue.
+     */
+    const bool indexedSched;
+    const bool checkSchedIndex;
+
     /**
      * Pipeline latency of the controller frontend. The frontend
      * contribution is added to writes (that complete when they are in
@@ -581,6 +696,10 @@ class MemCtrl : public QoS::MemCtrl
         // per-requestor raed and write average memory access latency
         Stats::Formula requestorReadAvgLat;
         Stats::Formula requestorWriteAvgLat;
+
+        // per-requestor read and write memory access latency quantiles
+        Stats::VectorQuantileSketch requestorReadLatQuantiles;
+        Stats::VectorQuantileSketch requestorWriteLatQuantiles;
     };
 
     CtrlStats stats;
@@ -691,6 +810,28 @@ class MemCtrl : public QoS::MemCtrl
      */
     bool inWriteBusState(bool next_state) const;
 
+    /**
+     * Check whether the write queue is below its low threshold, so
+     * that more writes can be queued without forcing a switch of the
+     * bus to writes
+     *
+     * @return True when the write queue is below the low threshold
+     */
+    bool
+    isWriteQueueLow() const
+    {
+        return totalWriteQueueSize < writeLowThreshold;
+    }
+
+    /**
+     * Check whether an address maps to a row that is currently open in
+     * the DRAM of this controller
+     *
+     * @param addr The address
+     * @return True when the address is in the DRAM and its row is open
+     */
+    bool isRowOpen(Addr addr) const;
+
     Port &getPort(const std::string &if_name,
                   PortID idx=InvalidPortID) override;
 
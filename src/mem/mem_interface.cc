@@ -54,6 +54,8 @@ using namespace Data;
 MemInterface::MemInterface(const MemInterfaceParams* _p)
     : AbstractMemory(_p),
       addrMapping(_p->addr_mapping),
+      addrPermutation(_p->addr_permutation),
+      bankXorMasks(_p->bank_xor_masks), rankXorMasks(_p->rank_xor_masks),
       burstSize((_p->devices_per_rank * _p->burst_length *
                  _p->device_bus_width) / 8),
       deviceSize(_p->device_size),
@@ -70,7 +72,31 @@ MemInterface::MemInterface(const MemInterfaceParams* _p)
       tWTR(_p->tWTR),
       readBufferSize(_p->read_buffer_size),
       writeBufferSize(_p->write_buffer_size)
-{}
+{
+    // the permutation must move every bit once, and keep the bits
+    // within a burst in place
+    const unsigned burst_bits = floorLog2(burstSize);
+    std::vector<bool> moved(addrPermutation.size(), false);
+    for (unsigned i = 0; i < addrPermutation.size(); i++) {
+        const unsigned src = addrPermutation[i];
+        fatal_if(src >= addrPermutation.size() || moved[src],
+                 "%s: the address bits are not a permutation\n", name());
+        fatal_if(i < burst_bits && src != i,
+                 "%s: the address permutation can not move the bits "
+                 "within a burst\n", name());
+        moved[src] = true;
+    }
+
+    // the hashed bits must exist
+    fatal_if(!bankXorMasks.empty() && (!isPowerOf2(banksPerRank) ||
+             bankXorMasks.size() > (unsigned)floorLog2(banksPerRank)),
+             "%s: %d bank masks for %d banks\n", name(),
+             bankXorMasks.size(), banksPerRank);
+    fatal_if(!rankXorMasks.empty() && (!isPowerOf2(ranksPerChannel) ||
+             rankXorMasks.size() > (unsigned)floorLog2(ranksPerChannel)),
+             "%s: %d rank masks for %d ranks\n", name(),
+             rankXorMasks.size(), ranksPerChannel);
+}
 
 void
 MemInterface::setCtrl(MemCtrl* _ctrl, unsigned int command_window)
@@ -83,17 +109,49 @@ MemPacket*
 MemInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
                        unsigned size, bool is_read, bool is_dram)
 {
-    // decode the address based on the address mapping scheme, with
-    // Ro, Ra, Co, Ba and Ch denoting row, rank, column, bank and
-    // channel, respectively
     uint8_t rank;
     uint8_t bank;
-    // use a 64-bit unsigned during the computations as the row is
-    // always the top bits, and check before creating the packet
     uint64_t row;
+    decodeAddr(pkt_addr, rank, bank, row);
+
+    DPRINTF(DRAM, "Address: %lld Rank %d Bank %d Row %d\n",
+            pkt_addr, rank, bank, row);
+
+    // create the corresponding memory packet with the entry time and
+    // ready time set to the current tick, the latter will be updated
+    // later
+    uint16_t bank_id = banksPerRank * rank + bank;
 
-    // Get packed address, starting at 0
-    Addr addr = getCtrlAddr(pkt_addr);
+    return new MemPacket(pkt, is_read, is_dram, rank, bank, row, bank_id,
+                   pkt_addr, size);
+}
+
+Addr
+MemInterface::permuteAddr(Addr addr) const
+{
+    if (addrPermutation.empty()) {
+        return addr;
+    }
+
+    // the bits above the permutation are kept as they are
+    Addr permuted = addr & ~mask(addrPermutation.size());
+    for (unsigned i = 0; i < addrPermutation.size(); i++) {
+        permuted |= bits(addr, addrPermutation[i]) << i;
+    }
+    return permuted;
+}
+
+void
+MemInterface::decodeAddr(Addr pkt_addr, uint8_t &rank, uint8_t &bank,
+                         uint64_t &row) const
+{
+    // decode the address based on the address mapping scheme, with
+    // Ro, Ra, Co, Ba and Ch denoting row, rank, column, bank and
+    // channel, respectively
+
+    // Get packed address, starting at 0, with its bits permuted
+    Addr addr = permuteAddr(getCtrlAddr(pkt_addr));
+    const Addr hash_addr = addr;
 
     // truncate the address to a memory burst, which makes it unique to
     // a specific buffer, row, bank, rank and channel
@@ -148,21 +206,18 @@ MemInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
     } else
         panic("Unknown address mapping policy chosen!");
 
+    // hash the bank and rank bits with the other address bits
+    for (unsigned i = 0; i < bankXorMasks.size(); i++) {
+        bank ^= (popCount(hash_addr & bankXorMasks[i]) & 1) << i;
+    }
+    for (unsigned i = 0; i < rankXorMasks.size(); i++) {
+        rank ^= (popCount(hash_addr & rankXorMasks[i]) & 1) << i;
+    }
+
     assert(rank < ranksPerChannel);
     assert(bank < banksPerRank);
     assert(row < rowsPerBank);
     assert(row < Bank::NO_ROW);
-
-    DPRINTF(DRAM, "Address: %lld Rank %d Bank %d Row %d\n",
-            pkt_addr, rank, bank, row);
-
-    // create the corresponding memory packet with the entry time and
-    // ready time set to the current tick, the latter will be updated
-    // later
-    uint16_t bank_id = banksPerRank * rank + bank;
-
-    return new MemPacket(pkt, is_read, is_dram, rank, bank, row, bank_id,
-                   pkt_addr, size);
 }
 
 pair<MemPacketQueue::iterator, Tick>
@@ -280,6 +335,111 @@ DRAMInterface::chooseNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const
     return make_pair(selected_pkt_it, selected_col_at);
 }
 
+pair<MemPacketQueue::iterator, Tick>
+DRAMInterface::chooseNextFRFCFS(MemPacketQueue& queue,
+                                const MemPacketIndex& index,
+                                Tick min_col_at) const
+{
+    // This follows the selection made by looking at the whole queue:
+    // the oldest row hit that can issue seamlessly, else the oldest
+    // packet to one of the banks that can be prepared first if that
+    // can be done without delaying the data bus, else the oldest row
+    // hit, else the oldest packet to one of the earliest banks. Only
+    // the oldest row hit and the oldest conflict of each bank with
+    // packets waiting have to be considered to find them.
+    const MemPacketIndex::Entry* seamless_hit = nullptr;
+    const MemPacketIndex::Entry* prepped_hit = nullptr;
+    Tick seamless_col_at = MaxTick;
+    Tick prepped_col_at = MaxTick;
+
+    vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
+    bool got_conflict = false;
+
+    const auto& waiting_mask = index.waitingBankMask();
+    for (unsigned w = 0; w < waiting_mask.size(); ++w) {
+        for (uint64_t mask = waiting_mask[w]; mask; mask &= mask - 1) {
+            const unsigned bank_id = w * 64 + ctz64(mask);
+            const Rank& rank = *ranks[bank_id / banksPerRank];
+
+            // skip banks of ranks that are refreshing
+            if (!rank.inRefIdleState())
+                continue;
+
+            got_waiting[bank_id] = true;
+
+            const Bank& bank = rank.banks[bank_id % banksPerRank];
+            const MemPacketIndex::Entry* hit =
+                index.firstHit(bank_id, bank.openRow);
+
+            if (hit) {
+                const Tick col_allowed_at = (*hit->it)->isRead() ?
+                    bank.rdAllowedAt : bank.wrAllowedAt;
+
+                if (col_allowed_at <= min_col_at &&
+                    (!seamless_hit || hit->seq < seamless_hit->seq)) {
+                    seamless_hit = hit;
+                    seamless_col_at = col_allowed_at;
+                }
+
+                if (!prepped_hit || hit->seq < prepped_hit->seq) {
+                    prepped_hit = hit;
+                    prepped_col_at = col_allowed_at;
+                }
+            }
+
+            got_conflict |= index.firstMiss(bank_id, bank.openRow) != nullptr;
+        }
+    }
+
+    if (seamless_hit) {
+        DPRINTF(DRAM, "%s Seamless buffer hit\n", __func__);
+        return make_pair(seamless_hit->it, seamless_col_at);
+    }
+
+    const MemPacketIndex::Entry* earliest = nullptr;
+    Tick earliest_col_at = MaxTick;
+    bool hidden_bank_prep = false;
+
+    if (got_conflict) {
+        vector<uint32_t> earliest_banks;
+        std::tie(earliest_banks, hidden_bank_prep) =
+            minBankPrep(got_waiting, min_col_at);
+
+        for (unsigned bank_id = 0; bank_id < got_waiting.size(); ++bank_id) {
+            const unsigned r = bank_id / banksPerRank;
+            const unsigned b = bank_id % banksPerRank;
+            if (!got_waiting[bank_id] || !bits(earliest_banks[r], b, b))
+                continue;
+
+            const Bank& bank = ranks[r]->banks[b];
+            const MemPacketIndex::Entry* miss =
+                index.firstMiss(bank_id, bank.openRow);
+
+            if (miss && (!earliest || miss->seq < earliest->seq)) {
+                earliest = miss;
+                earliest_col_at = (*miss->it)->isRead() ?
+                    bank.rdAllowedAt : bank.wrAllowedAt;
+            }
+        }
+    }
+
+    // give priority to packets that can issue bank commands 'behind
+    // the scenes', then to row hits
+    if (earliest && hidden_bank_prep)
+        return make_pair(earliest->it, earliest_col_at);
+
+    if (prepped_hit) {
+        DPRINTF(DRAM, "%s Prepped row buffer hit\n", __func__);
+        return make_pair(prepped_hit->it, prepped_col_at);
+    }
+
+    if (earliest)
+        return make_pair(earliest->it, earliest_col_at);
+
+    DPRINTF(DRAM, "%s no available DRAM ranks found\n", __func__);
+    return make_pair(queue.end(), MaxTick);
+}
+
 void
 DRAMInterface::activateBank(Rank& rank_ref, Bank& bank_ref,
                        Tick act_tick, uint32_t row)
@@ -486,6 +646,7 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
 
         // If there is a page open, precharge it.
         if (bank_ref.openRow != Bank::NO_ROW) {
+            stats.bankConflicts++;
             prechargeBank(rank_ref, bank_ref, std::max(bank_ref.preAllowedAt,
                                                    curTick()));
         }
@@ -540,6 +701,15 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
     // bank (add a max with tCCD/tCCD_L/tCCD_L_WR here)
     Tick dly_to_rd_cmd;
     Tick dly_to_wr_cmd;
+
+    // with on-die ECC, a write of part of a burst reads the rest of the
+    // code word first, which holds its bank group for longer
+    const bool rmw = onDieECC && !mem_pkt->isRead() &&
+                     mem_pkt->size < burstSize;
+    if (rmw) {
+        stats.rmwWrites++;
+    }
+
     for (int j = 0; j < ranksPerChannel; j++) {
         for (int i = 0; i < banksPerRank; i++) {
             if (mem_pkt->rank == j) {
@@ -563,6 +733,11 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
                     dly_to_wr_cmd = mem_pkt->isRead() ? readToWriteDelay() :
                                                        burst_gap;
                 }
+                // without bank groups, only the bank itself is held
+                if (rmw && (bank_ref.bankgr == ranks[j]->banks[i].bankgr)) {
+                    dly_to_rd_cmd = std::max(dly_to_rd_cmd, tCCD_L_WR_RMW);
+                    dly_to_wr_cmd = std::max(dly_to_wr_cmd, tCCD_L_WR_RMW);
+                }
             } else {
                 // different rank is by default in a different bank group and
                 // doesn't require longer tCCD or additional RTW, WTR delays
@@ -738,7 +913,10 @@ DRAMInterface::DRAMInterface(const DRAMInterfaceParams* _p)
       tBURST_MIN(_p->tBURST_MIN), tBURST_MAX(_p->tBURST_MAX),
       tCCD_L_WR(_p->tCCD_L_WR), tCCD_L(_p->tCCD_L), tRCD(_p->tRCD),
       tRP(_p->tRP), tRAS(_p->tRAS), tWR(_p->tWR), tRTP(_p->tRTP),
-      tRFC(_p->tRFC), tREFI(_p->tREFI), tRRD(_p->tRRD), tRRD_L(_p->tRRD_L),
+      tRFC(_p->tRFC), tREFI(_p->tREFI), tRFCsb(_p->tRFCsb),
+      tCCD_L_WR_RMW(_p->tCCD_L_WR_RMW), refreshMode(_p->refresh_mode),
+      tREFIsb(0), onDieECC(_p->on_die_ecc),
+      tRRD(_p->tRRD), tRRD_L(_p->tRRD_L),
       tPPD(_p->tPPD), tAAD(_p->tAAD),
       tXAW(_p->tXAW), tXP(_p->tXP), tXS(_p->tXS),
       clkResyncDelay(tCL + _p->tBURST_MAX),
@@ -831,6 +1009,26 @@ DRAMInterface::DRAMInterface(const DRAMInterfaceParams* _p)
                   tRRD_L, tRRD, bankGroupsPerRank);
         }
     }
+
+    // with a bank refresh, the refreshes of the banks are spread evenly
+    // over tREFI, each one refreshing the same bank of every bank group,
+    // or a single bank
+    if (refreshMode != Enums::all_bank) {
+        if (refreshMode == Enums::same_bank) {
+            fatal_if(!bankGroupArch, "Same bank refresh requires bank "
+                     "groups\n");
+            tREFIsb = tREFI / (banksPerRank / bankGroupsPerRank);
+        } else {
+            tREFIsb = tREFI / banksPerRank;
+        }
+        fatal_if(tRFCsb == 0 || tREFIsb <= tRP + tRFCsb,
+                 "Bank refresh interval (%d) must be larger than tRP (%d) "
+                 "and tRFCsb (%d)\n", tREFIsb, tRP, tRFCsb);
+        // the bank refresh does not wake the rank up, nor exit
+        // self-refresh
+        fatal_if(enableDRAMPowerdown, "Bank refresh can not be used with "
+                 "the DRAM powerdown states\n");
+    }
 }
 
 void
@@ -882,12 +1080,26 @@ DRAMInterface::startup()
         // timestamp offset should be in clock cycles for DRAMPower
         timeStampOffset = divCeil(curTick(), tCK);
 
+        // with a bank refresh, the first banks are due after tREFIsb
+        Tick ref_interval = refreshMode == Enums::all_bank ? tREFI : tREFIsb;
+
         for (auto r : ranks) {
-            r->startup(curTick() + tREFI - tRP);
+            r->startup(curTick() + ref_interval - tRP);
         }
     }
 }
 
+bool
+DRAMInterface::isRowOpen(Addr addr) const
+{
+    uint8_t rank;
+    uint8_t bank;
+    uint64_t row;
+    decodeAddr(addr, rank, bank, row);
+
+    return ranks[rank]->banks[bank].openRow == row;
+}
+
 bool
 DRAMInterface::isBusy()
 {
@@ -1036,6 +1248,21 @@ DRAMInterface::suspend()
 pair<vector<uint32_t>, bool>
 DRAMInterface::minBankPrep(const MemPacketQueue& queue,
                       Tick min_col_at) const
+{
+    // determine if we have queued transactions targetting the
+    // bank in question
+    vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
+    for (const auto& p : queue) {
+        if (p->isDram() && ranks[p->rank]->inRefIdleState())
+            got_waiting[p->bankId] = true;
+    }
+
+    return minBankPrep(got_waiting, min_col_at);
+}
+
+pair<vector<uint32_t>, bool>
+DRAMInterface::minBankPrep(const vector<bool>& got_waiting,
+                           Tick min_col_at) const
 {
     Tick min_act_at = MaxTick;
     vector<uint32_t> bank_mask(ranksPerChannel, 0);
@@ -1051,14 +1278,6 @@ DRAMInterface::minBankPrep(const MemPacketQueue& queue,
     // delay on the data bus
     bool hidden_bank_prep = false;
 
-    // determine if we have queued transactions targetting the
-    // bank in question
-    vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if (p->isDram() && ranks[p->rank]->inRefIdleState())
-            got_waiting[p->bankId] = true;
-    }
-
     // Find command with optimal bank timing
     // Will prioritize commands that can issue seamlessly.
     for (int i = 0; i < ranksPerChannel; i++) {
@@ -1128,7 +1347,8 @@ DRAMInterface::Rank::Rank(const DRAMInterfaceParams* _p,
                          int _rank, DRAMInterface& _dram)
     : EventManager(&_dram), dram(_dram),
       pwrStateTrans(PWR_IDLE), pwrStatePostRefresh(PWR_IDLE),
-      pwrStateTick(0), refreshDueAt(0), pwrState(PWR_IDLE),
+      pwrStateTick(0), refreshDueAt(0),
+      nextRefreshBank(0), pwrState(PWR_IDLE),
       refreshState(REF_IDLE), inLowPowerState(false), rank(_rank),
       readEntries(0), writeEntries(0), outstandingEvents(0),
       wakeUpAllowedAt(0), power(_p, false), banks(_p->banks_per_rank),
@@ -1137,6 +1357,7 @@ DRAMInterface::Rank::Rank(const DRAMInterfaceParams* _p,
       activateEvent([this]{ processActivateEvent(); }, name()),
       prechargeEvent([this]{ processPrechargeEvent(); }, name()),
       refreshEvent([this]{ processRefreshEvent(); }, name()),
+      bankRefreshEvent([this]{ processBankRefreshEvent(); }, name()),
       powerEvent([this]{ processPowerEvent(); }, name()),
       wakeUpEvent([this]{ processWakeUpEvent(); }, name()),
       stats(_dram, *this)
@@ -1171,13 +1392,21 @@ DRAMInterface::Rank::startup(Tick ref_tick)
 
     // kick off the refresh, and give ourselves enough time to
     // precharge
-    schedule(refreshEvent, ref_tick);
+    if (dram.refreshMode == Enums::all_bank) {
+        schedule(refreshEvent, ref_tick);
+    } else {
+        schedule(bankRefreshEvent, ref_tick);
+    }
 }
 
 void
 DRAMInterface::Rank::suspend()
 {
-    deschedule(refreshEvent);
+    if (dram.refreshMode == Enums::all_bank) {
+        deschedule(refreshEvent);
+    } else {
+        deschedule(bankRefreshEvent);
+    }
 
     // Update the stats
     updatePowerStats();
@@ -1498,6 +1727,64 @@ DRAMInterface::Rank::processRefreshEvent()
     }
 }
 
+void
+DRAMInterface::Rank::processBankRefreshEvent()
+{
+    // the banks to refresh, either the same bank of every bank group,
+    // or a single bank
+    std::vector<Bank*> ref_banks;
+    uint32_t ref_groups;
+    if (dram.refreshMode == Enums::same_bank) {
+        for (auto &b : banks) {
+            if (b.bank / dram.bankGroupsPerRank == nextRefreshBank) {
+                ref_banks.push_back(&b);
+            }
+        }
+        ref_groups = dram.banksPerRank / dram.bankGroupsPerRank;
+    } else {
+        ref_banks.push_back(&banks[nextRefreshBank]);
+        ref_groups = dram.banksPerRank;
+    }
+
+    // precharge the banks that are open, respecting the accesses
+    // already issued to them, and refresh once all of them are closed
+    Tick ref_at = curTick();
+    for (auto b : ref_banks) {
+        if (b->openRow != Bank::NO_ROW) {
+            dram.prechargeBank(*this, *b, std::max(b->preAllowedAt,
+                                                   curTick()));
+        }
+        ref_at = std::max(ref_at, b->actAllowedAt);
+    }
+
+    // the other banks of the rank are not affected, and keep serving
+    // accesses during the refresh
+    Tick ref_done_at = ref_at + dram.tRFCsb;
+
+    for (auto b : ref_banks) {
+        b->actAllowedAt = ref_done_at;
+
+        cmdList.push_back(Command(MemCommand::REFB, b->bank, ref_at));
+
+        DPRINTF(DRAMPower, "%llu,REFB,%d,%d\n", divCeil(ref_at, dram.tCK) -
+                dram.timeStampOffset, b->bank, rank);
+    }
+
+    dram.stats.bankRefreshes++;
+
+    DPRINTF(DRAM, "Refreshing bank %d of rank %d at %llu\n",
+            nextRefreshBank, rank, ref_at);
+
+    // update the power stats once all the banks have been refreshed,
+    // as with an all bank refresh
+    nextRefreshBank = (nextRefreshBank + 1) % ref_groups;
+    if (nextRefreshBank == 0) {
+        updatePowerStats();
+    }
+
+    schedule(bankRefreshEvent, curTick() + dram.tREFIsb);
+}
+
 void
 DRAMInterface::Rank::schedulePowerEvent(PowerState pwr_state, Tick tick)
 {
@@ -1875,10 +2162,15 @@ DRAMInterface::DRAMStats::DRAMStats(DRAMInterface &_dram)
     ADD_STAT(writeRowHits, "Number of row buffer hits during writes"),
     ADD_STAT(readRowHitRate, "Row buffer hit rate for reads"),
     ADD_STAT(writeRowHitRate, "Row buffer hit rate for writes"),
+    ADD_STAT(bankConflicts, "Number of row misses that closed another row "
+             "of their bank"),
 
     ADD_STAT(bytesPerActivate, "Bytes accessed per row activation"),
     ADD_STAT(bytesRead, "Total number of bytes read from DRAM"),
     ADD_STAT(bytesWritten, "Total number of bytes written to DRAM"),
+    ADD_STAT(bankRefreshes, "Number of same bank or per bank refreshes"),
+    ADD_STAT(rmwWrites, "Number of partial writes turned into "
+             "read-modify-writes by the on-die ECC"),
     ADD_STAT(avgRdBW, "Average DRAM read bandwidth in MiBytes/s"),
     ADD_STAT(avgWrBW, "Average DRAM write bandwidth in MiBytes/s"),
     ADD_STAT(peakBW, "Theoretical peak bandwidth in MiByte/s"),
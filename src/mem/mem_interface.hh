@@ -55,6 +55,7 @@
 #include "base/statistics.hh"
 #include "enums/AddrMap.hh"
 #include "enums/PageManage.hh"
+#include "enums/RefreshMode.hh"
 #include "mem/abstract_mem.hh"
 #include "mem/drampower.hh"
 #include "mem/mem_ctrl.hh"
@@ -121,6 +122,15 @@ class MemInterface : public AbstractMemory
      */
     Enums::AddrMap addrMapping;
 
+    /**
+     * Programmable part of the address mapping: the source bit of each
+     * bit of the address, and the masks of the address bits hashed
+     * into each bank and rank bit.
+     */
+    const std::vector<unsigned> addrPermutation;
+    const std::vector<Addr> bankXorMasks;
+    const std::vector<Addr> rankXorMasks;
+
     /**
      * General device and channel characteristics
      * The rowsPerBank is determined based on the capacity, number of
@@ -190,7 +200,15 @@ class MemInterface : public AbstractMemory
      * @param addr The intput address which should be in the addrRange
      * @return An address in the continues range [0, max)
      */
-    Addr getCtrlAddr(Addr addr) { return range.getOffset(addr); }
+    Addr getCtrlAddr(Addr addr) const { return range.getOffset(addr); }
+
+    /**
+     * Apply the bit permutation of the address mapping, if any.
+     *
+     * @param addr An address in the dense range of the controller
+     * @return The address with its bits permuted
+     */
+    Addr permuteAddr(Addr addr) const;
 
     /**
      * Setup the rank based on packet received
@@ -232,6 +250,11 @@ class MemInterface : public AbstractMemory
      */
     uint32_t bytesPerBurst() const { return burstSize; }
 
+    /**
+     * @return number of banks in the channel, across all ranks
+     */
+    uint32_t numBanks() const { return ranksPerChannel * banksPerRank; }
+
     /*
      * @return time to offset next command
      */
@@ -279,6 +302,18 @@ class MemInterface : public AbstractMemory
     MemPacket* decodePacket(const PacketPtr pkt, Addr pkt_addr,
                            unsigned int size, bool is_read, bool is_dram);
 
+    /**
+     * Map an address onto its rank, bank and row, as the address
+     * decoder does for the packets.
+     *
+     * @param pkt_addr The address
+     * @param rank Set to the rank of the address
+     * @param bank Set to the bank of the address within its rank
+     * @param row Set to the row of the address within its bank
+     */
+    void decodeAddr(Addr pkt_addr, uint8_t &rank, uint8_t &bank,
+                    uint64_t &row) const;
+
     /**
      *  Add rank to rank delay to bus timing to all banks in all ranks
      *  when access to an alternate interface is issued
@@ -492,6 +527,13 @@ class DRAMInterface : public MemInterface
          */
         Tick refreshDueAt;
 
+        /**
+         * With same bank refresh, the index of the bank to refresh next
+         * in every bank group, and with per bank refresh, the bank
+         * itself.
+         */
+        uint32_t nextRefreshBank;
+
         /**
          * Function to update Power Stats
          */
@@ -691,6 +733,13 @@ class DRAMInterface : public MemInterface
         void processRefreshEvent();
         EventFunctionWrapper refreshEvent;
 
+        /**
+         * Refresh the next banks of a same bank or per bank refresh,
+         * leaving the other banks of the rank free to serve accesses.
+         */
+        void processBankRefreshEvent();
+        EventFunctionWrapper bankRefreshEvent;
+
         void processPowerEvent();
         EventFunctionWrapper powerEvent;
 
@@ -735,6 +784,15 @@ class DRAMInterface : public MemInterface
     const Tick tRTP;
     const Tick tRFC;
     const Tick tREFI;
+    const Tick tRFCsb;
+    const Tick tCCD_L_WR_RMW;
+
+    /** Refresh command, and interval between two bank refreshes. */
+    Enums::RefreshMode refreshMode;
+    Tick tREFIsb;
+
+    /** Partial writes are read-modify-writes of the on-die ECC. */
+    const bool onDieECC;
     const Tick tRRD;
     const Tick tRRD_L;
     const Tick tPPD;
@@ -831,11 +889,18 @@ class DRAMInterface : public MemInterface
         Stats::Scalar writeRowHits;
         Stats::Formula readRowHitRate;
         Stats::Formula writeRowHitRate;
+        // Row misses that had to close another row of their bank
+        Stats::Scalar bankConflicts;
         Stats::Histogram bytesPerActivate;
         // Number of bytes transferred to/from DRAM
         Stats::Scalar bytesRead;
         Stats::Scalar bytesWritten;
 
+        // Same bank or per bank refreshes, and writes turned into
+        // read-modify-writes by the on-die ECC
+        Stats::Scalar bankRefreshes;
+        Stats::Scalar rmwWrites;
+
         // Average bandwidth
         Stats::Formula avgRdBW;
         Stats::Formula avgWrBW;
@@ -872,6 +937,19 @@ class DRAMInterface : public MemInterface
     std::pair<std::vector<uint32_t>, bool>
     minBankPrep(const MemPacketQueue& queue, Tick min_col_at) const;
 
+    /**
+     * Find which are the earliest banks ready to issue an activate,
+     * given which banks have requests waiting.
+     *
+     * @param got_waiting Per bank, whether requests are waiting
+     * @param min_col_at time of seamless burst command
+     * @return One-hot encoded mask of bank indices
+     * @return boolean indicating burst can issue seamlessly, with no gaps
+     */
+    std::pair<std::vector<uint32_t>, bool>
+    minBankPrep(const std::vector<bool>& got_waiting,
+                Tick min_col_at) const;
+
     /*
      * @return time to send a burst of data without gaps
      */
@@ -942,6 +1020,22 @@ class DRAMInterface : public MemInterface
     std::pair<MemPacketQueue::iterator, Tick>
     chooseNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const override;
 
+    /**
+     * For FR-FCFS policy, find first DRAM command that can issue,
+     * using an index of the queue rather than looking at every queued
+     * packet. The packet selected is the same as the one selected by
+     * looking at the whole queue.
+     *
+     * @param queue Queued requests to consider
+     * @param index Index of the DRAM packets in the queue
+     * @param min_col_at Minimum tick for 'seamless' issue
+     * @return an iterator to the selected packet, else queue.end()
+     * @return the tick when the packet selected will issue
+     */
+    std::pair<MemPacketQueue::iterator, Tick>
+    chooseNextFRFCFS(MemPacketQueue& queue, const MemPacketIndex& index,
+                     Tick min_col_at) const;
+
     /**
      * Actually do the burst - figure out the latency it
      * will take to service the req based on bank state, channel state etc
@@ -983,6 +1077,15 @@ class DRAMInterface : public MemInterface
      */
     bool isBusy();
 
+    /**
+     * Check whether the row of an address is open in its bank, so that
+     * an access to it would be a row hit
+     *
+     * @param addr The address, which must be in the range of the DRAM
+     * @return true if the row is open
+     */
+    bool isRowOpen(Addr addr) const;
+
     /**
      *  Add rank to rank delay to bus timing to all DRAM banks in alli ranks
      *  when access to an alternate interface is issued
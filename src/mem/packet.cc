@@ -244,6 +244,52 @@ MemCmd::commandInfo[] =
     {SET1(IsResponse), Cmp, "Cmp"}
 };
 
+namespace
+{
+
+SlabPool packetPool("packet", sizeof(Packet));
+
+// most payloads are either a few bytes or a cache line, larger ones
+// come from the heap
+SlabPool dataPools[] = {
+    { "packet_data_16", 16 },
+    { "packet_data_64", 64 },
+    { "packet_data_256", 256 },
+};
+
+} // anonymous namespace
+
+#if USE_POOL_ALLOC
+void *
+Packet::operator new(size_t size)
+{
+    if (size == sizeof(Packet))
+        return packetPool.allocate();
+    return ::operator new(size);
+}
+
+void
+Packet::operator delete(void *p, size_t size)
+{
+    if (size == sizeof(Packet))
+        packetPool.release(p);
+    else
+        ::operator delete(p);
+}
+#endif
+
+SlabPool *
+Packet::dataPoolFor(unsigned size)
+{
+#if USE_POOL_ALLOC
+    for (auto &pool : dataPools) {
+        if (size <= pool.size())
+            return &pool;
+    }
+#endif
+    return nullptr;
+}
+
 AddrRange
 Packet::getAddrRange() const
 {
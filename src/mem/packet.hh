@@ -47,6 +47,7 @@
 #ifndef __MEM_PACKET_HH__
 #define __MEM_PACKET_HH__
 
+#include <algorithm>
 #include <bitset>
 #include <cassert>
 #include <list>
@@ -57,7 +58,9 @@
 #include "base/flags.hh"
 #include "base/logging.hh"
 #include "base/printable.hh"
+#include "base/slab_pool.hh"
 #include "base/types.hh"
+#include "config/use_pool_alloc.hh"
 #include "mem/htm.hh"
 #include "mem/request.hh"
 #include "sim/core.hh"
@@ -355,6 +358,17 @@ class Packet : public Printable
     */
     PacketDataPtr data;
 
+    /// The pool the dynamic data was allocated from, if any
+    SlabPool *dataPool = nullptr;
+
+    /**
+     * Get the pool to allocate the data of a packet from.
+     *
+     * @param size size of the data in bytes
+     * @return the pool, or nullptr if the data should come from the heap
+     */
+    static SlabPool *dataPoolFor(unsigned size);
+
     /// The address of the request.  This address could be virtual or
     /// physical, depending on the system configuration.
     Addr addr;
@@ -365,6 +379,12 @@ class Packet : public Printable
     /// The size of the request or transfer.
     unsigned size;
 
+    /**
+     * The size of the data when it is transferred compressed over the
+     * memory fabric, or 0 when it is transferred uncompressed.
+     */
+    unsigned compressedSize;
+
     /**
      * Track the bytes found that satisfy a functional read.
      */
@@ -417,6 +437,13 @@ class Packet : public Printable
      */
     uint32_t payloadDelay;
 
+    /**
+     * The delay to decompress the data of a packet that is transferred
+     * compressed. It is set by the component that compressed the data,
+     * and paid by the one that consumes it.
+     */
+    uint32_t decompressionDelay;
+
     /**
      * A virtual base opaque structure used to hold state associated
      * with the packet (e.g., an MSHR), specific to a SimObject that
@@ -552,6 +579,58 @@ class Packet : public Printable
         return t;
     }
 
+    /** Maximum number of crossbars on the route of a packet */
+    static const int maxRouteDepth = 8;
+
+  private:
+
+    /**
+     * The CPU-side ports the packet arrived on at the crossbars that
+     * route its response using the route stack. Every such crossbar
+     * pushes its port when forwarding the request and pops it when
+     * forwarding the response, which avoids a lookup in a routing
+     * table at every hop.
+     */
+    PortID route[maxRouteDepth];
+    uint8_t routeDepth;
+
+  public:
+
+    /**
+     * Remember the port to send the response of this packet to.
+     *
+     * @param port_id Port the request was received on
+     */
+    void
+    pushRoute(PortID port_id)
+    {
+        panic_if(routeDepth == maxRouteDepth, "Route of %s exceeds %d "
+                 "crossbars\n", print(), maxRouteDepth);
+        route[routeDepth++] = port_id;
+    }
+
+    /**
+     * Get the port to send the response to, without removing it as
+     * the response may still be refused.
+     */
+    PortID
+    routeTop() const
+    {
+        assert(routeDepth > 0);
+        return route[routeDepth - 1];
+    }
+
+    /** Remove the top of the route stack. */
+    void
+    popRoute()
+    {
+        assert(routeDepth > 0);
+        --routeDepth;
+    }
+
+    /** Number of ports on the route stack. */
+    int routeSize() const { return routeDepth; }
+
     /// Return the string name of the cmd field (for debugging and
     /// tracing).
     const std::string &cmdString() const { return cmd.toString(); }
@@ -769,6 +848,35 @@ class Packet : public Printable
 
     unsigned getSize() const  { assert(flags.isSet(VALID_SIZE)); return size; }
 
+    /**
+     * Get the size of the compressed data of the packet.
+     *
+     * @return The compressed size, or 0 if the data is not compressed.
+     */
+    unsigned getCompressedSize() const { return compressedSize; }
+
+    /**
+     * Record that the data of the packet is transferred compressed.
+     *
+     * @param compressed_size The compressed size, 0 if uncompressed.
+     */
+    void
+    setCompressedSize(unsigned compressed_size)
+    {
+        assert(compressed_size <= getSize());
+        compressedSize = compressed_size;
+    }
+
+    /**
+     * Get the number of bytes to serialize when the packet crosses a
+     * link, which are fewer than its size if its data is compressed.
+     */
+    unsigned
+    getLinkSize() const
+    {
+        return compressedSize ? compressedSize : getSize();
+    }
+
     /**
      * Get address range to which this packet belongs.
      *
@@ -830,11 +938,12 @@ class Packet : public Printable
     Packet(const RequestPtr &_req, MemCmd _cmd)
         :  cmd(_cmd), id((PacketId)_req.get()), req(_req),
            data(nullptr), addr(0), _isSecure(false), size(0),
-           _qosValue(0),
+           compressedSize(0), _qosValue(0),
            htmReturnReason(HtmCacheFailure::NO_FAIL),
            htmTransactionUid(0),
            headerDelay(0), snoopDelay(0),
-           payloadDelay(0), senderState(NULL)
+           payloadDelay(0), decompressionDelay(0), senderState(NULL),
+           routeDepth(0)
     {
         flags.clear();
         if (req->hasPaddr()) {
@@ -870,12 +979,13 @@ class Packet : public Printable
      */
     Packet(const RequestPtr &_req, MemCmd _cmd, int _blkSize, PacketId _id = 0)
         :  cmd(_cmd), id(_id ? _id : (PacketId)_req.get()), req(_req),
-           data(nullptr), addr(0), _isSecure(false),
+           data(nullptr), addr(0), _isSecure(false), compressedSize(0),
            _qosValue(0),
            htmReturnReason(HtmCacheFailure::NO_FAIL),
            htmTransactionUid(0),
            headerDelay(0),
-           snoopDelay(0), payloadDelay(0), senderState(NULL)
+           snoopDelay(0), payloadDelay(0), decompressionDelay(0),
+           senderState(NULL), routeDepth(0)
     {
         flags.clear();
         if (req->hasPaddr()) {
@@ -898,6 +1008,7 @@ class Packet : public Printable
         :  cmd(pkt->cmd), id(pkt->id), req(pkt->req),
            data(nullptr),
            addr(pkt->addr), _isSecure(pkt->_isSecure), size(pkt->size),
+           compressedSize(pkt->compressedSize),
            bytesValid(pkt->bytesValid),
            _qosValue(pkt->qosValue()),
            htmReturnReason(HtmCacheFailure::NO_FAIL),
@@ -905,8 +1016,14 @@ class Packet : public Printable
            headerDelay(pkt->headerDelay),
            snoopDelay(0),
            payloadDelay(pkt->payloadDelay),
-           senderState(pkt->senderState)
+           decompressionDelay(pkt->decompressionDelay),
+           senderState(pkt->senderState),
+           routeDepth(pkt->routeDepth)
     {
+        // like the sender state, the route is kept so that a new
+        // packet can be used to respond
+        std::copy(pkt->route, pkt->route + routeDepth, route);
+
         if (!clear_flags)
             flags.set(pkt->flags & COPY_FLAGS);
 
@@ -994,6 +1111,15 @@ class Packet : public Printable
         return new Packet(req, makeWriteCmd(req));
     }
 
+#if USE_POOL_ALLOC
+    /**
+     * Packets are allocated from a per-thread pool as they are created
+     * and destroyed for every access.
+     */
+    static void *operator new(size_t size);
+    static void operator delete(void *p, size_t size);
+#endif
+
     /**
      * clean up packet variables
      */
@@ -1016,6 +1142,11 @@ class Packet : public Printable
         // responses are never express, even if the snoop that
         // triggered them was
         flags.clear(EXPRESS_SNOOP);
+
+        // the data of the response is compressed by its responder, if
+        // at all
+        compressedSize = 0;
+        decompressionDelay = 0;
     }
 
     void
@@ -1293,11 +1424,16 @@ class Packet : public Printable
     void
     deleteData()
     {
-        if (flags.isSet(DYNAMIC_DATA))
-            delete [] data;
+        if (flags.isSet(DYNAMIC_DATA)) {
+            if (dataPool)
+                dataPool->release(data);
+            else
+                delete [] data;
+        }
 
         flags.clear(STATIC_DATA|DYNAMIC_DATA);
         data = NULL;
+        dataPool = nullptr;
     }
 
     /** Allocate memory for the packet. */
@@ -1309,7 +1445,11 @@ class Packet : public Printable
         if (hasData() || hasRespData()) {
             assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
             flags.set(DYNAMIC_DATA);
-            data = new uint8_t[getSize()];
+            dataPool = dataPoolFor(getSize());
+            if (dataPool)
+                data = static_cast<PacketDataPtr>(dataPool->allocate());
+            else
+                data = new uint8_t[getSize()];
         }
     }
 
@@ -1483,6 +1623,9 @@ class Packet : public Printable
     unsigned DataCrd;
     unsigned rollover;
     bool is_combined;
+    //the flits account for the compression of the data, so the
+    //compressed size is kept aside while the packet is packed
+    unsigned cxl_compressed_size = 0;
 
     unsigned reserved_for_more_NDR;
     unsigned reserved_for_more_DRS;
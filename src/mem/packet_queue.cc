@@ -50,7 +50,7 @@ PacketQueue::PacketQueue(EventManager& _em, const std::string& _label,
                          bool disable_sanity_check)
     : em(_em), sendEvent([this]{ processSendEvent(); }, _sendEventName),
       _disableSanityCheck(disable_sanity_check),
-      forceOrder(force_order),
+      forceOrder(force_order), limit(0), spaceRequested(false),
       label(_label), waitingOnRetry(false)
 {
 }
@@ -59,6 +59,89 @@ PacketQueue::~PacketQueue()
 {
 }
 
+void
+PacketQueue::DeferredPacketList::grow()
+{
+    std::vector<DeferredPacket> new_ring(ring.size() * 2);
+    for (size_t i = 0; i < count; ++i)
+        new_ring[i] = at(i);
+    ring.swap(new_ring);
+    head = 0;
+}
+
+void
+PacketQueue::DeferredPacketList::push_front(const DeferredPacket &dp)
+{
+    if (count == ring.size())
+        grow();
+
+    head = (head + ring.size() - 1) & (ring.size() - 1);
+    ++count;
+    at(0) = dp;
+}
+
+bool
+PacketQueue::DeferredPacketList::insert(Tick when, PacketPtr pkt,
+                                        bool force_order)
+{
+    if (count == ring.size())
+        grow();
+
+    // this belongs in the middle somewhere, so search from the end to
+    // order by tick; however, if force_order is set, also make sure
+    // not to re-order in front of some existing packet with the same
+    // address
+    size_t pos = count;
+    while (pos > 0) {
+        const DeferredPacket &prev = at(pos - 1);
+        if ((force_order && prev.pkt->matchAddr(pkt)) || prev.tick <= when)
+            break;
+        --pos;
+    }
+
+    // make room by moving the younger packets up by one
+    for (size_t i = count; i > pos; --i)
+        at(i) = at(i - 1);
+
+    at(pos) = DeferredPacket(when, pkt);
+    ++count;
+
+    return pos == 0;
+}
+
+void
+PacketQueue::setLimit(size_t _limit,
+                      const std::function<void()> &space_callback)
+{
+    limit = _limit;
+    spaceCallback = space_callback;
+}
+
+bool
+PacketQueue::hasSpace()
+{
+    if (limit == 0 || transmitList.size() < limit)
+        return true;
+
+    DPRINTF(PacketQueue, "Queue %s full (%d packets)\n", name(),
+            transmitList.size());
+    spaceRequested = true;
+    return false;
+}
+
+void
+PacketQueue::removeLast()
+{
+    assert(!transmitList.empty());
+    transmitList.pop_back();
+
+    // if this was the only packet, there is nothing left to send
+    if (transmitList.empty() && sendEvent.scheduled()) {
+        em.deschedule(sendEvent);
+        schedSendEvent(MaxTick);
+    }
+}
+
 void
 PacketQueue::retry()
 {
@@ -114,8 +197,9 @@ PacketQueue::schedSendTiming(PacketPtr pkt, Tick when)
     assert(!pkt->isExpressSnoop());
 
     // add a very basic sanity check on the port to ensure the
-    // invisible buffer is not growing beyond reasonable limits
-    if (!_disableSanityCheck && transmitList.size() > 128) {
+    // invisible buffer is not growing beyond reasonable limits, a
+    // bounded queue relies on its owner pushing back instead
+    if (!_disableSanityCheck && limit == 0 && transmitList.size() > 128) {
         panic("Packet queue %s has grown beyond 128 packets\n",
               name());
     }
@@ -128,24 +212,10 @@ PacketQueue::schedSendTiming(PacketPtr pkt, Tick when)
     // ourselves again before we had a chance to update waitingOnRetry
     // assert(waitingOnRetry || sendEvent.scheduled());
 
-    // this belongs in the middle somewhere, so search from the end to
-    // order by tick; however, if forceOrder is set, also make sure
-    // not to re-order in front of some existing packet with the same
-    // address
-    auto it = transmitList.end();
-    while (it != transmitList.begin()) {
-        --it;
-        if ((forceOrder && it->pkt->matchAddr(pkt)) || it->tick <= when) {
-            // emplace inserts the element before the position pointed to by
-            // the iterator, so advance it one step
-            transmitList.emplace(++it, when, pkt);
-            return;
-        }
-    }
-    // either the packet list is empty or this has to be inserted
-    // before every other packet
-    transmitList.emplace_front(when, pkt);
-    schedSendEvent(when);
+    // if the packet ends up at the head, either the list was empty or
+    // this has to be sent before every other packet
+    if (transmitList.insert(when, pkt, forceOrder))
+        schedSendEvent(when);
 }
 
 void
@@ -208,9 +278,20 @@ PacketQueue::sendDeferredPacket()
     // next send
     if (!waitingOnRetry) {
         schedSendEvent(deferredPacketReadyTime());
+        notifySpace();
     } else {
         // put the packet back at the front of the list
-        transmitList.emplace_front(dp);
+        transmitList.push_front(dp);
+    }
+}
+
+void
+PacketQueue::notifySpace()
+{
+    if (spaceRequested && transmitList.size() < limit) {
+        DPRINTF(PacketQueue, "Queue %s has space again\n", name());
+        spaceRequested = false;
+        spaceCallback();
     }
 }
 
@@ -49,7 +49,9 @@
  * for the flow control of the port.
  */
 
-#include <list>
+#include <cassert>
+#include <functional>
+#include <vector>
 
 #include "mem/port.hh"
 #include "sim/drain.hh"
@@ -70,9 +72,125 @@ class PacketQueue : public Drainable
         DeferredPacket(Tick t, PacketPtr p)
             : tick(t), pkt(p)
         {}
+        DeferredPacket() : tick(0), pkt(nullptr) {}
     };
 
-    typedef std::list<DeferredPacket> DeferredPacketList;
+  public:
+
+    /**
+     * The deferred packets of a queue in tick order, kept in a ring
+     * buffer. A queue mostly adds the same latency to all its packets,
+     * so packets nearly always arrive in tick order and are appended
+     * at the tail in constant time. Otherwise the insertion point is
+     * searched from the tail and the younger packets are moved up by
+     * one entry, which touches a few contiguous cache lines rather
+     * than a chain of list nodes. The ring doubles in size when full.
+     */
+    class DeferredPacketList
+    {
+      public:
+
+        template <typename List, typename Value>
+        class Iterator
+        {
+          public:
+            Iterator(List *_list, size_t _idx) : list(_list), idx(_idx) {}
+
+            Value &operator*() const { return list->at(idx); }
+            Value *operator->() const { return &list->at(idx); }
+
+            Iterator &operator++() { ++idx; return *this; }
+            Iterator operator++(int) { return Iterator(list, idx++); }
+
+            bool operator==(const Iterator &other) const
+            { return idx == other.idx; }
+            bool operator!=(const Iterator &other) const
+            { return idx != other.idx; }
+
+          private:
+            List *list;
+            size_t idx;
+        };
+
+        typedef Iterator<DeferredPacketList, DeferredPacket> iterator;
+        typedef Iterator<const DeferredPacketList,
+                         const DeferredPacket> const_iterator;
+
+        DeferredPacketList() : ring(initialSize), head(0), count(0) {}
+
+        bool empty() const { return count == 0; }
+        size_t size() const { return count; }
+
+        DeferredPacket &front() { assert(count); return at(0); }
+        const DeferredPacket &front() const { assert(count); return at(0); }
+        DeferredPacket &back() { assert(count); return at(count - 1); }
+        const DeferredPacket &
+        back() const
+        {
+            assert(count);
+            return at(count - 1);
+        }
+
+        void
+        pop_front()
+        {
+            assert(count);
+            head = (head + 1) & (ring.size() - 1);
+            --count;
+        }
+
+        void pop_back() { assert(count); --count; }
+
+        /** Put a packet back at the head, e.g. after a failed send */
+        void push_front(const DeferredPacket &dp);
+
+        /**
+         * Insert a packet behind all packets with the same or an
+         * earlier tick.
+         *
+         * @param when tick when the packet is ready to transmit
+         * @param pkt packet to insert
+         * @param force_order also keep the packet behind all packets
+         *        to the same address
+         * @return true if the packet was put at the head
+         */
+        bool insert(Tick when, PacketPtr pkt, bool force_order);
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, count); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, count); }
+
+      private:
+
+        /** Initial number of entries, has to be a power of two */
+        static const size_t initialSize = 16;
+
+        DeferredPacket &
+        at(size_t idx)
+        {
+            return ring[(head + idx) & (ring.size() - 1)];
+        }
+
+        const DeferredPacket &
+        at(size_t idx) const
+        {
+            return ring[(head + idx) & (ring.size() - 1)];
+        }
+
+        /** Double the size of the ring, moving the head to entry 0 */
+        void grow();
+
+        std::vector<DeferredPacket> ring;
+
+        /** Index of the oldest packet in the ring */
+        size_t head;
+
+        /** Number of packets in the ring */
+        size_t count;
+    };
+
+  protected:
 
     /** A list of outgoing packets. */
     DeferredPacketList transmitList;
@@ -100,6 +218,18 @@ class PacketQueue : public Drainable
      */
     bool forceOrder;
 
+    /**
+     * Number of packets the owner of the queue admits before pushing
+     * back, 0 if the queue is unbounded.
+     */
+    size_t limit;
+
+    /** Whether the owner was told that the queue is full */
+    bool spaceRequested;
+
+    /** Called when a full queue has space again */
+    std::function<void()> spaceCallback;
+
   protected:
 
     /** Label to use for print request packets label stack. */
@@ -122,6 +252,12 @@ class PacketQueue : public Drainable
      */
     virtual void sendDeferredPacket();
 
+    /**
+     * Let the owner of a bounded queue know if a packet it was refused
+     * for now fits. To be called whenever a packet left the queue.
+     */
+    void notifySpace();
+
     /**
      * Send a packet using the appropriate method for the specific
      * subclass (request, response or snoop response).
@@ -216,29 +352,36 @@ class PacketQueue : public Drainable
       */
     void disableSanityCheck() { _disableSanityCheck = true; }
 
-    DrainState drain() override;
-
-    PacketQueue::DeferredPacketList::iterator queue_ptr;
+    /**
+     * Bound the queue. Rather than panicking when the queue grows
+     * large, the owner of a bounded queue checks hasSpace() before
+     * accepting anything that ends up in the queue and refuses it
+     * otherwise. Once a packet has left a queue that was found full,
+     * the callback is called so that the owner can send a retry.
+     *
+     * @param _limit number of packets before the queue is full
+     * @param space_callback called when there is space again
+     */
+    void setLimit(size_t _limit, const std::function<void()> &space_callback);
 
-    void resetQueuePtr(){
-      queue_ptr = transmitList.begin();
-    }
+    /**
+     * Check whether a bounded queue can take another packet. If it
+     * cannot, the space callback is called as soon as it can.
+     *
+     * @return true if the queue is unbounded or below its limit
+     */
+    bool hasSpace();
 
-    PacketPtr workAroundQueue(){
-      if (queue_ptr == transmitList.end())
-        return NULL;
-      PacketPtr tmp = queue_ptr->pkt;
-      queue_ptr++;
-      return tmp;
-    }
+    /** The packets in the queue, in the order they will be sent. */
+    const DeferredPacketList &deferredPackets() const { return transmitList; }
 
-    PacketPtr LastPkt(){
-      return transmitList.back().pkt;
-    }
+    /**
+     * Remove the packet that was queued to be sent last. The caller
+     * is responsible for the packet.
+     */
+    void removeLast();
 
-    void pop_back(){
-      transmitList.pop_back();
-    }
+    DrainState drain() override;
 };
 
 class ReqPacketQueue : public PacketQueue
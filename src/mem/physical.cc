@@ -39,17 +39,25 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/user.h>
 #include <unistd.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <thread>
 
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
 #include "debug/Checkpoint.hh"
@@ -67,14 +75,40 @@
 #endif
 #endif
 
+/**
+ * Huge pages from hugetlbfs, transparent huge pages and memory
+ * policies are specific to Linux. Elsewhere the backing store falls
+ * back to the base pages and the default policy.
+ */
+#if defined(__linux__) && defined(MAP_HUGETLB)
+#define HAVE_HUGETLB 1
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#endif
+
+#if defined(__linux__) && defined(SYS_mbind)
+#define HAVE_MBIND 1
+/** From linux/mempolicy.h, which is not always installed */
+#define MPOL_BIND 2
+#endif
+
 using namespace std;
 
 PhysicalMemory::PhysicalMemory(const string& _name,
                                const vector<AbstractMemory*>& _memories,
                                bool mmap_using_noreserve,
-                               const std::string& shared_backstore) :
+                               const std::string& shared_backstore,
+                               Enums::BackstorePages backstore_pages,
+                               int backstore_numa_node,
+                               bool chunked_cpt, unsigned cpt_threads,
+                               const std::string& cpt_parent) :
     _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve),
-    sharedBackstore(shared_backstore)
+    sharedBackstore(shared_backstore), backstorePages(backstore_pages),
+    backstoreNumaNode(backstore_numa_node), chunkedCpt(chunked_cpt),
+    cptThreads(cpt_threads ? cpt_threads :
+               std::max(1u, std::thread::hardware_concurrency())),
+    cptParent(cpt_parent)
 {
     if (mmap_using_noreserve)
         warn("Not reserving swap space. May cause SIGSEGV on actual usage\n");
@@ -218,9 +252,9 @@ PhysicalMemory::createBackingStore(AddrRange range,
         map_flags |= MAP_NORESERVE;
     }
 
-    uint8_t* pmem = (uint8_t*) mmap(NULL, range.size(),
-                                    PROT_READ | PROT_WRITE,
-                                    map_flags, shm_fd, 0);
+    uint64_t map_size;
+    uint8_t* pmem = mapBackingStore(range.size(), shm_fd, map_flags,
+                                    map_size);
 
     if (pmem == (uint8_t*) MAP_FAILED) {
         perror("mmap");
@@ -228,10 +262,30 @@ PhysicalMemory::createBackingStore(AddrRange range,
               range.to_string());
     }
 
+    // bind the memory before it is first touched, as that is when
+    // the pages get allocated
+    if (backstoreNumaNode >= 0) {
+#ifdef HAVE_MBIND
+        const unsigned long bits = 8 * sizeof(unsigned long);
+        std::vector<unsigned long> nodemask(backstoreNumaNode / bits + 1, 0);
+        nodemask[backstoreNumaNode / bits] = 1UL << (backstoreNumaNode % bits);
+        if (syscall(SYS_mbind, pmem, map_size, MPOL_BIND, nodemask.data(),
+                    nodemask.size() * bits + 1, 0) != 0) {
+            warn("Could not bind the backing store for range %s to host "
+                 "NUMA node %d: %s\n", range.to_string(), backstoreNumaNode,
+                 strerror(errno));
+        }
+#else
+        warn_once("Binding the backing store to a host NUMA node is not "
+                  "supported on this host\n");
+#endif
+    }
+
     // remember this backing store so we can checkpoint it and unmap
     // it appropriately
     backingStore.emplace_back(range, pmem,
                               conf_table_reported, in_addr_map, kvm_map);
+    backingStoreMapSize.push_back(map_size);
 
     // point the memories to their backing store
     for (const auto& m : _memories) {
@@ -244,8 +298,80 @@ PhysicalMemory::createBackingStore(AddrRange range,
 PhysicalMemory::~PhysicalMemory()
 {
     // unmap the backing store
-    for (auto& s : backingStore)
-        munmap((char*)s.pmem, s.range.size());
+    for (int i = 0; i < backingStore.size(); i++)
+        munmap((char*)backingStore[i].pmem, backingStoreMapSize[i]);
+}
+
+uint8_t*
+PhysicalMemory::mapBackingStore(uint64_t size, int shm_fd, int map_flags,
+                                uint64_t &map_size) const
+{
+    const int prot = PROT_READ | PROT_WRITE;
+    const bool hugetlb =
+        backstorePages == Enums::huge_pages_2MB ||
+        backstorePages == Enums::huge_pages_1GB;
+
+    if (hugetlb) {
+#ifdef HAVE_HUGETLB
+        const unsigned page_shift =
+            backstorePages == Enums::huge_pages_1GB ? 30 : 21;
+        if (shm_fd == -1) {
+            map_size = roundUp(size, 1ULL << page_shift);
+            void* p = mmap(NULL, map_size, prot, map_flags | MAP_HUGETLB |
+                           (page_shift << MAP_HUGE_SHIFT), -1, 0);
+            if (p != MAP_FAILED)
+                return (uint8_t*) p;
+
+            warn("Could not map %d bytes of %d MB huge pages (%s), using "
+                 "transparent huge pages instead. Are enough huge pages "
+                 "reserved?\n", map_size, (1 << page_shift) >> 20,
+                 strerror(errno));
+        } else {
+            warn_once("Shared backing stores cannot use hugetlbfs pages, "
+                      "using transparent huge pages instead\n");
+        }
+#else
+        warn_once("Huge pages are not supported on this host, using "
+                  "transparent huge pages instead\n");
+#endif
+    }
+
+    map_size = size;
+    if (backstorePages == Enums::base_pages)
+        return (uint8_t*) mmap(NULL, size, prot, map_flags, shm_fd, 0);
+
+    // transparent huge pages, also as the fall back for hugetlbfs
+#ifdef MADV_HUGEPAGE
+    const uint64_t huge_page = 1ULL << 21;
+    if (shm_fd == -1 && size >= huge_page) {
+        // align the mapping to a huge page, so that all of it can be
+        // backed by huge pages, and unmap what is left on either side
+        void* p = mmap(NULL, size + huge_page, prot, map_flags, -1, 0);
+        if (p == MAP_FAILED)
+            return (uint8_t*) p;
+
+        uint8_t* start = (uint8_t*) p;
+        uint8_t* aligned = (uint8_t*) roundUp((uintptr_t) start, huge_page);
+        if (aligned != start)
+            munmap(start, aligned - start);
+        munmap(aligned + size, start + huge_page - aligned);
+
+        if (madvise(aligned, size, MADV_HUGEPAGE) != 0) {
+            warn_once("Transparent huge pages are not available: %s\n",
+                      strerror(errno));
+        }
+        return aligned;
+    }
+
+    uint8_t* pmem = (uint8_t*) mmap(NULL, size, prot, map_flags, shm_fd, 0);
+    if (pmem != (uint8_t*) MAP_FAILED && madvise(pmem, size, MADV_HUGEPAGE))
+        warn_once("Transparent huge pages are not available: %s\n",
+                  strerror(errno));
+    return pmem;
+#else
+    warn_once("Transparent huge pages are not supported on this host\n");
+    return (uint8_t*) mmap(NULL, size, prot, map_flags, shm_fd, 0);
+#endif
 }
 
 bool
@@ -354,8 +480,16 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
 
+    string format = chunkedCpt ? "chunked" : "gzip";
+    SERIALIZE_SCALAR(format);
+
     // write memory file
     string filepath = CheckpointIn::dir() + "/" + filename.c_str();
+    if (chunkedCpt) {
+        serializeChunkedStore(filepath, range, pmem);
+        return;
+    }
+
     gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
     if (compressed_mem == NULL)
         fatal("Can't open physical memory checkpoint file '%s'\n",
@@ -412,8 +546,6 @@ PhysicalMemory::unserialize(CheckpointIn &cp)
 void
 PhysicalMemory::unserializeStore(CheckpointIn &cp)
 {
-    const uint32_t chunk_size = 16384;
-
     unsigned int store_id;
     UNSERIALIZE_SCALAR(store_id);
 
@@ -421,11 +553,6 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     string filepath = cp.getCptDir() + "/" + filename;
 
-    // mmap memoryfile
-    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
-
     // we've already got the actual backing store mapped
     uint8_t* pmem = backingStore[store_id].pmem;
     AddrRange range = backingStore[store_id].range;
@@ -433,13 +560,35 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     long range_size;
     UNSERIALIZE_SCALAR(range_size);
 
-    DPRINTF(Checkpoint, "Unserializing physical memory %s with size %d\n",
-            filename, range_size);
+    // checkpoints that predate the chunked format do not say
+    string format = "gzip";
+    UNSERIALIZE_OPT_SCALAR(format);
+
+    DPRINTF(Checkpoint, "Unserializing physical memory %s with size %d "
+            "(%s)\n", filename, range_size, format);
 
     if (range_size != range.size())
         fatal("Memory range size has changed! Saw %lld, expected %lld\n",
               range_size, range.size());
 
+    if (format == "chunked")
+        unserializeChunkedStore(filepath, range, pmem);
+    else if (format == "gzip")
+        unserializeGzipStore(filepath, range, pmem);
+    else
+        fatal("Unknown physical memory checkpoint format '%s'\n", format);
+}
+
+void
+PhysicalMemory::unserializeGzipStore(const string &filepath, AddrRange range,
+                                     uint8_t* pmem) const
+{
+    const uint32_t chunk_size = 16384;
+
+    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'", filepath);
+
     uint64_t curr_size = 0;
     long* temp_page = new long[chunk_size];
     long* pmem_current;
@@ -466,5 +615,475 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
 
     if (gzclose(compressed_mem))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
+              filepath);
+}
+
+namespace {
+
+/**
+ * The chunked checkpoint format starts with a header, followed by the
+ * path of the parent checkpoint file, if any, and a table with an
+ * entry per chunk of the store. The data of the chunks follows the
+ * table in an arbitrary order. All fields are in host byte order.
+ */
+const char chunkedMagic[8] = { 'g', 'e', 'm', '5', 'p', 'm', 'e', 'm' };
+const uint32_t chunkedVersion = 1;
+
+/** Uncompressed size of the chunks written by the simulator */
+const uint64_t chunkedChunkSize = 1 << 20;
+
+/** Chunks written per thread before the batch goes to the file */
+const unsigned chunkedBatch = 16;
+
+struct ChunkedHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t parentLen;
+    uint64_t chunkSize;
+    uint64_t numChunks;
+};
+
+enum ChunkType : uint32_t
+{
+    /** Only zeros, there is no data */
+    ZeroChunk,
+    /** Compressed with zlib */
+    DeflatedChunk,
+    /** Stored as is, as it does not compress */
+    RawChunk,
+    /** Identical to the same chunk of the parent checkpoint */
+    ParentChunk
+};
+
+struct ChunkEntry
+{
+    uint64_t offset;
+    uint32_t size;
+    uint32_t type;
+    /**
+     * Checksums of the uncompressed data, used to find the chunks that
+     * are unchanged with respect to the parent checkpoint
+     */
+    uint32_t crc;
+    uint32_t adler;
+};
+
+/** Offset of the chunk table, which is aligned for mapping the file */
+uint64_t
+chunkTableOffset(uint32_t parent_len)
+{
+    return roundUp(sizeof(ChunkedHeader) + parent_len, sizeof(uint64_t));
+}
+
+/** Check if a file starts with the header of a chunked checkpoint */
+bool
+isChunkedFile(const string &filepath)
+{
+    ChunkedHeader header;
+    FILE *f = fopen(filepath.c_str(), "rb");
+    if (f == NULL)
+        return false;
+    bool chunked = fread(&header, sizeof(header), 1, f) == 1 &&
+        memcmp(header.magic, chunkedMagic, sizeof(chunkedMagic)) == 0 &&
+        header.version == chunkedVersion;
+    fclose(f);
+    return chunked;
+}
+
+/**
+ * A chunked checkpoint file mapped in memory.
+ */
+class ChunkedFile
+{
+  public:
+    explicit ChunkedFile(const string &filepath)
+        : path(filepath), base(nullptr), length(0)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            fatal("Can't open physical memory checkpoint file '%s'\n",
+                  path);
+
+        length = lseek(fd, 0, SEEK_END);
+        if (length >= sizeof(ChunkedHeader)) {
+            void *p = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+            if (p != MAP_FAILED)
+                base = static_cast<const uint8_t *>(p);
+        }
+        close(fd);
+
+        fatal_if(!base, "Can't map physical memory checkpoint file '%s'\n",
+                 path);
+
+        header = reinterpret_cast<const ChunkedHeader *>(base);
+        fatal_if(memcmp(header->magic, chunkedMagic, sizeof(chunkedMagic)) ||
+                 header->version != chunkedVersion,
+                 "'%s' is not a chunked physical memory checkpoint\n", path);
+
+        const uint64_t table = chunkTableOffset(header->parentLen);
+        fatal_if(table + header->numChunks * sizeof(ChunkEntry) > length,
+                 "Physical memory checkpoint file '%s' is truncated\n",
+                 path);
+
+        parent.assign(reinterpret_cast<const char *>(base) +
+                      sizeof(ChunkedHeader), header->parentLen);
+        entries = reinterpret_cast<const ChunkEntry *>(base + table);
+
+        // the chunks are read once and in no particular order
+        madvise(const_cast<uint8_t *>(base), length, MADV_WILLNEED);
+    }
+
+    ~ChunkedFile()
+    {
+        munmap(const_cast<uint8_t *>(base), length);
+    }
+
+    ChunkedFile(const ChunkedFile &) = delete;
+    ChunkedFile &operator=(const ChunkedFile &) = delete;
+
+    const string path;
+    const uint8_t *base;
+    uint64_t length;
+    const ChunkedHeader *header;
+    const ChunkEntry *entries;
+    string parent;
+};
+
+/** Call f for every index below n from the given number of threads */
+template <typename F>
+void
+parallelFor(uint64_t n, unsigned threads, F f)
+{
+    std::atomic<uint64_t> next(0);
+    auto work = [&]() {
+        for (uint64_t i = next++; i < n; i = next++)
+            f(i);
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < std::min<uint64_t>(threads, n); t++)
+        workers.emplace_back(work);
+    work();
+    for (auto &w : workers)
+        w.join();
+}
+
+bool
+isZero(const uint8_t *p, uint64_t len)
+{
+    return p[0] == 0 && memcmp(p, p + 1, len - 1) == 0;
+}
+
+/**
+ * Check if a chunk of the parent checkpoints holds the given data, the
+ * checksums only telling the chunks that changed apart.
+ *
+ * @param parents The parent checkpoint and its own parents, in order.
+ * @param i Index of the chunk.
+ * @param data The data of the chunk.
+ * @param len Length of the chunk.
+ * @param buf Buffer to decompress the chunk of the parent into.
+ * @return Whether the chunk is unchanged.
+ */
+bool
+sameAsParent(const std::vector<std::unique_ptr<ChunkedFile>> &parents,
+             uint64_t i, const uint8_t *data, uint64_t len,
+             std::vector<uint8_t> &buf)
+{
+    for (const auto &file : parents) {
+        const ChunkEntry &p = file->entries[i];
+        if (p.type == ParentChunk)
+            continue;
+        if (p.offset + p.size > file->length)
+            return false;
+
+        switch (p.type) {
+          case DeflatedChunk: {
+            buf.resize(len);
+            uLongf dlen = len;
+            return uncompress(buf.data(), &dlen, file->base + p.offset,
+                              p.size) == Z_OK && dlen == len &&
+                memcmp(buf.data(), data, len) == 0;
+          }
+          case RawChunk:
+            return p.size == len &&
+                memcmp(file->base + p.offset, data, len) == 0;
+          default:
+            // the data is not zero
+            return false;
+        }
+    }
+
+    // the chain of parents is broken
+    return false;
+}
+
+} // anonymous namespace
+
+void
+PhysicalMemory::serializeChunkedStore(const string &filepath,
+                                      AddrRange range, uint8_t* pmem) const
+{
+    const uint64_t store_size = range.size();
+    const uint64_t num_chunks = divCeil(store_size, chunkedChunkSize);
+
+    // use the parent only if it is a chunked checkpoint with the same
+    // layout, a store that has been resized, or whose parent is in the
+    // gzip format, simply gets written in full
+    std::unique_ptr<ChunkedFile> parent;
+    string parent_path;
+    if (!cptParent.empty()) {
+        const string name = filepath.substr(filepath.rfind('/') + 1);
+        char *real = realpath((cptParent + "/" + name).c_str(), NULL);
+        if (real) {
+            parent_path = real;
+            free(real);
+        }
+
+        if (!parent_path.empty() && isChunkedFile(parent_path))
+            parent.reset(new ChunkedFile(parent_path));
+
+        if (!parent || parent->header->chunkSize != chunkedChunkSize ||
+            parent->header->numChunks != num_chunks) {
+            warn("Parent checkpoint '%s' does not match %s, writing a full "
+                 "checkpoint\n", cptParent, name);
+            parent.reset();
+            parent_path.clear();
+        }
+    }
+
+    // the chunks that the parent takes from its own parents are compared
+    // with the data there, the chunks of a broken chain are written
+    std::vector<std::unique_ptr<ChunkedFile>> parents;
+    if (parent) {
+        parents.push_back(std::move(parent));
+        while (!parents.back()->parent.empty() &&
+               isChunkedFile(parents.back()->parent)) {
+            std::unique_ptr<ChunkedFile> ancestor(
+                new ChunkedFile(parents.back()->parent));
+            if (ancestor->header->chunkSize != chunkedChunkSize ||
+                ancestor->header->numChunks != num_chunks)
+                break;
+            parents.push_back(std::move(ancestor));
+        }
+    }
+
+    FILE *f = fopen(filepath.c_str(), "wb");
+    if (f == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    ChunkedHeader header;
+    memcpy(header.magic, chunkedMagic, sizeof(chunkedMagic));
+    header.version = chunkedVersion;
+    header.parentLen = parent_path.size();
+    header.chunkSize = chunkedChunkSize;
+    header.numChunks = num_chunks;
+
+    // the table is written once all the chunks are
+    const uint64_t table = chunkTableOffset(header.parentLen);
+    uint64_t offset = table + num_chunks * sizeof(ChunkEntry);
+    std::vector<ChunkEntry> entries(num_chunks);
+
+    if (fwrite(&header, sizeof(header), 1, f) != 1 ||
+        fwrite(parent_path.data(), 1, parent_path.size(), f) !=
+        parent_path.size() || fseeko(f, offset, SEEK_SET))
+        fatal("Write failed on physical memory checkpoint file '%s'\n",
+              filepath);
+
+    // compress a batch of chunks in parallel, and then append them to
+    // the file in order
+    const uint64_t batch = cptThreads * chunkedBatch;
+    std::vector<std::vector<uint8_t>> buffers(batch);
+    uint64_t counts[ParentChunk + 1] = {};
+
+    for (uint64_t first = 0; first < num_chunks; first += batch) {
+        const uint64_t n = std::min(batch, num_chunks - first);
+
+        parallelFor(n, cptThreads, [&](uint64_t j) {
+            const uint64_t i = first + j;
+            const uint8_t *data = pmem + i * chunkedChunkSize;
+            const uint64_t len = std::min(chunkedChunkSize,
+                                          store_size - i * chunkedChunkSize);
+            ChunkEntry &e = entries[i];
+            std::vector<uint8_t> &buf = buffers[j];
+
+            e.offset = 0;
+            e.size = 0;
+            e.crc = 0;
+            e.adler = 0;
+            buf.clear();
+
+            if (isZero(data, len)) {
+                e.type = ZeroChunk;
+                return;
+            }
+
+            e.crc = crc32(0, data, len);
+            e.adler = adler32(1, data, len);
+            if (!parents.empty()) {
+                const ChunkEntry &p = parents.front()->entries[i];
+                if (p.type != ZeroChunk && p.crc == e.crc &&
+                    p.adler == e.adler &&
+                    sameAsParent(parents, i, data, len, buf)) {
+                    e.type = ParentChunk;
+                    return;
+                }
+            }
+
+            // favour speed, the chunks of a memory image are mostly
+            // either very compressible or not at all
+            uLongf dlen = compressBound(len);
+            buf.resize(dlen);
+            if (compress2(buf.data(), &dlen, data, len, Z_BEST_SPEED) ==
+                Z_OK && dlen < len) {
+                e.type = DeflatedChunk;
+                e.size = dlen;
+                buf.resize(dlen);
+            } else {
+                // written straight from the store
+                e.type = RawChunk;
+                e.size = len;
+                buf.clear();
+            }
+        });
+
+        for (uint64_t j = 0; j < n; j++) {
+            ChunkEntry &e = entries[first + j];
+            ++counts[e.type];
+            if (e.size == 0)
+                continue;
+
+            const uint8_t *data = e.type == RawChunk ?
+                pmem + (first + j) * chunkedChunkSize : buffers[j].data();
+            if (fwrite(data, 1, e.size, f) != e.size)
+                fatal("Write failed on physical memory checkpoint file "
+                      "'%s'\n", filepath);
+            e.offset = offset;
+            offset += e.size;
+        }
+    }
+
+    if (fseeko(f, table, SEEK_SET) ||
+        fwrite(entries.data(), sizeof(ChunkEntry), num_chunks, f) !=
+        num_chunks)
+        fatal("Write failed on physical memory checkpoint file '%s'\n",
+              filepath);
+
+    if (fclose(f))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+
+    DPRINTF(Checkpoint, "Wrote %d chunks: %d zero, %d deflated, %d raw, "
+            "%d from parent, %d bytes\n", num_chunks, counts[ZeroChunk],
+            counts[DeflatedChunk], counts[RawChunk], counts[ParentChunk],
+            offset);
+}
+
+void
+PhysicalMemory::unserializeChunkedStore(const string &filepath,
+                                        AddrRange range, uint8_t* pmem) const
+{
+    const uint64_t store_size = range.size();
+
+    // the chunks that are still to be restored, which move on to the
+    // parent checkpoint if they are not in the file at hand
+    std::vector<uint64_t> pending;
+    string path = filepath;
+
+    for (bool first = true; first || !pending.empty(); first = false) {
+        fatal_if(path.empty(), "Physical memory checkpoint '%s' refers to "
+                 "a parent checkpoint that it does not name\n", filepath);
+
+        ChunkedFile file(path);
+        const uint64_t chunk_size = file.header->chunkSize;
+        fatal_if(file.header->numChunks !=
+                 divCeil(store_size, chunk_size),
+                 "Physical memory checkpoint '%s' does not match the size "
+                 "of the store\n", path);
+
+        if (first) {
+            pending.resize(file.header->numChunks);
+            for (uint64_t i = 0; i < pending.size(); i++)
+                pending[i] = i;
+        }
+
+        DPRINTF(Checkpoint, "Restoring %d chunks from %s\n",
+                pending.size(), path);
+
+        // the outcome for every chunk, the worker threads leave it to
+        // this thread to report any error
+        enum ChunkStatus : uint8_t
+        {
+            Restored,
+            /** Left to the parent checkpoint */
+            Deferred,
+            Truncated,
+            Corrupt,
+            UnknownType
+        };
+        std::vector<uint8_t> status(pending.size(), Restored);
+
+        parallelFor(pending.size(), cptThreads, [&](uint64_t j) {
+            const uint64_t i = pending[j];
+            const ChunkEntry &e = file.entries[i];
+            uint8_t *data = pmem + i * chunk_size;
+            const uint64_t len = std::min(chunk_size,
+                                          store_size - i * chunk_size);
+
+            if (e.offset + e.size > file.length) {
+                status[j] = Truncated;
+                return;
+            }
+
+            switch (e.type) {
+              case ZeroChunk:
+                // the store is freshly mapped and thus already zero,
+                // and we don't want to give the VM system hell
+                break;
+              case DeflatedChunk: {
+                uLongf dlen = len;
+                if (uncompress(data, &dlen, file.base + e.offset,
+                               e.size) != Z_OK || dlen != len)
+                    status[j] = Corrupt;
+                break;
+              }
+              case RawChunk:
+                if (e.size != len)
+                    status[j] = Corrupt;
+                else
+                    memcpy(data, file.base + e.offset, len);
+                break;
+              case ParentChunk:
+                status[j] = Deferred;
+                break;
+              default:
+                status[j] = UnknownType;
+            }
+        });
+
+        std::vector<uint64_t> remaining;
+        for (uint64_t j = 0; j < pending.size(); j++) {
+            const uint64_t i = pending[j];
+            switch (status[j]) {
+              case Restored:
+                break;
+              case Deferred:
+                remaining.push_back(i);
+                break;
+              case Truncated:
+                fatal("Physical memory checkpoint file '%s' is truncated\n",
+                      path);
+              case Corrupt:
+                fatal("Corrupt chunk %d in physical memory checkpoint "
+                      "file '%s'\n", i, path);
+              default:
+                fatal("Unknown chunk type %d in physical memory checkpoint "
+                      "file '%s'\n", file.entries[i].type, path);
+            }
+        }
+        pending.swap(remaining);
+        path = file.parent;
+    }
 }
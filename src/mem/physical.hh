@@ -39,6 +39,7 @@
 #define __MEM_PHYSICAL_HH__
 
 #include "base/addr_range_map.hh"
+#include "enums/BackstorePages.hh"
 #include "mem/packet.hh"
 
 /**
@@ -129,10 +130,29 @@ class PhysicalMemory : public Serializable
 
     const std::string sharedBackstore;
 
+    // The host pages backing the memory, and the host NUMA node to
+    // bind it to, if any
+    const Enums::BackstorePages backstorePages;
+    const int backstoreNumaNode;
+
+    // Write the backing store in the chunked checkpoint format rather
+    // than as a single gzip stream
+    const bool chunkedCpt;
+
+    // Number of threads compressing and restoring chunked checkpoints
+    const unsigned cptThreads;
+
+    // Checkpoint directory the chunked checkpoints are a delta against
+    const std::string cptParent;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<BackingStoreEntry> backingStore;
 
+    // The size of the mapping of each backing store, which is rounded
+    // up to a whole number of pages when using huge pages
+    std::vector<uint64_t> backingStoreMapSize;
+
     // Prevent copying
     PhysicalMemory(const PhysicalMemory&);
 
@@ -153,6 +173,47 @@ class PhysicalMemory : public Serializable
                             bool conf_table_reported,
                             bool in_addr_map, bool kvm_map);
 
+    /**
+     * Map host memory for a backing store, using huge pages if asked
+     * to and falling back to smaller pages if they are not available.
+     *
+     * @param size The size of the backing store
+     * @param shm_fd The shared backing store file, or -1
+     * @param map_flags The flags to map the memory with
+     * @param map_size Returns the size of the mapping
+     * @return The host memory
+     */
+    uint8_t* mapBackingStore(uint64_t size, int shm_fd, int map_flags,
+                             uint64_t &map_size) const;
+
+    /**
+     * Write a backing store in the chunked format. The store is split
+     * in chunks that are compressed independently and in parallel,
+     * chunks that only hold zeros are not written at all, and chunks
+     * that are unchanged since the parent checkpoint, if any, refer to
+     * it instead of being written again.
+     *
+     * @param filepath The file to write
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     */
+    void serializeChunkedStore(const std::string &filepath,
+                               AddrRange range, uint8_t* pmem) const;
+
+    /**
+     * Restore a backing store written in the chunked format. The file
+     * is mapped rather than read and the chunks are decompressed in
+     * parallel directly into the backing store.
+     */
+    void unserializeChunkedStore(const std::string &filepath,
+                                 AddrRange range, uint8_t* pmem) const;
+
+    /**
+     * Restore a backing store written as a single gzip stream.
+     */
+    void unserializeGzipStore(const std::string &filepath,
+                              AddrRange range, uint8_t* pmem) const;
+
   public:
 
     /**
@@ -161,7 +222,11 @@ class PhysicalMemory : public Serializable
     PhysicalMemory(const std::string& _name,
                    const std::vector<AbstractMemory*>& _memories,
                    bool mmap_using_noreserve,
-                   const std::string& shared_backstore);
+                   const std::string& shared_backstore,
+                   Enums::BackstorePages backstore_pages,
+                   int backstore_numa_node,
+                   bool chunked_cpt, unsigned cpt_threads,
+                   const std::string& cpt_parent);
 
     /**
      * Unmap all the backing store we have used.
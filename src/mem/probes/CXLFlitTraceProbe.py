@@ -0,0 +1,13 @@
+from m5.params import *
+from m5.proxy import *
+from m5.objects.Probe import ProbeListenerObject
+
+class CXLFlitTraceProbe(ProbeListenerObject):
+    type = 'CXLFlitTraceProbe'
+    cxx_header = "mem/probes/cxl_flit_trace.hh"
+
+    # Boolean to compress the trace or not.
+    trace_compress = Param.Bool(True, "Enable trace compression")
+
+    # flit trace output file, disabled by default
+    trace_file = Param.String("", "CXL flit trace output file")
@@ -0,0 +1,105 @@
+#include "mem/probes/cxl_flit_trace.hh"
+
+#include "base/callback.hh"
+#include "base/output.hh"
+#include "params/CXLFlitTraceProbe.hh"
+#include "proto/cxl_flit.pb.h"
+
+CXLFlitTraceProbe::CXLFlitTraceProbe(CXLFlitTraceProbeParams *p)
+    : ProbeListenerObject(p),
+      traceStream(nullptr)
+{
+    std::string filename;
+    if (p->trace_file != "") {
+        // If the trace file is not specified as an absolute path,
+        // append the current simulation output directory
+        filename = simout.resolve(p->trace_file);
+
+        const std::string suffix = ".gz";
+        // If trace_compress has been set, check the suffix. Append
+        // accordingly.
+        if (p->trace_compress &&
+            filename.compare(filename.size() - suffix.size(), suffix.size(),
+                             suffix) != 0)
+            filename = filename + suffix;
+    } else {
+        // Generate a filename from the name of the SimObject. Append .trc
+        // and .gz if we want compression enabled.
+        filename = simout.resolve(name() + ".trc" +
+                                  (p->trace_compress ? ".gz" : ""));
+    }
+
+    traceStream = new ProtoOutputStream(filename);
+
+    // Register a callback to compensate for the destructor not
+    // being called. The callback forces the stream to flush and
+    // closes the output file.
+    registerExitCallback([this]() { closeStreams(); });
+}
+
+void
+CXLFlitTraceProbe::regProbeListeners()
+{
+    listeners.push_back(
+        new ProbeListenerArg<CXLFlitTraceProbe, ProbePoints::CXLFlitInfo>(
+            this, "CXLFlit", &CXLFlitTraceProbe::handleFlit));
+}
+
+void
+CXLFlitTraceProbe::startup()
+{
+    // Create a protobuf message for the header and write it to
+    // the stream
+    ProtoMessage::CXLFlitHeader header_msg;
+    header_msg.set_obj_id(name());
+    header_msg.set_tick_freq(SimClock::Frequency);
+
+    traceStream->write(header_msg);
+}
+
+void
+CXLFlitTraceProbe::closeStreams()
+{
+    if (traceStream != NULL)
+        delete traceStream;
+}
+
+void
+CXLFlitTraceProbe::handleFlit(const ProbePoints::CXLFlitInfo &flit_info)
+{
+    ProtoMessage::CXLFlit flit_msg;
+
+    flit_msg.set_tick(curTick());
+    flit_msg.set_channel(
+        static_cast<ProtoMessage::CXLFlit::Channel>(flit_info.channel));
+    flit_msg.set_cxl_cmd(flit_info.cxlCmd.toInt());
+    flit_msg.set_host_cmd(flit_info.hostCmd.toInt());
+    flit_msg.set_addr(flit_info.addr);
+    flit_msg.set_size(flit_info.size);
+    flit_msg.set_flit_size(flit_info.flitSize);
+    flit_msg.set_flags(flit_info.flags);
+    flit_msg.set_requestor_id(flit_info.id);
+
+    // only record what is actually used to keep the stream compact
+    if (flit_info.rollover != 0)
+        flit_msg.set_rollover(flit_info.rollover);
+    if (flit_info.isS2M()) {
+        flit_msg.set_free_ndr_slots(flit_info.freeNDRSlots);
+        flit_msg.set_free_drs_slots(flit_info.freeDRSSlots);
+    }
+    if (flit_info.reqCrd != 0)
+        flit_msg.set_req_crd(flit_info.reqCrd);
+    if (flit_info.rspCrd != 0)
+        flit_msg.set_rsp_crd(flit_info.rspCrd);
+    if (flit_info.dataCrd != 0)
+        flit_msg.set_data_crd(flit_info.dataCrd);
+
+    traceStream->write(flit_msg);
+}
+
+
+CXLFlitTraceProbe *
+CXLFlitTraceProbeParams::create()
+{
+    return new CXLFlitTraceProbe(this);
+}
@@ -0,0 +1,39 @@
+#ifndef __MEM_PROBES_CXL_FLIT_TRACE_HH__
+#define __MEM_PROBES_CXL_FLIT_TRACE_HH__
+
+#include "mem/cxl_probe.hh"
+#include "proto/protoio.hh"
+#include "sim/probe/probe.hh"
+
+struct CXLFlitTraceProbeParams;
+
+/**
+ * Records every flit seen by a CXL controller into a protobuf
+ * stream. The M2S flits of the trace can be replayed by the CXL_TRACE
+ * state of the traffic generator.
+ */
+class CXLFlitTraceProbe : public ProbeListenerObject
+{
+  public:
+    CXLFlitTraceProbe(CXLFlitTraceProbeParams *params);
+
+    void regProbeListeners() override;
+
+  protected:
+    void handleFlit(const ProbePoints::CXLFlitInfo &flit_info);
+
+    /**
+     * Callback to flush and close all open output streams on exit. If
+     * we were calling the destructor it could be done there.
+     */
+    void closeStreams();
+
+    void startup() override;
+
+  protected:
+
+    /** Trace output stream */
+    ProtoOutputStream *traceStream;
+};
+
+#endif //__MEM_PROBES_CXL_FLIT_TRACE_HH__
@@ -94,6 +94,9 @@ class QueuedResponsePort : public ResponsePort
      * functional request. */
     bool trySatisfyFunctional(PacketPtr pkt)
     { return respQueue.trySatisfyFunctional(pkt); }
+
+    /** The queue holding the outgoing responses */
+    RespPacketQueue &responseQueue() { return respQueue; }
 };
 
 /**
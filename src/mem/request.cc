@@ -0,0 +1,10 @@
+/**
+ * @file
+ * Definition of the pool the requests are allocated from.
+ */
+
+#include "mem/request.hh"
+
+// std::allocate_shared keeps the reference counts of the shared_ptr
+// next to the request, so leave some room for them
+SlabPool requestPool("request", sizeof(Request) + 4 * sizeof(void *));
@@ -50,11 +50,15 @@
 
 #include <cassert>
 #include <climits>
+#include <memory>
+#include <utility>
 
 #include "base/amo.hh"
 #include "base/flags.hh"
 #include "base/logging.hh"
+#include "base/slab_pool.hh"
 #include "base/types.hh"
+#include "config/use_pool_alloc.hh"
 #include "cpu/inst_seq.hh"
 #include "mem/htm.hh"
 #include "sim/core.hh"
@@ -82,6 +86,10 @@ class Request;
 class ThreadContext;
 
 typedef std::shared_ptr<Request> RequestPtr;
+
+template <typename... Args>
+inline RequestPtr makeRequest(Args&&... args);
+
 typedef uint16_t RequestorID;
 
 class Request
@@ -178,6 +186,11 @@ class Request
         INVALIDATE                  = 0x0000000100000000,
         /** The request cleans a memory location */
         CLEAN                       = 0x0000000200000000,
+        /**
+         * The request is a back-invalidation by a snoop filter that
+         * evicted the line, and no one waits for a response
+         */
+        BACK_INVALIDATE             = 0x0000000400000000,
 
         /** The request targets the point of unification */
         DST_POU                     = 0x0000001000000000,
@@ -536,8 +549,8 @@ class Request
         assert(privateFlags.isSet(VALID_VADDR));
         assert(privateFlags.noneSet(VALID_PADDR));
         assert(split_addr > _vaddr && split_addr < _vaddr + _size);
-        req1 = std::make_shared<Request>(*this);
-        req2 = std::make_shared<Request>(*this);
+        req1 = makeRequest(*this);
+        req2 = makeRequest(*this);
         req1->_size = split_addr - _vaddr;
         req2->_vaddr = split_addr;
         req2->_size = _size - req1->_size;
@@ -959,7 +972,29 @@ class Request
     bool isCacheClean() const { return _flags.isSet(CLEAN); }
     bool isCacheInvalidate() const { return _flags.isSet(INVALIDATE); }
     bool isCacheMaintenance() const { return _flags.isSet(CLEAN|INVALIDATE); }
+    bool isBackInvalidate() const { return _flags.isSet(BACK_INVALIDATE); }
     /** @} */
 };
 
+/** Pool holding the requests together with their reference counts */
+extern SlabPool requestPool;
+
+/**
+ * Create a new request, taking the same arguments as the constructors
+ * of Request. Requests are created and dropped for every access, so
+ * unless pooling is disabled they are allocated from a per-thread pool
+ * rather than the heap.
+ */
+template <typename... Args>
+inline RequestPtr
+makeRequest(Args&&... args)
+{
+#if USE_POOL_ALLOC
+    return std::allocate_shared<Request>(PoolAllocator<Request>(requestPool),
+                                         std::forward<Args>(args)...);
+#else
+    return std::make_shared<Request>(std::forward<Args>(args)...);
+#endif
+}
+
 #endif // __MEM_REQUEST_HH__
@@ -50,6 +50,7 @@
 #include "base/trace.hh"
 #include "debug/SerialLink.hh"
 #include "params/SerialLink.hh"
+#include "sim/stats.hh"
 
 SerialLink::SerialLinkResponsePort::
 SerialLinkResponsePort(const std::string& _name,
@@ -85,9 +86,31 @@ SerialLink::SerialLink(SerialLinkParams *p)
       mem_side_port(p->name + ".mem_side_port", *this, cpu_side_port,
                  ticksToCycles(p->delay), p->req_size),
       num_lanes(p->num_lanes),
-      link_speed(p->link_speed)
-
+      link_speed(p->link_speed),
+      linkPM(p->link_pm),
+      l0pLanes(p->l0p_lanes ? p->l0p_lanes : std::max(1u, p->num_lanes / 2)),
+      l0pIdleTimeout(p->l0p_idle_timeout),
+      l1IdleTimeout(p->l1_idle_timeout),
+      l0pExitLatency(p->l0p_exit_latency),
+      l1ExitLatency(p->l1_exit_latency),
+      linkState(L0), stateEntered(0), lastActive(0),
+      wakeDone(0), widenDone(0),
+      pmEvent([this]{ processPmEvent(); }, name()),
+      stats(*this)
 {
+    fatal_if(l0pLanes > num_lanes,
+             "%s: L0p cannot use more lanes than the link has\n", name());
+    fatal_if(linkPM && l1IdleTimeout <= l0pIdleTimeout,
+             "%s: the L1 idle timeout must be longer than the L0p one\n",
+             name());
+
+    energyPerBit[L0] = p->l0_energy_per_bit;
+    energyPerBit[L0p] = p->l0p_energy_per_bit;
+    energyPerBit[L1] = 0;
+
+    staticPower[L0] = p->l0_static_power;
+    staticPower[L0p] = p->l0p_static_power;
+    staticPower[L1] = p->l1_static_power;
 }
 
 Port&
@@ -113,6 +136,131 @@ SerialLink::init()
     cpu_side_port.sendRangeChange();
 }
 
+void
+SerialLink::startup()
+{
+    if (!linkPM)
+        return;
+
+    // the link comes up fully trained and starts counting idle time
+    // straight away
+    linkState = L0;
+    stateEntered = lastActive = curTick();
+    if (powerState->get() != Enums::PwrState::ON)
+        powerState->set(Enums::PwrState::ON);
+
+    schedule(pmEvent, curTick() + l0pIdleTimeout);
+}
+
+Cycles
+SerialLink::serializationCycles(unsigned size) const
+{
+    unsigned lanes = curTick() < widenDone ? l0pLanes : num_lanes;
+    return Cycles(divCeil(size * 8, lanes * link_speed));
+}
+
+Cycles
+SerialLink::transferCycles(unsigned size, Cycles delay)
+{
+    if (!linkPM)
+        return delay + serializationCycles(size);
+
+    if (linkState == L1) {
+        // the lanes have to retrain before anything can cross the
+        // link, and the flit that woke it up pays for it
+        DPRINTF(SerialLink, "Leaving L1, link usable at %llu\n",
+                curTick() + l1ExitLatency);
+        wakeDone = curTick() + l1ExitLatency;
+        setLinkState(L0);
+    } else if (linkState == L0p) {
+        // traffic keeps flowing on the active lanes while the idle
+        // ones are brought back up
+        DPRINTF(SerialLink, "Leaving L0p, full width at %llu\n",
+                curTick() + l0pExitLatency);
+        widenDone = curTick() + l0pExitLatency;
+        setLinkState(L0);
+    }
+
+    Cycles stall(0);
+    if (curTick() < wakeDone) {
+        stall = Cycles(divCeil(wakeDone - curTick(), clockPeriod()));
+        stats.wakeStallTicks += wakeDone - curTick();
+    }
+
+    // the flit is serialized on the lanes active when it starts
+    const Tick start = std::max(curTick(), wakeDone);
+    const LinkPwrState width = start < widenDone ? L0p : L0;
+    const unsigned lanes = width == L0p ? l0pLanes : num_lanes;
+    const Cycles ser(divCeil(size * 8, lanes * link_speed));
+
+    stats.bits[width] += size * 8;
+    stats.dynEnergy[width] += size * 8 * energyPerBit[width];
+
+    // the idle timeouts count from the end of the last transfer
+    lastActive = std::max(lastActive, clockEdge(stall + ser));
+    if (!pmEvent.scheduled())
+        schedule(pmEvent, lastActive + l0pIdleTimeout);
+
+    return delay + stall + ser;
+}
+
+void
+SerialLink::processPmEvent()
+{
+    // traffic does not move the event, so check whether the link has
+    // really been idle for long enough, and if not try again later
+    if (linkState == L0) {
+        const Tick due = lastActive + l0pIdleTimeout;
+        if (curTick() < due) {
+            schedule(pmEvent, due);
+            return;
+        }
+        setLinkState(L0p);
+        schedule(pmEvent, lastActive + l1IdleTimeout);
+    } else if (linkState == L0p) {
+        const Tick due = lastActive + l1IdleTimeout;
+        if (curTick() < due) {
+            schedule(pmEvent, due);
+            return;
+        }
+        setLinkState(L1);
+    }
+}
+
+void
+SerialLink::updateResidency()
+{
+    const Tick elapsed = curTick() - stateEntered;
+    stats.residency[linkState] += elapsed;
+    // mW over ticks to pJ
+    stats.staticEnergy[linkState] += staticPower[linkState] * 1e9 *
+        elapsed / SimClock::Frequency;
+    stateEntered = curTick();
+}
+
+void
+SerialLink::setLinkState(LinkPwrState state)
+{
+    assert(state != linkState);
+
+    static const char *state_name[Num_LinkPwrState] = { "L0", "L0p", "L1" };
+    DPRINTF(SerialLink, "Link power state %s -> %s\n",
+            state_name[linkState], state_name[state]);
+
+    updateResidency();
+    linkState = state;
+    ++stats.transitions[state];
+
+    // map the link states on the generic ones so that they show up in
+    // the power state residency and can drive a power model
+    static const Enums::PwrState pwr_state[Num_LinkPwrState] = {
+        Enums::PwrState::ON,
+        Enums::PwrState::CLK_GATED,
+        Enums::PwrState::SRAM_RETENTION
+    };
+    powerState->set(pwr_state[state]);
+}
+
 bool
 SerialLink::SerialLinkResponsePort::respQueueFull() const
 {
@@ -143,10 +291,8 @@ SerialLink::SerialLinkRequestPort::recvTimingResp(PacketPtr pkt)
     // first flit, but the deserializer (at the host side in this case), will
     // have to wait to receive the whole packet. So we only account for the
     // deserialization latency.
-    Cycles cycles = delay;
-    cycles += Cycles(divCeil(pkt->getSize() * 8, serial_link.num_lanes
-                * serial_link.link_speed));
-     Tick t = serial_link.clockEdge(cycles);
+    Cycles cycles = serial_link.transferCycles(pkt->getLinkSize(), delay);
+    Tick t = serial_link.clockEdge(cycles);
 
     //@todo: If the processor sends two uncached requests towards HMC and the
     // second one is smaller than the first one. It may happen that the second
@@ -204,9 +350,8 @@ SerialLink::SerialLinkResponsePort::recvTimingReq(PacketPtr pkt)
             // to check its integrity first. So everytime a packet crosses a
             // serial link, we should account for its deserialization latency
             // only.
-            Cycles cycles = delay;
-            cycles += Cycles(divCeil(pkt->getSize() * 8,
-                    serial_link.num_lanes * serial_link.link_speed));
+            Cycles cycles = serial_link.transferCycles(pkt->getLinkSize(),
+                                                       delay);
             Tick t = serial_link.clockEdge(cycles);
 
             //@todo: If the processor sends two uncached requests towards HMC
@@ -292,8 +437,8 @@ SerialLink::SerialLinkRequestPort::trySendTiming()
             DPRINTF(SerialLink, "Scheduling next send\n");
 
             // Make sure bandwidth limitation is met
-            Cycles cycles = Cycles(divCeil(pkt->getSize() * 8,
-                serial_link.num_lanes * serial_link.link_speed));
+            Cycles cycles = serial_link.serializationCycles(
+                pkt->getSize());
             Tick t = serial_link.clockEdge(cycles);
             serial_link.schedule(sendEvent, std::max(next_req.tick, t));
         }
@@ -337,8 +482,8 @@ SerialLink::SerialLinkResponsePort::trySendTiming()
             DPRINTF(SerialLink, "Scheduling next send\n");
 
             // Make sure bandwidth limitation is met
-            Cycles cycles = Cycles(divCeil(pkt->getSize() * 8,
-                serial_link.num_lanes * serial_link.link_speed));
+            Cycles cycles = serial_link.serializationCycles(
+                pkt->getSize());
             Tick t = serial_link.clockEdge(cycles);
             serial_link.schedule(sendEvent, std::max(next_resp.tick, t));
         }
@@ -422,6 +567,59 @@ SerialLink::SerialLinkResponsePort::getAddrRanges() const
     return ranges;
 }
 
+SerialLink::LinkPowerStats::LinkPowerStats(SerialLink &_link)
+    : Stats::Group(&_link),
+    link(_link),
+
+    ADD_STAT(residency, "Ticks spent in each link power state"),
+    ADD_STAT(transitions, "Number of entries into each link power state"),
+    ADD_STAT(bits, "Bits transferred in each link power state"),
+    ADD_STAT(dynEnergy, "Energy of the transferred bits per state (pJ)"),
+    ADD_STAT(staticEnergy, "Static energy per link power state (pJ)"),
+    ADD_STAT(wakeStallTicks,
+             "Ticks packets were stalled waiting for the link to retrain"),
+
+    ADD_STAT(totalEnergy, "Total link energy (pJ)"),
+    ADD_STAT(dynPower, "Average dynamic link power (W)"),
+    ADD_STAT(avgPower, "Average link power (W)")
+{
+}
+
+void
+SerialLink::LinkPowerStats::regStats()
+{
+    using namespace Stats;
+
+    Stats::Group::regStats();
+
+    residency.init(Num_LinkPwrState).flags(nozero);
+    transitions.init(Num_LinkPwrState).flags(nozero);
+    bits.init(Num_LinkPwrState).flags(nozero);
+    dynEnergy.init(Num_LinkPwrState).flags(nozero);
+    staticEnergy.init(Num_LinkPwrState).flags(nozero);
+
+    for (auto vec : { &residency, &transitions, &bits, &dynEnergy,
+                      &staticEnergy }) {
+        vec->subname(L0, "L0");
+        vec->subname(L0p, "L0p");
+        vec->subname(L1, "L1");
+    }
+
+    totalEnergy = sum(dynEnergy) + sum(staticEnergy);
+    dynPower = sum(dynEnergy) / 1e12 / simSeconds;
+    avgPower = totalEnergy / 1e12 / simSeconds;
+}
+
+void
+SerialLink::LinkPowerStats::preDumpStats()
+{
+    Stats::Group::preDumpStats();
+
+    // account for the time spent in the current state so far
+    if (link.linkPM)
+        link.updateResidency();
+}
+
 SerialLink *
 SerialLinkParams::create()
 {
@@ -50,6 +50,7 @@
 
 #include <deque>
 
+#include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/port.hh"
 #include "params/SerialLink.hh"
@@ -310,6 +311,129 @@ class SerialLink : public ClockedObject
     /** Speed of each link (Gb/s) in this serial link */
     uint64_t link_speed;
 
+  public:
+
+    /**
+     * Link power states, ordered from the most to the least
+     * performant. In L0 all lanes are up, in L0p only a subset of the
+     * lanes is kept active and in L1 the link is electrically idle and
+     * has to retrain before it can carry traffic again.
+     */
+    enum LinkPwrState {
+        L0 = 0,
+        L0p,
+        L1,
+        Num_LinkPwrState
+    };
+
+  protected:
+
+    /** Is link power management enabled */
+    const bool linkPM;
+
+    /** Number of lanes kept active in L0p */
+    const unsigned l0pLanes;
+
+    /** Idle time after which the link enters L0p and L1 */
+    const Tick l0pIdleTimeout;
+    const Tick l1IdleTimeout;
+
+    /** Time to bring the idle lanes back up when leaving L0p */
+    const Tick l0pExitLatency;
+
+    /** Time to retrain the link when leaving L1 */
+    const Tick l1ExitLatency;
+
+    /** Energy per transferred bit in each state (pJ/bit) */
+    double energyPerBit[Num_LinkPwrState];
+
+    /** Static power drawn in each state (mW) */
+    double staticPower[Num_LinkPwrState];
+
+    /** Current link power state */
+    LinkPwrState linkState;
+
+    /** Tick at which the current link power state was entered */
+    Tick stateEntered;
+
+    /** Tick at which the last flit finished crossing the link */
+    Tick lastActive;
+
+    /** Until this tick the link is retraining after leaving L1 */
+    Tick wakeDone;
+
+    /** Until this tick only the L0p lanes are available */
+    Tick widenDone;
+
+    /**
+     * Account for a packet crossing the link. If link power management
+     * is enabled, a link in a low-power state is woken up and the exit
+     * latency is charged to this packet.
+     *
+     * @param size the size of the packet in bytes
+     * @param delay the fixed delay of the link
+     * @return the number of cycles until the packet is deserialized
+     */
+    Cycles transferCycles(unsigned size, Cycles delay);
+
+    /**
+     * Number of cycles needed to serialize a packet with the lanes that
+     * are active at the current tick.
+     *
+     * @param size the size of the packet in bytes
+     */
+    Cycles serializationCycles(unsigned size) const;
+
+    /**
+     * Move the link to a new power state, updating the residency
+     * stats and the power state of the ClockedObject.
+     */
+    void setLinkState(LinkPwrState state);
+
+    /** Charge the time spent in the current state to the stats */
+    void updateResidency();
+
+    /** Check the idle timeouts and step the link down if they expired */
+    void processPmEvent();
+
+    /** Event driving the idle timeouts */
+    EventFunctionWrapper pmEvent;
+
+    struct LinkPowerStats : public Stats::Group
+    {
+        LinkPowerStats(SerialLink &link);
+
+        void regStats() override;
+
+        void preDumpStats() override;
+
+        SerialLink &link;
+
+        /** Ticks spent in each link power state */
+        Stats::Vector residency;
+
+        /** Number of times each link power state was entered */
+        Stats::Vector transitions;
+
+        /** Bits transferred in each link power state */
+        Stats::Vector bits;
+
+        /** Energy of the transferred bits in each state (pJ) */
+        Stats::Vector dynEnergy;
+
+        /** Static energy in each state (pJ) */
+        Stats::Vector staticEnergy;
+
+        /** Ticks packets were stalled waiting for the link to retrain */
+        Stats::Scalar wakeStallTicks;
+
+        Stats::Formula totalEnergy;
+        Stats::Formula dynPower;
+        Stats::Formula avgPower;
+    };
+
+    LinkPowerStats stats;
+
   public:
 
     Port &getPort(const std::string &if_name,
@@ -317,6 +441,8 @@ class SerialLink : public ClockedObject
 
     virtual void init();
 
+    void startup() override;
+
     typedef SerialLinkParams Params;
 
     SerialLink(SerialLinkParams *p);
@@ -160,7 +160,8 @@ SimpleMemory::recvTimingReq(PacketPtr pkt)
         // atomic response
         assert(pkt->isResponse());
 
-        Tick when_to_send = curTick() + receive_delay + getLatency();
+        Tick when_to_send = curTick() + receive_delay + getLatency() +
+            compressForLink(pkt);
 
         // typically this should be added at the end, so start the
         // insertion sort with the last element, also make sure not to
@@ -49,11 +49,40 @@
 
 const int SnoopFilter::SNOOP_MASK_SIZE;
 
+SnoopFilter::SnoopFilter(const SnoopFilterParams *p) :
+    SimObject(p), reqLookupResult(cachedLocations.end()),
+    linesize(p->system->cacheLineSize()), lookupLatency(p->lookup_latency),
+    maxEntryCount(p->max_capacity / p->system->cacheLineSize()),
+    system(p->system), assoc(p->assoc),
+    numSets(assoc ? maxEntryCount / assoc : 0),
+    replacementPolicy(p->replacement_policy)
+{
+    if (!assoc)
+        return;
+
+    fatal_if(numSets == 0, "%s: a capacity of %d lines is too small for "
+             "%d ways\n", name(), maxEntryCount, assoc);
+
+    ways.resize(numSets * assoc);
+    for (unsigned i = 0; i < ways.size(); i++) {
+        ways[i].setPosition(i / assoc, i % assoc);
+        ways[i].replacementData = replacementPolicy->instantiateEntry();
+    }
+    lostLines.resize(numSets, LostLine{0, 0});
+}
+
 void
 SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
 {
     SnoopItem& sf_item = sf_it->second;
     if ((sf_item.requested | sf_item.holder).none()) {
+        if (assoc) {
+            SnoopWay *way = findWay(sf_it->first);
+            if (way) {
+                way->valid = false;
+                replacementPolicy->invalidate(way->replacementData);
+            }
+        }
         cachedLocations.erase(sf_it);
         DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
                 __func__);
@@ -84,6 +113,25 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
     if (!is_hit && !allocate)
         return snoopDown(lookupLatency);
 
+    if (assoc) {
+        if (is_hit) {
+            SnoopWay *way = findWay(line_addr);
+            if (way)
+                replacementPolicy->touch(way->replacementData);
+        } else {
+            // see if the requestor lost the line to a back-invalidation
+            LostLine &lost = lostLines[setIndex(line_addr)];
+            if (lost.lineAddr == line_addr && (lost.ports & req_port).any()) {
+                backInvalidationMisses++;
+                lost.ports &= ~req_port;
+            }
+
+            // make room before adding the line, this may evict a line
+            // from the set
+            allocateWay(line_addr);
+        }
+    }
+
     // If no hit in snoop filter create a new element and update iterator
     if (!is_hit) {
         reqLookupResult.it =
@@ -193,7 +241,8 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     auto sf_it = cachedLocations.find(line_addr);
     bool is_hit = (sf_it != cachedLocations.end());
 
-    panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
+    panic_if(!assoc && !is_hit &&
+             (cachedLocations.size() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
              maxEntryCount);
 
@@ -387,6 +436,91 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
             __func__, sf_item.requested, sf_item.holder);
 }
 
+SnoopFilter::SnoopWay *
+SnoopFilter::findWay(Addr line_addr)
+{
+    SnoopWay *set = &ways[setIndex(line_addr) * assoc];
+    for (unsigned w = 0; w < assoc; w++) {
+        if (set[w].valid && set[w].lineAddr == line_addr)
+            return &set[w];
+    }
+    return nullptr;
+}
+
+void
+SnoopFilter::allocateWay(Addr line_addr)
+{
+    SnoopWay *set = &ways[setIndex(line_addr) * assoc];
+    SnoopWay *way = nullptr;
+
+    ReplacementCandidates candidates;
+    for (unsigned w = 0; w < assoc && !way; w++) {
+        if (!set[w].valid) {
+            way = &set[w];
+        } else if (cachedLocations.at(set[w].lineAddr).requested.none()) {
+            // lines with requests in flight have to stay put
+            candidates.push_back(&set[w]);
+        }
+    }
+
+    if (!way && candidates.empty()) {
+        DPRINTF(SnoopFilter, "%s: no way to evict for %#x\n", __func__,
+                line_addr);
+        overAllocations++;
+        return;
+    }
+
+    if (!way) {
+        way = static_cast<SnoopWay *>(
+            replacementPolicy->getVictim(candidates));
+
+        auto victim = cachedLocations.find(way->lineAddr);
+        assert(victim != cachedLocations.end());
+        const SnoopMask holders = victim->second.holder;
+        DPRINTF(SnoopFilter, "%s: evicting %#x SF value %x.%x for %#x\n",
+                __func__, way->lineAddr, victim->second.requested,
+                holders, line_addr);
+        cachedLocations.erase(victim);
+        capacityEvictions++;
+
+        lostLines[setIndex(way->lineAddr)] = LostLine{way->lineAddr, holders};
+        backInvalidate(way->lineAddr, holders);
+    }
+
+    way->lineAddr = line_addr;
+    way->valid = true;
+    replacementPolicy->reset(way->replacementData);
+}
+
+void
+SnoopFilter::backInvalidate(Addr line_addr, SnoopMask holders)
+{
+    // the clean and invalidate is marked as a back-invalidation, as
+    // there is no route for a response: a cache that holds the line
+    // dirty writes it back with a WriteClean, and a cache with a
+    // pending writeback of the line lets it carry on as a WriteClean,
+    // rather than supplying the data in a response
+    Request::Flags flags = Request::CLEAN | Request::INVALIDATE |
+        Request::BACK_INVALIDATE;
+    if (line_addr & LineSecure)
+        flags.set(Request::SECURE);
+    RequestPtr req = makeRequest(line_addr & ~Addr(LineSecure), linesize,
+                                 flags, Request::wbRequestorId);
+    Packet pkt(req, MemCmd::CleanInvalidReq);
+
+    for (const auto& p : maskToPortList(holders)) {
+        DPRINTF(SnoopFilter, "%s: %s for %#x\n", __func__, p->name(),
+                line_addr);
+        if (system->isTimingMode()) {
+            pkt.setExpressSnoop();
+            p->sendTimingSnoopReq(&pkt);
+        } else {
+            p->sendAtomicSnoop(&pkt);
+        }
+        backInvalidations++;
+    }
+}
+
 void
 SnoopFilter::regStats()
 {
@@ -419,6 +553,26 @@ SnoopFilter::regStats()
         .name(name() + ".hit_multi_snoops")
         .desc("Number of snoops hitting in the snoop filter with multiple "\
               "(>1) holders of the requested data.");
+
+    capacityEvictions
+        .name(name() + ".capacity_evictions")
+        .desc("Number of lines evicted from the snoop filter to make room "\
+              "for other lines.");
+
+    backInvalidations
+        .name(name() + ".back_invalidations")
+        .desc("Number of back-invalidation snoops sent to the holders of "\
+              "evicted lines.");
+
+    backInvalidationMisses
+        .name(name() + ".back_invalidation_misses")
+        .desc("Number of requests for lines that the requestor lost to a "\
+              "back-invalidation.");
+
+    overAllocations
+        .name(name() + ".over_allocations")
+        .desc("Number of lines tracked beyond the associativity as all the "\
+              "lines of the set had requests in flight.");
 }
 
 SnoopFilter *
@@ -47,6 +47,8 @@
 #include <unordered_map>
 #include <utility>
 
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "mem/qport.hh"
@@ -82,6 +84,13 @@
  *     upper cache dropped a line, making the snoop filter pessimistic for now
  * (4) ordering: there is no single point of order in the system.  Instead,
  *     requesting MSHRs track order between local requests and remote snoops
+ *
+ * By default the snoop filter tracks any number of lines, and merely
+ * checks that it does not exceed its maximum capacity. Alternatively
+ * it is organised in sets and ways like a directory, and a line that
+ * is allocated in a full set evicts another one. The caches above that
+ * hold the evicted line are sent a back-invalidation snoop, which
+ * makes them write back the line if it is dirty and drop it.
  */
 class SnoopFilter : public SimObject {
   public:
@@ -91,12 +100,7 @@ class SnoopFilter : public SimObject {
 
     typedef std::vector<QueuedResponsePort*> SnoopList;
 
-    SnoopFilter (const SnoopFilterParams *p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
-        linesize(p->system->cacheLineSize()), lookupLatency(p->lookup_latency),
-        maxEntryCount(p->max_capacity / p->system->cacheLineSize())
-    {
-    }
+    SnoopFilter (const SnoopFilterParams *p);
 
     /**
      * Init a new snoop filter and tell it about all the cpu_sideports
@@ -257,6 +261,48 @@ class SnoopFilter : public SimObject {
      */
     void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
 
+    /**
+     * A way of the set-associative organisation, holding the address
+     * of a line that is tracked in cachedLocations.
+     */
+    class SnoopWay : public ReplaceableEntry
+    {
+      public:
+        SnoopWay() : lineAddr(0), valid(false) {}
+
+        Addr lineAddr;
+        bool valid;
+    };
+
+    /** Set of a line in the set-associative organisation. */
+    unsigned
+    setIndex(Addr line_addr) const
+    {
+        return (line_addr / linesize) % numSets;
+    }
+
+    /** Find the way holding a line, if any. */
+    SnoopWay *findWay(Addr line_addr);
+
+    /**
+     * Allocate a way for a line that is not tracked yet, evicting
+     * another line of the set if needed. Lines with requests in flight
+     * are not evicted, and if all the lines of the set have requests
+     * in flight the new line is tracked beyond the associativity.
+     *
+     * @param line_addr Line address, including the secure bit
+     */
+    void allocateWay(Addr line_addr);
+
+    /**
+     * Send a back-invalidation snoop for an evicted line to the ports
+     * that hold it.
+     *
+     * @param line_addr Line address, including the secure bit
+     * @param holders Ports holding the line
+     */
+    void backInvalidate(Addr line_addr, SnoopMask holders);
+
     /** Simple hash set of cached addresses. */
     SnoopFilterCache cachedLocations;
 
@@ -301,6 +347,33 @@ class SnoopFilter : public SimObject {
     /** Max capacity in terms of cache blocks tracked, for sanity checking */
     const unsigned maxEntryCount;
 
+    /** System we are in, to know how to send back-invalidations */
+    System *system;
+
+    /** Associativity, or 0 for an unbounded snoop filter */
+    const unsigned assoc;
+
+    /** Number of sets when the snoop filter is set associative */
+    const unsigned numSets;
+
+    /** Replacement policy choosing the lines to evict from a set */
+    BaseReplacementPolicy *replacementPolicy;
+
+    /** The ways of all the sets */
+    std::vector<SnoopWay> ways;
+
+    /**
+     * Lines recently lost to back-invalidations, and the ports that
+     * lost them, indexed like the sets. This is used to tell which
+     * misses are caused by back-invalidations.
+     */
+    struct LostLine
+    {
+        Addr lineAddr;
+        SnoopMask ports;
+    };
+    std::vector<LostLine> lostLines;
+
     /**
      * Use the lower bits of the address to keep track of the line status
      */
@@ -317,6 +390,11 @@ class SnoopFilter : public SimObject {
     Stats::Scalar totSnoops;
     Stats::Scalar hitSingleSnoops;
     Stats::Scalar hitMultiSnoops;
+
+    Stats::Scalar capacityEvictions;
+    Stats::Scalar backInvalidations;
+    Stats::Scalar backInvalidationMisses;
+    Stats::Scalar overAllocations;
 };
 
 inline SnoopFilter::SnoopMask
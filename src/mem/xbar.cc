@@ -45,6 +45,8 @@
 
 #include "mem/xbar.hh"
 
+#include <algorithm>
+
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
@@ -58,6 +60,7 @@ BaseXBar::BaseXBar(const BaseXBarParams *p)
       responseLatency(p->response_latency),
       headerLatency(p->header_latency),
       width(p->width),
+      useDecodeTable(p->use_decode_table),
       gotAddrRanges(p->port_default_connection_count +
                           p->port_mem_side_ports_connection_count, false),
       gotAllAddrRanges(false), defaultPortID(InvalidPortID),
@@ -123,9 +126,11 @@ BaseXBar::calcPacketTiming(PacketPtr pkt, Tick header_delay)
         // the payloadDelay takes into account the relative time to
         // deliver the payload of the packet, after the header delay,
         // we take the maximum since the payload delay could already
-        // be longer than what this parcitular crossbar enforces.
+        // be longer than what this parcitular crossbar enforces. Data
+        // that is transferred compressed takes fewer beats.
         pkt->payloadDelay = std::max<Tick>(pkt->payloadDelay,
-                                           divCeil(pkt->getSize(), width) *
+                                           divCeil(pkt->getLinkSize(),
+                                                   width) *
                                            clockPeriod());
     }
 
@@ -135,6 +140,47 @@ BaseXBar::calcPacketTiming(PacketPtr pkt, Tick header_delay)
     // thus regulates throughput
 }
 
+void
+BaseXBar::limitRespQueues(size_t limit)
+{
+    waitingForRespQueue.resize(cpuSidePorts.size());
+    for (PortID id = 0; id < cpuSidePorts.size(); ++id) {
+        cpuSidePorts[id]->responseQueue().setLimit(
+            limit, [this, id]() { retryRespQueue(id); });
+    }
+}
+
+bool
+BaseXBar::respQueueHasSpace(PortID cpu_side_port_id,
+                            PortID mem_side_port_id)
+{
+    if (cpuSidePorts[cpu_side_port_id]->responseQueue().hasSpace())
+        return true;
+
+    // the queue is full, the memory-side port gets a retry once the
+    // queue has sent a packet
+    auto &waiting = waitingForRespQueue[cpu_side_port_id];
+    if (std::find(waiting.begin(), waiting.end(), mem_side_port_id) ==
+        waiting.end()) {
+        waiting.push_back(mem_side_port_id);
+    }
+    return false;
+}
+
+void
+BaseXBar::retryRespQueue(PortID cpu_side_port_id)
+{
+    // swap the list out first as the retry may fill the queue again
+    // and put the port back on the list
+    std::vector<PortID> waiting;
+    waiting.swap(waitingForRespQueue[cpu_side_port_id]);
+    for (auto mem_side_port_id : waiting) {
+        DPRINTF(XBar, "Retrying %s after response queue drained\n",
+                memSidePorts[mem_side_port_id]->name());
+        memSidePorts[mem_side_port_id]->sendRetryResp();
+    }
+}
+
 template <typename SrcType, typename DstType>
 BaseXBar::Layer<SrcType, DstType>::Layer(DstType& _port, BaseXBar& _xbar,
                                        const std::string& _name) :
@@ -330,6 +376,13 @@ BaseXBar::findPort(AddrRange addr_range)
     // ranges of all connected CPU-side-port modules
     assert(gotAllAddrRanges);
 
+    // Interleaved ranges are decoded directly from the address bits
+    if (useDecodeTable) {
+        const PortID *port_id = decodeTable.contains(addr_range);
+        if (port_id)
+            return *port_id;
+    }
+
     // Check the address map interval tree
     auto i = portMap.contains(addr_range);
     if (i != portMap.end()) {
@@ -355,6 +408,21 @@ BaseXBar::findPort(AddrRange addr_range)
           name());
 }
 
+void
+BaseXBar::buildDecodeTable()
+{
+    decodeTable.clear();
+    if (!useDecodeTable)
+        return;
+
+    for (const auto &r : portMap) {
+        if (decodeTable.insert(r.first, r.second)) {
+            DPRINTF(AddrRanges, "Decoding range %s for id %d directly\n",
+                    r.first.to_string(), r.second);
+        }
+    }
+}
+
 /** Function called by the port when the crossbar is receiving a range change.*/
 void
 BaseXBar::recvRangeChange(PortID mem_side_port_id)
@@ -427,6 +495,8 @@ BaseXBar::recvRangeChange(PortID mem_side_port_id)
                       memSidePorts[conflict_id]->getPeer());
             }
         }
+
+        buildDecodeTable();
     }
 
     // if we have received ranges from all our neighbouring CPU-side-port
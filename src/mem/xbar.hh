@@ -49,6 +49,7 @@
 #include <deque>
 #include <unordered_map>
 
+#include "base/addr_decode_table.hh"
 #include "base/addr_range_map.hh"
 #include "base/types.hh"
 #include "mem/qport.hh"
@@ -315,11 +316,22 @@ class BaseXBar : public ClockedObject
 
     AddrRangeMap<PortID, 3> portMap;
 
+    /**
+     * Direct decoding of the interleaved ranges in the port map, which
+     * is only searched for the ranges the table cannot decode.
+     */
+    AddrDecodeTable<PortID> decodeTable;
+
+    /** Whether to decode interleaved ranges using the table */
+    const bool useDecodeTable;
+
     /**
      * Remember where request packets came from so that we can route
      * responses to the appropriate port. This relies on the fact that
      * the underlying Request pointer inside the Packet stays
-     * constant.
+     * constant. Crossbars that do not have to route snoop responses
+     * use the route stack of the packet instead, see
+     * Packet::pushRoute().
      */
     std::unordered_map<RequestPtr, PortID> routeTo;
 
@@ -345,6 +357,12 @@ class BaseXBar : public ClockedObject
      */
     PortID findPort(AddrRange addr_range);
 
+    /**
+     * Rebuild the decode table from the port map, called whenever the
+     * address ranges of the memory-side ports change.
+     */
+    void buildDecodeTable();
+
     /**
      * Return the address ranges the crossbar is responsible for.
      *
@@ -363,6 +381,36 @@ class BaseXBar : public ClockedObject
      */
     void calcPacketTiming(PacketPtr pkt, Tick header_delay);
 
+    /**
+     * Bound the response queues of all the CPU-side ports. Once a queue
+     * holds the given number of packets, responses destined for it are
+     * refused and the memory-side ports they came from are sent a retry
+     * as soon as the queue drains a packet.
+     *
+     * @param limit maximum number of queued responses, 0 is unbounded
+     */
+    void limitRespQueues(size_t limit);
+
+    /**
+     * Check if the response queue of a CPU-side port can take another
+     * packet, and if not, remember to retry the memory-side port.
+     *
+     * @param cpu_side_port_id the port the response is destined for
+     * @param mem_side_port_id the port the response came from
+     * @return true if the response can be accepted
+     */
+    bool respQueueHasSpace(PortID cpu_side_port_id, PortID mem_side_port_id);
+
+    /**
+     * Called by a bounded response queue when it has space again.
+     *
+     * @param cpu_side_port_id the port owning the queue
+     */
+    void retryRespQueue(PortID cpu_side_port_id);
+
+    /** Memory-side ports waiting for space in a response queue */
+    std::vector<std::vector<PortID>> waitingForRespQueue;
+
     /**
      * Remember for each of the memory-side ports of the crossbar if we got
      * an address range from the connected CPU-side ports. For convenience,
@@ -48,6 +48,12 @@ from m5.objects.SimpleMemory import *
 class MemoryMode(Enum): vals = ['invalid', 'atomic', 'timing',
                                 'atomic_noncaching']
 
+# The host pages backing the simulated memory: the base pages, base
+# pages that the kernel may promote to transparent huge pages, or
+# huge pages of 2 MB or 1 GB from hugetlbfs
+class BackstorePages(Enum): vals = ['base_pages', 'transparent_huge_pages',
+                                    'huge_pages_2MB', 'huge_pages_1GB']
+
 if buildEnv['TARGET_ISA'] in ('sparc', 'power'):
     default_byte_order = 'big'
 else:
@@ -87,6 +93,29 @@ class System(SimObject):
         "use to directly address the backstore from another host-OS process. "
         "Leave this empty to unset the MAP_SHARED flag.")
 
+    # Huge pages reduce the host TLB misses when accessing large
+    # memories directly, e.g. in KVM and atomic mode. The huge pages
+    # of hugetlbfs have to be reserved on the host, and the backing
+    # store falls back to transparent huge pages if they are not.
+    backstore_pages = Param.BackstorePages('base_pages',
+        "Host pages backing the simulated memory")
+    backstore_numa_node = Param.Int(-1, "Host NUMA node to bind the "
+        "backing store to, -1 for the default policy of the host")
+
+    # The backing store is checkpointed in chunks that are compressed in
+    # parallel, skipping the chunks that only hold zeros. Checkpoints
+    # can also leave out the chunks that are unchanged since a parent
+    # checkpoint, which then has to be kept around for restoring.
+    # Checkpoints in the single gzip stream format remain readable, and
+    # remain the default as tools such as util/checkpoint_aggregator.py
+    # only read that format.
+    chunked_pmem_cpt = Param.Bool(False, "Checkpoint the backing store in "
+        "compressed chunks rather than as a single gzip stream")
+    pmem_cpt_threads = Param.Unsigned(0, "Threads compressing and restoring "
+        "the chunked backing store checkpoints, 0 for one per host core")
+    pmem_cpt_parent = Param.String("", "Checkpoint directory that the "
+        "chunked backing store checkpoints are a delta against")
+
     cache_line_size = Param.Unsigned(64, "Cache line size in bytes")
 
     byte_order = Param.ByteOrder(default_byte_order,
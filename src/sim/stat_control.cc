@@ -48,9 +48,12 @@
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <memory>
+#include <vector>
 
 #include "base/callback.hh"
 #include "base/hostinfo.hh"
+#include "base/slab_pool.hh"
 #include "base/statistics.hh"
 #include "base/time.hh"
 #include "cpu/base.hh"
@@ -103,6 +106,17 @@ struct Global
     Stats::Value simInsts;
     Stats::Value simOps;
 
+    /** Usage of a slab pool, see base/slab_pool.hh */
+    struct PoolStats
+    {
+        Stats::Value allocs;
+        Stats::Value hits;
+        Stats::Formula hitRate;
+        Stats::Value peakLive;
+    };
+
+    std::vector<std::unique_ptr<PoolStats>> poolStats;
+
     Global();
 };
 
@@ -182,6 +196,42 @@ Global::Global()
         .precision(0)
         ;
 
+    for (auto pool : SlabPool::pools()) {
+        poolStats.emplace_back(new PoolStats);
+        PoolStats &ps = *poolStats.back();
+        const std::string prefix = "pool_alloc." + pool->name();
+
+        ps.allocs
+            .method(pool, &SlabPool::allocs)
+            .name(prefix + ".allocs")
+            .desc("Number of blocks allocated from the pool")
+            .prereq(ps.allocs)
+            ;
+
+        ps.hits
+            .method(pool, &SlabPool::hits)
+            .name(prefix + ".hits")
+            .desc("Number of allocations served from a free list")
+            .prereq(ps.allocs)
+            ;
+
+        ps.hitRate
+            .name(prefix + ".hit_rate")
+            .desc("Fraction of allocations served from a free list")
+            .precision(6)
+            .prereq(ps.allocs)
+            ;
+
+        ps.peakLive
+            .method(pool, &SlabPool::peakLive)
+            .name(prefix + ".peak_live")
+            .desc("Peak number of live blocks")
+            .prereq(ps.allocs)
+            ;
+
+        ps.hitRate = ps.hits / ps.allocs;
+    }
+
     simSeconds = simTicks / simFreq;
     hostInstRate = simInsts / hostSeconds;
     hostOpRate = simOps / hostSeconds;
@@ -215,7 +215,9 @@ System::System(Params *p)
       kvmVM(nullptr),
 #endif
       physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve,
-              p->shared_backstore),
+              p->shared_backstore, p->backstore_pages,
+              p->backstore_numa_node, p->chunked_pmem_cpt,
+              p->pmem_cpt_threads, p->pmem_cpt_parent),
       memoryMode(p->mem_mode),
       _cacheLineSize(p->cache_line_size),
       workItemsBegin(0),
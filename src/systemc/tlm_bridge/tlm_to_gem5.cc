@@ -86,7 +86,7 @@ payload2packet(RequestorID _id, tlm::tlm_generic_payload &trans)
     }
 
     Request::Flags flags;
-    auto req = std::make_shared<Request>(
+    auto req = makeRequest(
         trans.get_address(), trans.get_data_length(), flags, _id);
 
     /*
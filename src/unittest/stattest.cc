@@ -102,6 +102,8 @@ struct StatTest
     Histogram h11;
     Histogram h12;
     SparseHistogram sh1;
+    QuantileSketch qs1;
+    VectorQuantileSketch qs2;
 
     Vector s20;
     Vector s21;
@@ -339,6 +341,19 @@ StatTest::init()
         .desc("this is sparse histogram 1")
         ;
 
+    qs1
+        .init()
+        .name("QuantileSketch1")
+        .desc("this is quantile sketch 1")
+        ;
+
+    qs2
+        .init(2, { 0.5, 0.9 })
+        .name("QuantileSketch2")
+        .desc("this is quantile sketch 2")
+        .subname(0, "first")
+        ;
+
     f1
         .name("Formula1")
         .desc("this is formula 1")
@@ -668,6 +683,8 @@ StatTest::run()
 
     for (int i = 0; i < 1000; i++) {
         sh1.sample(random() % 10000);
+        qs1.sample(random() % 10000);
+        qs2[i % 2].sample(i);
     }
 
     s20[0] = 1;
@@ -0,0 +1,25 @@
+'''
+Checks that a DRAM cache in front of CXL memory hits, misses and writes
+back lines, with lines and with pages of lines as blocks, and with and
+without the miss predictor. The config fails if any of them is zero.
+'''
+
+from testlib import *
+
+dram_cache_params = [
+    ('alloy', []),
+    ('footprint', ['--block-size', '2kB']),
+    ('serial-misses', ['--miss-predictor-entries', '0']),
+]
+
+for name, args in dram_cache_params:
+    gem5_verify_config(
+        name='test-dram-cache-' + name,
+        fixtures=(),
+        verifiers=(),
+        config=joinpath(config.base_dir, 'configs', 'example',
+                        'dram_cache.py'),
+        config_args=args,
+        valid_isas=('NULL',),
+        valid_hosts=constants.supported_hosts,
+    )
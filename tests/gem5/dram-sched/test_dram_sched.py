@@ -0,0 +1,25 @@
+'''
+Checks that the indexed FR-FCFS scheduler of the memory controller makes
+the same decisions as a scan of the queues. The controller panics on the
+first decision that differs, so the simulation has to run to the end.
+'''
+
+from testlib import *
+
+sched_params = [
+    ('random-reads', ['--mode', 'DRAM', '--rd_perc', '100']),
+    ('random-mixed', ['--mode', 'DRAM', '--rd_perc', '70', '-r', '2']),
+    ('rotate-mixed', ['--mode', 'DRAM_ROTATE', '--rd_perc', '50',
+                      '-r', '2']),
+]
+
+for name, args in sched_params:
+    gem5_verify_config(
+        name='test-sched-index-' + name,
+        fixtures=(),
+        verifiers=(),
+        config=joinpath(config.base_dir, 'configs', 'dram', 'sweep.py'),
+        config_args=['--check-sched-index'] + args,
+        valid_isas=('NULL',),
+        valid_hosts=constants.supported_hosts,
+    )
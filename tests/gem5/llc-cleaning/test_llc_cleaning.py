@@ -0,0 +1,25 @@
+'''
+Checks that the cleaning engines of a last-level cache clean dirty blocks
+while the cache is idle. The config fails if they cleaned none,
+or if the dead block predictor bypassed no fill.
+'''
+
+from testlib import *
+
+cleaning_params = [
+    ('eager-writeback', ['--eager-writeback']),
+    ('dead-block-predictor', ['--dead-block-predictor', '--mode', 'RANDOM',
+                              '--range', '256kB']),
+]
+
+for name, args in cleaning_params:
+    gem5_verify_config(
+        name='test-llc-cleaning-' + name,
+        fixtures=(),
+        verifiers=(),
+        config=joinpath(config.base_dir, 'configs', 'example',
+                        'llc_cleaning.py'),
+        config_args=args,
+        valid_isas=('NULL',),
+        valid_hosts=constants.supported_hosts,
+    )